@@ -7,6 +7,7 @@ OS_SOURCES := \
 	$(OS_SRC_DIR)/FileDescriptor.cxx \
 	$(OS_SRC_DIR)/FileMapping.cpp \
 	$(OS_SRC_DIR)/FileUtil.cpp \
+	$(OS_SRC_DIR)/Memory.cpp \
 	$(OS_SRC_DIR)/RunFile.cpp \
 	$(OS_SRC_DIR)/Path.cpp \
 	$(OS_SRC_DIR)/PathName.cpp \
@@ -8,6 +8,7 @@ ROUTE_SOURCES = \
 	$(ROUTE_SRC_DIR)/RouteLink.cpp \
 	$(ROUTE_SRC_DIR)/RoutePolar.cpp \
 	$(ROUTE_SRC_DIR)/RoutePolars.cpp \
+	$(ROUTE_SRC_DIR)/RoutePolarCache.cpp \
 	$(ROUTE_SRC_DIR)/FlatTriangleFan.cpp \
 	$(ROUTE_SRC_DIR)/FlatTriangleFanTree.cpp \
 	$(ROUTE_SRC_DIR)/ReachFan.cpp
@@ -94,13 +94,17 @@ TEST_NAMES = \
 	TestUnits TestEarth TestSunEphemeris \
 	TestValidity TestUTM TestProfile \
 	TestAllocatedGrid \
-	TestRadixTree TestGeoBounds TestGeoClip \
+	TestRadixTree TestOpenHashMap TestGeoBounds TestGeoClip \
 	TestLogger TestGRecord TestDriver TestClimbAvCalc \
 	TestWaypointReader TestThermalBase \
 	TestFlarmNet \
-	TestColorRamp TestGeoPoint TestDiffFilter \
+	TestColorRamp TestTerrainShading TestMaxElevationIndex \
+	TestTerrainIntersection \
+	TestReachFan TestRoutePolarCache \
+	TestGeoPoint TestDiffFilter \
 	TestFileUtil TestPolars TestCSVLine TestGlidePolar \
 	test_replay_task TestProjection TestFlatPoint TestFlatLine TestFlatGeoPoint \
+	TestPackedPolygon \
 	TestMacCready TestOrderedTask TestAATPoint \
 	TestPlanes \
 	TestTaskPoint \
@@ -108,6 +112,7 @@ TEST_NAMES = \
 	TestTeamCode \
 	TestZeroFinder \
 	TestAirspaceParser \
+	TestAirspaceTree \
 	TestMETARParser \
 	TestIGCParser \
 	TestByteOrder \
@@ -124,6 +129,10 @@ TEST_NAMES = \
 	TestLeastSquares \
 	TestThermalBand
 
+ifeq ($(OPENGL),n)
+# HeightMatrix::Shift() is only used without OpenGL
+TEST_NAMES += TestHeightMatrix
+endif
 
 TESTS = $(call name-to-bin,$(TEST_NAMES))
 
@@ -184,6 +193,7 @@ $(eval $(call link-program,TestMETARParser,TEST_METAR_PARSER))
 
 TEST_AIRSPACE_PARSER_SOURCES = \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Units/Descriptor.cpp \
 	$(SRC)/Units/System.cpp \
 	$(SRC)/Operation/Operation.cpp \
@@ -197,6 +207,17 @@ TEST_AIRSPACE_PARSER_LDADD = $(FAKE_LIBS)
 TEST_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE ZZIP GEO MATH UTIL
 $(eval $(call link-program,TestAirspaceParser,TEST_AIRSPACE_PARSER))
 
+TEST_AIRSPACE_TREE_SOURCES = \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/DeterministicRandom.cpp \
+	$(TEST_SRC_DIR)/SyntheticAirspaces.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAirspaceTree.cpp
+TEST_AIRSPACE_TREE_DEPENDS = AIRSPACE GEO MATH UTIL
+$(eval $(call link-program,TestAirspaceTree,TEST_AIRSPACE_TREE))
+
 TEST_DATE_TIME_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestDateTime.cpp
@@ -293,7 +314,7 @@ TEST_TROUTE_SOURCES = \
 	$(TEST_SRC_DIR)/Printing.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/test_troute.cpp
-TEST_TROUTE_DEPENDS = TERRAIN IO ZZIP OS ROUTE GLIDE GEO MATH UTIL
+TEST_TROUTE_DEPENDS = TERRAIN IO ZZIP OS THREAD ROUTE GLIDE GEO MATH UTIL
 $(eval $(call link-program,test_troute,TEST_TROUTE))
 
 TEST_REACH_SOURCES = \
@@ -302,9 +323,23 @@ TEST_REACH_SOURCES = \
 	$(TEST_SRC_DIR)/Printing.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/test_reach.cpp
-TEST_REACH_DEPENDS = TERRAIN IO ZZIP OS ROUTE GLIDE GEO MATH UTIL
+TEST_REACH_DEPENDS = TERRAIN IO ZZIP OS THREAD ROUTE GLIDE GEO MATH UTIL
 $(eval $(call link-program,test_reach,TEST_REACH))
 
+TEST_REACH_FAN_SOURCES = \
+	$(TEST_SRC_DIR)/SyntheticTerrain.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestReachFan.cpp
+TEST_REACH_FAN_CPPFLAGS = $(JASPER_CPPFLAGS)
+TEST_REACH_FAN_DEPENDS = TERRAIN IO ZZIP OS THREAD ROUTE GLIDE GEO MATH UTIL
+$(eval $(call link-program,TestReachFan,TEST_REACH_FAN))
+
+TEST_ROUTE_POLAR_CACHE_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestRoutePolarCache.cpp
+TEST_ROUTE_POLAR_CACHE_DEPENDS = ROUTE GLIDE GEO MATH UTIL
+$(eval $(call link-program,TestRoutePolarCache,TEST_ROUTE_POLAR_CACHE))
+
 TEST_ROUTE_SOURCES = \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
 	$(SRC)/Engine/Util/Gradient.cpp \
@@ -318,7 +353,7 @@ TEST_ROUTE_SOURCES = \
 	$(TEST_SRC_DIR)/harness_airspace.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/test_route.cpp
-TEST_ROUTE_DEPENDS = TERRAIN IO ZZIP OS ROUTE AIRSPACE GLIDE GEO MATH UTIL
+TEST_ROUTE_DEPENDS = TERRAIN IO ZZIP OS THREAD ROUTE AIRSPACE GLIDE GEO MATH UTIL
 $(eval $(call link-program,test_route,TEST_ROUTE))
 
 TEST_REPLAY_TASK_SOURCES = \
@@ -553,6 +588,13 @@ TEST_FLAT_GEO_POINT_SOURCES = \
 TEST_FLAT_GEO_POINT_DEPENDS = GEO MATH
 $(eval $(call link-program,TestFlatGeoPoint,TEST_FLAT_GEO_POINT))
 
+TEST_PACKED_POLYGON_SOURCES = \
+	$(TEST_SRC_DIR)/DeterministicRandom.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestPackedPolygon.cpp
+TEST_PACKED_POLYGON_DEPENDS = GEO MATH
+$(eval $(call link-program,TestPackedPolygon,TEST_PACKED_POLYGON))
+
 TEST_FLAT_LINE_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestFlatLine.cpp
@@ -580,6 +622,41 @@ TEST_COLOR_RAMP_SOURCES = \
 TEST_COLOR_RAMP_CPPFLAGS = $(SCREEN_CPPFLAGS)
 $(eval $(call link-program,TestColorRamp,TEST_COLOR_RAMP))
 
+TEST_TERRAIN_SHADING_SOURCES = \
+	$(TEST_SRC_DIR)/DeterministicRandom.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTerrainShading.cpp
+TEST_TERRAIN_SHADING_DEPENDS = GEO MATH
+$(eval $(call link-program,TestTerrainShading,TEST_TERRAIN_SHADING))
+
+TEST_MAX_ELEVATION_INDEX_SOURCES = \
+	$(SRC)/Terrain/RasterBuffer.cpp \
+	$(SRC)/Terrain/MaxElevationIndex.cpp \
+	$(TEST_SRC_DIR)/DeterministicRandom.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestMaxElevationIndex.cpp
+TEST_MAX_ELEVATION_INDEX_DEPENDS = GEO MATH
+$(eval $(call link-program,TestMaxElevationIndex,TEST_MAX_ELEVATION_INDEX))
+
+TEST_TERRAIN_INTERSECTION_SOURCES = \
+	$(TEST_SRC_DIR)/SyntheticTerrain.cpp \
+	$(TEST_SRC_DIR)/DeterministicRandom.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTerrainIntersection.cpp
+TEST_TERRAIN_INTERSECTION_CPPFLAGS = $(JASPER_CPPFLAGS)
+TEST_TERRAIN_INTERSECTION_DEPENDS = TERRAIN IO ZZIP OS THREAD GEO MATH UTIL
+$(eval $(call link-program,TestTerrainIntersection,TEST_TERRAIN_INTERSECTION))
+
+TEST_HEIGHT_MATRIX_SOURCES = \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(TEST_SRC_DIR)/SyntheticTerrain.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestHeightMatrix.cpp
+TEST_HEIGHT_MATRIX_CPPFLAGS = $(JASPER_CPPFLAGS) $(SCREEN_CPPFLAGS)
+TEST_HEIGHT_MATRIX_DEPENDS = TERRAIN IO ZZIP OS THREAD GEO MATH UTIL
+$(eval $(call link-program,TestHeightMatrix,TEST_HEIGHT_MATRIX))
+
 TEST_SUN_EPHEMERIS_SOURCES = \
 	$(SRC)/Math/SunEphemeris.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -610,6 +687,11 @@ TEST_RADIX_TREE_SOURCES = \
 TEST_RADIX_TREE_DEPENDS = UTIL
 $(eval $(call link-program,TestRadixTree,TEST_RADIX_TREE))
 
+TEST_OPEN_HASH_MAP_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestOpenHashMap.cpp
+$(eval $(call link-program,TestOpenHashMap,TEST_OPEN_HASH_MAP))
+
 TEST_LOGGER_SOURCES = \
 	$(SRC)/IGC/IGCFix.cpp \
 	$(SRC)/IGC/IGCWriter.cpp \
@@ -731,6 +813,11 @@ DEBUG_PROGRAM_NAMES = \
 	FlightPath \
 	BenchmarkProjection \
 	BenchmarkFAITriangleSector \
+	BenchmarkTerrain \
+	BenchmarkTerrainRoute \
+	BenchmarkRoute \
+	BenchmarkAirspaceWarnings \
+	BenchmarkAirspaces \
 	DumpTextFile DumpTextZip DumpTextInflate WriteTextFile RunTextWriter \
 	DumpHexColor \
 	RunXMLParser \
@@ -904,6 +991,50 @@ BENCHMARK_FAI_TRIANGLE_SECTOR_SOURCES = \
 BENCHMARK_FAI_TRIANGLE_SECTOR_DEPENDS = GEO MATH
 $(eval $(call link-program,BenchmarkFAITriangleSector,BENCHMARK_FAI_TRIANGLE_SECTOR))
 
+BENCHMARK_TERRAIN_SOURCES = \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/DeterministicRandom.cpp \
+	$(TEST_SRC_DIR)/BenchmarkTerrain.cpp
+BENCHMARK_TERRAIN_CPPFLAGS = $(SCREEN_CPPFLAGS)
+BENCHMARK_TERRAIN_DEPENDS = TERRAIN GEO MATH IO OS THREAD ZZIP UTIL
+$(eval $(call link-program,BenchmarkTerrain,BENCHMARK_TERRAIN))
+
+BENCHMARK_TERRAIN_ROUTE_SOURCES = \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/BenchmarkTerrainRoute.cpp
+BENCHMARK_TERRAIN_ROUTE_DEPENDS = TERRAIN IO ZZIP OS THREAD ROUTE GLIDE GEO MATH UTIL
+$(eval $(call link-program,BenchmarkTerrainRoute,BENCHMARK_TERRAIN_ROUTE))
+
+BENCHMARK_ROUTE_SOURCES = \
+	$(TEST_SRC_DIR)/SyntheticTerrain.cpp \
+	$(TEST_SRC_DIR)/DeterministicRandom.cpp \
+	$(TEST_SRC_DIR)/BenchmarkRoute.cpp
+BENCHMARK_ROUTE_CPPFLAGS = $(JASPER_CPPFLAGS)
+BENCHMARK_ROUTE_DEPENDS = TERRAIN IO ZZIP OS THREAD ROUTE GLIDE GEO MATH UTIL
+$(eval $(call link-program,BenchmarkRoute,BENCHMARK_ROUTE))
+
+BENCHMARK_AIRSPACE_WARNINGS_SOURCES = \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/DeterministicRandom.cpp \
+	$(TEST_SRC_DIR)/SyntheticAirspaces.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAirspaceWarnings.cpp
+BENCHMARK_AIRSPACE_WARNINGS_DEPENDS = AIRSPACE GLIDE GEO MATH UTIL
+$(eval $(call link-program,BenchmarkAirspaceWarnings,BENCHMARK_AIRSPACE_WARNINGS))
+
+BENCHMARK_AIRSPACES_SOURCES = \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/DeterministicRandom.cpp \
+	$(TEST_SRC_DIR)/SyntheticAirspaces.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAirspaces.cpp
+BENCHMARK_AIRSPACES_DEPENDS = AIRSPACE GEO MATH UTIL
+$(eval $(call link-program,BenchmarkAirspaces,BENCHMARK_AIRSPACES))
+
 DUMP_TEXT_FILE_SOURCES = \
 	$(TEST_SRC_DIR)/DumpTextFile.cpp
 DUMP_TEXT_FILE_DEPENDS = IO OS ZZIP UTIL
@@ -1133,7 +1264,7 @@ LOAD_TERRAIN_SOURCES = \
 	$(SRC)/Operation/Operation.cpp \
 	$(TEST_SRC_DIR)/LoadTerrain.cpp
 LOAD_TERRAIN_CPPFLAGS = $(SCREEN_CPPFLAGS)
-LOAD_TERRAIN_DEPENDS = TERRAIN GEO MATH IO OS ZZIP UTIL
+LOAD_TERRAIN_DEPENDS = TERRAIN GEO MATH IO OS THREAD ZZIP UTIL
 $(eval $(call link-program,LoadTerrain,LOAD_TERRAIN))
 
 RUN_HEIGHT_MATRIX_SOURCES = \
@@ -1142,7 +1273,7 @@ RUN_HEIGHT_MATRIX_SOURCES = \
 	$(SRC)/Operation/Operation.cpp \
 	$(TEST_SRC_DIR)/RunHeightMatrix.cpp
 RUN_HEIGHT_MATRIX_CPPFLAGS = $(SCREEN_CPPFLAGS)
-RUN_HEIGHT_MATRIX_DEPENDS = TERRAIN GEO MATH IO OS ZZIP UTIL
+RUN_HEIGHT_MATRIX_DEPENDS = TERRAIN GEO MATH IO OS THREAD ZZIP UTIL
 $(eval $(call link-program,RunHeightMatrix,RUN_HEIGHT_MATRIX))
 
 RUN_INPUT_PARSER_SOURCES = \
@@ -2311,6 +2442,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Computer/GlideComputerBlackboard.cpp \
 	$(SRC)/Computer/TaskComputer.cpp \
 	$(SRC)/Computer/RouteComputer.cpp \
+	$(SRC)/Computer/ReachabilityComputer.cpp \
 	$(SRC)/Computer/GlideComputerAirData.cpp \
 	$(SRC)/Computer/WaveComputer.cpp \
 	$(SRC)/Computer/StatsComputer.cpp \
@@ -2337,6 +2469,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Airspace/ActivePredicate.cpp \
 	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Airspace/AirspaceGlue.cpp \
 	$(SRC)/Airspace/AirspaceVisibility.cpp \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
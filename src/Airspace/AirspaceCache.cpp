@@ -0,0 +1,312 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AirspaceCache.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
+#include "Util/AllocatedArray.hxx"
+#include "Util/StringAPI.hxx"
+
+#include <iterator>
+#include <vector>
+
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#include <tchar.h>
+
+namespace {
+
+struct Header {
+  static constexpr uint32_t VERSION = 1;
+
+  uint32_t version;
+
+  /**
+   * The size of a TCHAR, because names are stored in the native
+   * character set.
+   */
+  uint32_t char_size;
+
+  uint32_t n_airspaces;
+
+  uint32_t reserved;
+
+  /**
+   * The number of bytes following this header.
+   */
+  uint64_t data_size;
+};
+
+/**
+ * The fixed-size part of each airspace.  It is followed by the name
+ * and the radio text (without null terminator), and then either the
+ * circle's center and radius or the polygon's points.
+ */
+struct Record {
+  uint8_t shape;
+  uint8_t type;
+  AirspaceActivity days;
+  uint8_t reserved;
+
+  uint32_t name_length, radio_length;
+
+  /**
+   * The number of polygon points; 0 for circles.
+   */
+  uint32_t n_points;
+
+  AirspaceAltitude base, top;
+};
+
+/**
+ * Reads values from a memory buffer.  The buffer does not guarantee
+ * any alignment, so everything is copied with memcpy().
+ */
+class BufferReader {
+  const uint8_t *p;
+  const uint8_t *const end;
+
+public:
+  BufferReader(const void *data, size_t size)
+    :p((const uint8_t *)data), end(p + size) {}
+
+  bool IsEnd() const {
+    return p == end;
+  }
+
+  bool Read(void *dest, size_t size) {
+    if (size_t(end - p) < size)
+      return false;
+
+    memcpy(dest, p, size);
+    p += size;
+    return true;
+  }
+
+  template<typename T>
+  bool Read(T &value) {
+    return Read(&value, sizeof(value));
+  }
+
+  bool ReadString(tstring &value, size_t length) {
+    if (size_t(end - p) < length * sizeof(TCHAR))
+      return false;
+
+    value.resize(length);
+    return Read(&value[0], length * sizeof(TCHAR));
+  }
+};
+
+}
+
+template<typename T>
+static void
+Append(std::vector<uint8_t> &buffer, const T &value)
+{
+  const uint8_t *p = (const uint8_t *)&value;
+  buffer.insert(buffer.end(), p, p + sizeof(value));
+}
+
+static void
+AppendString(std::vector<uint8_t> &buffer, const TCHAR *value, size_t length)
+{
+  const uint8_t *p = (const uint8_t *)value;
+  buffer.insert(buffer.end(), p, p + length * sizeof(TCHAR));
+}
+
+static void
+AppendAirspace(std::vector<uint8_t> &buffer, const AbstractAirspace &airspace)
+{
+  const bool is_circle =
+    airspace.GetShape() == AbstractAirspace::Shape::CIRCLE;
+  const SearchPointVector &points = airspace.GetPoints();
+  const TCHAR *name = airspace.GetName();
+  const tstring &radio = airspace.GetRadioText();
+
+  /* value-initialisation clears the padding bytes, to get
+     reproducible files */
+  Record record{};
+  record.shape = uint8_t(airspace.GetShape());
+  record.type = airspace.GetType();
+  record.days = airspace.GetDays();
+  record.name_length = StringLength(name);
+  record.radio_length = radio.length();
+  record.n_points = is_circle ? 0 : points.size();
+  record.base = airspace.GetBase();
+  record.top = airspace.GetTop();
+  Append(buffer, record);
+
+  AppendString(buffer, name, record.name_length);
+  AppendString(buffer, radio.data(), record.radio_length);
+
+  if (is_circle) {
+    const AirspaceCircle &circle = (const AirspaceCircle &)airspace;
+    Append(buffer, circle.GetReferenceLocation());
+    Append(buffer, circle.GetRadius());
+  } else {
+    for (const auto &i : points)
+      Append(buffer, i.GetLocation());
+  }
+}
+
+bool
+SaveAirspaceCache(FILE *file, const Airspaces &airspaces, unsigned first)
+{
+  const auto &pending = airspaces.GetPending();
+  assert(first <= pending.size());
+
+  std::vector<uint8_t> buffer;
+  for (auto i = std::next(pending.begin(), first), end = pending.end();
+       i != end; ++i)
+    AppendAirspace(buffer, **i);
+
+  Header header;
+  memset(&header, 0, sizeof(header));
+  header.version = Header::VERSION;
+  header.char_size = sizeof(TCHAR);
+  header.n_airspaces = pending.size() - first;
+  header.data_size = buffer.size();
+
+  return fwrite(&header, sizeof(header), 1, file) == 1 &&
+    (buffer.empty() ||
+     fwrite(buffer.data(), buffer.size(), 1, file) == 1);
+}
+
+/**
+ * Create a new airspace from the record at the current position.
+ *
+ * @param points a buffer which is reused for all polygons
+ * @return the new airspace or nullptr if the data is malformed
+ */
+static AbstractAirspace *
+ReadAirspace(BufferReader &reader, std::vector<GeoPoint> &points)
+{
+  Record record;
+  if (!reader.Read(record) || record.type >= AIRSPACECLASSCOUNT)
+    return nullptr;
+
+  tstring name, radio;
+  if (!reader.ReadString(name, record.name_length) ||
+      !reader.ReadString(radio, record.radio_length))
+    return nullptr;
+
+  AbstractAirspace *airspace;
+  switch (AbstractAirspace::Shape(record.shape)) {
+  case AbstractAirspace::Shape::CIRCLE: {
+    GeoPoint center;
+    double radius;
+    if (!reader.Read(center) || !reader.Read(radius))
+      return nullptr;
+
+    airspace = new AirspaceCircle(center, radius);
+    break;
+  }
+
+  case AbstractAirspace::Shape::POLYGON:
+    if (record.n_points < 3)
+      return nullptr;
+
+    points.resize(record.n_points);
+    if (!reader.Read(points.data(), record.n_points * sizeof(GeoPoint)))
+      return nullptr;
+
+    airspace = new AirspacePolygon(points);
+    break;
+
+  default:
+    return nullptr;
+  }
+
+  airspace->SetProperties(std::move(name), AirspaceClass(record.type),
+                          record.base, record.top);
+  airspace->SetRadio(radio);
+  airspace->SetDays(record.days);
+  return airspace;
+}
+
+/**
+ * Parse the data following the #Header, and add the airspaces only
+ * if all of them are valid.
+ */
+static bool
+LoadAirspaces(const void *data, size_t size, unsigned n,
+              Airspaces &airspaces)
+{
+  BufferReader reader(data, size);
+
+  std::vector<AbstractAirspace *> loaded;
+  loaded.reserve(n);
+
+  std::vector<GeoPoint> points;
+  for (unsigned i = 0; i < n; ++i) {
+    AbstractAirspace *airspace = ReadAirspace(reader, points);
+    if (airspace == nullptr)
+      break;
+
+    loaded.push_back(airspace);
+  }
+
+  if (loaded.size() != n || !reader.IsEnd()) {
+    for (AbstractAirspace *i : loaded)
+      delete i;
+    return false;
+  }
+
+  for (AbstractAirspace *i : loaded)
+    airspaces.Add(i);
+
+  return true;
+}
+
+bool
+LoadAirspaceCache(FILE *file, Airspaces &airspaces)
+{
+  Header header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      header.version != Header::VERSION ||
+      header.char_size != sizeof(TCHAR))
+    return false;
+
+  /* check the size before allocating the buffer, so a damaged
+     header cannot cause a huge allocation */
+  const long start = ftell(file);
+  if (start < 0 || fseek(file, 0, SEEK_END) != 0)
+    return false;
+
+  const long end = ftell(file);
+  if (end < start || uint64_t(end - start) != header.data_size ||
+      fseek(file, start, SEEK_SET) != 0)
+    return false;
+
+  if (header.data_size == 0)
+    return header.n_airspaces == 0;
+
+  /* the file is read at once; the airspace objects are built from
+     the buffer, so a mapping would not save any copy */
+  AllocatedArray<uint8_t> buffer(header.data_size);
+  return fread(buffer.begin(), header.data_size, 1, file) == 1 &&
+    LoadAirspaces(buffer.begin(), header.data_size, header.n_airspaces,
+                  airspaces);
+}
@@ -0,0 +1,59 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_AIRSPACE_CACHE_HPP
+#define XCSOAR_AIRSPACE_CACHE_HPP
+
+#include <stdio.h>
+
+class Airspaces;
+
+/**
+ * A binary snapshot of the airspaces parsed from one file, stored in
+ * the #FileCache.  It contains the final (arc-expanded) polygons and
+ * circles, so loading it does not need the #AirspaceParser.  The
+ * flight levels and ground levels are applied after loading, just
+ * like after parsing.
+ */
+
+/**
+ * Write the airspaces which were added to the #Airspaces object
+ * since the last Optimise() call, starting with the one at index
+ * #first.
+ *
+ * @param file a file returned by FileCache::Save()
+ */
+bool
+SaveAirspaceCache(FILE *file, const Airspaces &airspaces, unsigned first);
+
+/**
+ * Read a file written by SaveAirspaceCache() and add all of its
+ * airspaces to the #Airspaces object.  Nothing is added if
+ * the file is not valid.
+ *
+ * @param file a file returned by FileCache::Load()
+ */
+bool
+LoadAirspaceCache(FILE *file, Airspaces &airspaces);
+
+#endif
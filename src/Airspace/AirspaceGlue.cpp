@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "Airspace/AirspaceGlue.hpp"
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
 #include "Profile/ProfileKeys.hpp"
 #include "Operation/Operation.hpp"
@@ -33,6 +34,7 @@ Copyright_License {
 #include "IO/ZipArchive.hpp"
 #include "IO/ZipLineReader.hpp"
 #include "IO/MapFile.hpp"
+#include "IO/FileCache.hpp"
 #include "Profile/Profile.hpp"
 
 #include <string.h>
@@ -74,10 +76,54 @@ try {
   return false;
 }
 
+/**
+ * Load the airspaces of one file from the #FileCache if possible, or
+ * parse the file with the given function and store the result in the
+ * cache.
+ *
+ * @param original_path the file which the cache entry depends on
+ */
+template<typename P>
+static bool
+LoadAirspaceFile(Airspaces &airspaces, FileCache *cache,
+                 const TCHAR *cache_name, Path original_path,
+                 P &&parse)
+{
+  if (cache != nullptr) {
+    FILE *file = cache->Load(cache_name, original_path);
+    if (file != nullptr) {
+      bool success = LoadAirspaceCache(file, airspaces);
+      fclose(file);
+      if (success)
+        return true;
+
+      LogFormat(_T("Discarding obsolete airspace cache %s"), cache_name);
+      cache->Flush(cache_name);
+    }
+  }
+
+  const unsigned first = airspaces.GetPending().size();
+  if (!parse())
+    return false;
+
+  if (cache != nullptr) {
+    FILE *file = cache->Save(cache_name, original_path);
+    if (file != nullptr) {
+      if (SaveAirspaceCache(file, airspaces, first))
+        cache->Commit(cache_name, file);
+      else
+        cache->Cancel(cache_name, file);
+    }
+  }
+
+  return true;
+}
+
 void
 ReadAirspace(Airspaces &airspaces,
              RasterTerrain *terrain,
              const AtmosphericPressure &press,
+             FileCache *cache,
              OperationEnvironment &operation)
 {
   LogFormat("ReadAirspace");
@@ -90,16 +136,28 @@ ReadAirspace(Airspaces &airspaces,
   // Read the airspace filenames from the registry
   auto path = Profile::GetPath(ProfileKeys::AirspaceFile);
   if (!path.IsNull())
-    airspace_ok |= ParseAirspaceFile(parser, path, operation);
+    airspace_ok |= LoadAirspaceFile(airspaces, cache, _T("airspace"), path,
+                                    [&](){
+      return ParseAirspaceFile(parser, path, operation);
+    });
 
   path = Profile::GetPath(ProfileKeys::AdditionalAirspaceFile);
   if (!path.IsNull())
-    airspace_ok |= ParseAirspaceFile(parser, path, operation);
-
-  auto archive = OpenMapFile();
-  if (archive)
-    airspace_ok |= ParseAirspaceFile(parser, archive->get(), "airspace.txt",
-                                     operation);
+    airspace_ok |= LoadAirspaceFile(airspaces, cache,
+                                    _T("airspace_additional"), path,
+                                    [&](){
+      return ParseAirspaceFile(parser, path, operation);
+    });
+
+  const auto map_path = Profile::GetPath(ProfileKeys::MapFile);
+  if (!map_path.IsNull())
+    airspace_ok |= LoadAirspaceFile(airspaces, cache, _T("airspace_map"),
+                                    map_path, [&](){
+      auto archive = OpenMapFile();
+      return archive &&
+        ParseAirspaceFile(parser, archive->get(), "airspace.txt",
+                          operation);
+    });
 
   if (airspace_ok) {
     airspaces.Optimise();
@@ -38,6 +38,7 @@ GlideComputer::GlideComputer(const ComputerSettings &_settings,
   :air_data_computer(_way_points),
    warning_computer(_settings.airspace.warnings, _airspace_database),
    task_computer(task, _airspace_database, &warning_computer.GetManager()),
+   reachability_computer(_way_points),
    waypoints(_way_points),
    retrospective(_way_points),
    team_code_ref_id(-1)
@@ -111,6 +112,9 @@ GlideComputer::ProcessGPS(bool force)
 
   task_computer.ProcessMoreTask(basic, calculated, settings);
 
+  reachability_computer.Compute(basic, calculated, settings,
+                                task_computer.GetRoutePlanner());
+
   if (!last_finished && calculated.ordered_task_stats.task_finished)
     OnFinishTask();
 
@@ -0,0 +1,167 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "ReachabilityComputer.hpp"
+#include "Settings.hpp"
+#include "NMEA/MoreData.hpp"
+#include "NMEA/Derived.hpp"
+#include "Task/RoutePlannerGlue.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Waypoint/WaypointVisitor.hpp"
+#include "Engine/GlideSolvers/MacCready.hpp"
+#include "Geo/GeoVector.hpp"
+
+#include <algorithm>
+
+/**
+ * The maximum search radius [m], to keep the table meaningful at
+ * extreme altitudes.
+ */
+static constexpr double MAX_RANGE = 200000;
+
+void
+ReachabilityComputer::CollectCandidates(const GeoPoint &location,
+                                        double range, unsigned max_size)
+{
+  candidates.clear();
+
+  struct Visitor final : public WaypointVisitor {
+    std::vector<Candidate> &candidates;
+    const GeoPoint &location;
+    double range;
+
+    Visitor(std::vector<Candidate> &_candidates,
+            const GeoPoint &_location, double _range)
+      :candidates(_candidates), location(_location), range(_range) {}
+
+    void Visit(const WaypointPtr &wp) override {
+      if (!wp->IsLandable())
+        return;
+
+      /* VisitWithinRange() searches a square box */
+      const double distance = location.Distance(wp->location);
+      if (distance > range)
+        return;
+
+      candidates.push_back({wp->id, wp->location, wp->elevation, distance});
+    }
+  } visitor(candidates, location, range);
+
+  waypoints.VisitWithinRange(location, range, visitor);
+
+  if (candidates.size() > max_size) {
+    /* keep only the closest ones */
+    std::nth_element(candidates.begin(), candidates.begin() + max_size,
+                     candidates.end(),
+                     [](const Candidate &a, const Candidate &b) {
+                       return a.distance < b.distance;
+                     });
+    candidates.resize(max_size);
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate &a, const Candidate &b) {
+              return a.id < b.id;
+            });
+}
+
+void
+ReachabilityComputer::Compute(const MoreData &basic, DerivedInfo &calculated,
+                              const ComputerSettings &settings,
+                              const RoutePlannerGlue &route_planner)
+{
+  ReachabilityTable &table = calculated.reachability;
+
+  const TaskBehaviour &task_behaviour = settings.task;
+  const GlidePolar &glide_polar =
+    task_behaviour.route_planner.reach_polar_mode == RoutePlannerConfig::Polar::TASK
+    ? settings.polar.glide_polar_task
+    : calculated.glide_polar_safety;
+
+  if (!basic.location_available || !basic.NavAltitudeAvailable() ||
+      !glide_polar.IsValid()) {
+    table.Invalidate();
+    return;
+  }
+
+  const double safety_height = task_behaviour.safety_height_arrival;
+  const SpeedVector wind = calculated.GetWindOrZero();
+
+  /* an upper bound of the final glide range: no landable is lower
+     than sea level, and a tail wind stretches the glide at most by
+     this factor */
+  const double range =
+    std::min(std::max(basic.nav_altitude - safety_height, 0.) *
+             glide_polar.GetBestLD() *
+             (1 + wind.norm / glide_polar.GetVBestLD()),
+             MAX_RANGE);
+
+  CollectCandidates(basic.location, range, ReachabilityTable::MAX_SIZE);
+
+  const unsigned n = candidates.size();
+  table.entries.clear();
+  table.terrain = !route_planner.IsTerrainReachEmpty();
+
+  if (table.terrain) {
+    AGeoPoint destinations[ReachabilityTable::MAX_SIZE];
+    for (unsigned i = 0; i < n; ++i)
+      destinations[i] = AGeoPoint(candidates[i].location,
+                                  candidates[i].elevation + safety_height);
+
+    ReachResult results[ReachabilityTable::MAX_SIZE];
+    if (route_planner.FindPositiveArrivals(destinations, results, n)) {
+      for (unsigned i = 0; i < n; ++i) {
+        ReachResult &reach = results[i];
+        reach.Subtract(destinations[i].altitude);
+        table.entries.append({candidates[i].id, reach});
+      }
+    }
+  } else {
+    GeoVector vectors[ReachabilityTable::MAX_SIZE];
+    double min_arrival_altitudes[ReachabilityTable::MAX_SIZE];
+    for (unsigned i = 0; i < n; ++i) {
+      vectors[i] = GeoVector(basic.location, candidates[i].location);
+      min_arrival_altitudes[i] = candidates[i].elevation + safety_height;
+    }
+
+    double altitude_differences[ReachabilityTable::MAX_SIZE];
+    bool valid[ReachabilityTable::MAX_SIZE];
+    const MacCready mac_cready(task_behaviour.glide, glide_polar);
+    mac_cready.SolveStraight(vectors, min_arrival_altitudes, n,
+                             basic.nav_altitude, wind,
+                             altitude_differences, valid);
+
+    for (unsigned i = 0; i < n; ++i) {
+      if (!valid[i])
+        continue;
+
+      ReachResult reach;
+      reach.direct = reach.terrain = (int)altitude_differences[i];
+      reach.terrain_valid = ReachResult::Validity::INVALID;
+      table.entries.append({candidates[i].id, reach});
+    }
+  }
+
+  table.available.Update(basic.clock);
+  ++table.serial;
+}
@@ -0,0 +1,79 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_REACHABILITY_COMPUTER_HPP
+#define XCSOAR_REACHABILITY_COMPUTER_HPP
+
+#include "Geo/GeoPoint.hpp"
+
+#include <vector>
+
+struct MoreData;
+struct DerivedInfo;
+struct ComputerSettings;
+class Waypoints;
+class RoutePlannerGlue;
+
+/**
+ * Calculates the arrival heights at the landables within final glide
+ * range and publishes them in DerivedInfo::reachability.
+ *
+ * The table is read by the #WaypointRenderer and by the waypoint list
+ * and details dialogs.  #AbortTask still solves its alternates
+ * itself, because it applies the task polar and its own safety rules.
+ */
+class ReachabilityComputer {
+  const Waypoints &waypoints;
+
+  struct Candidate {
+    unsigned id;
+    GeoPoint location;
+    double elevation;
+    double distance;
+  };
+
+  /**
+   * The landables within range; a member to keep its memory between
+   * two calls.
+   */
+  std::vector<Candidate> candidates;
+
+public:
+  explicit ReachabilityComputer(const Waypoints &_waypoints)
+    :waypoints(_waypoints) {}
+
+  /**
+   * @param route_planner the route planner of the calculation thread;
+   * if its terrain reach is available, the table considers terrain
+   * obstacles
+   */
+  void Compute(const MoreData &basic, DerivedInfo &calculated,
+               const ComputerSettings &settings,
+               const RoutePlannerGlue &route_planner);
+
+private:
+  void CollectCandidates(const GeoPoint &location, double range,
+                         unsigned max_size);
+};
+
+#endif
@@ -64,6 +64,13 @@ public:
     return route.GetProtectedRoutePlanner();
   }
 
+  /**
+   * @see RouteComputer::GetRoutePlanner()
+   */
+  const RoutePlannerGlue &GetRoutePlanner() const {
+    return route.GetRoutePlanner();
+  }
+
   void ClearAirspaces() {
     route.ClearAirspaces();
   }
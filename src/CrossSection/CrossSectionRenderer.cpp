@@ -113,15 +113,8 @@ CrossSectionRenderer::UpdateTerrain(TerrainHeight *elevations) const
     return;
   }
 
-  const GeoPoint point_diff = vec.EndPoint(start) - start;
-
   RasterTerrain::Lease map(*terrain);
-  for (unsigned i = 0; i < NUM_SLICES; ++i) {
-    const auto slice_distance_factor = double(i) / (NUM_SLICES - 1);
-    const GeoPoint slice_point = start + point_diff * slice_distance_factor;
-
-    elevations[i] = map->GetHeight(slice_point);
-  }
+  map->GetLineHeights(start, vec.EndPoint(start), elevations, NUM_SLICES);
 }
 
 void
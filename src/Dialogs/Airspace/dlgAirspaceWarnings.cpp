@@ -295,13 +295,14 @@ AirspaceWarningListWidget::Enable()
 
   {
     ProtectedAirspaceWarningManager::ExclusiveLease lease(airspace_warnings);
-    AirspaceWarning *warning = lease->GetWarningPtr(*airspace);
-    if (warning == NULL)
+    if (lease->GetWarningPtr(*airspace) == NULL)
       return;
 
-    warning->AcknowledgeInside(false);
-    warning->AcknowledgeWarning(false);
-    warning->AcknowledgeDay(false);
+    /* go through the manager, which updates its serial when the day
+       acknowledgement changes */
+    lease->AcknowledgeInside(*airspace, false);
+    lease->AcknowledgeWarning(*airspace, false);
+    lease->AcknowledgeDay(*airspace, false);
   }
 
   UpdateList();
@@ -28,6 +28,9 @@ Copyright_License {
 #include "Language/Language.hpp"
 #include "Hardware/Battery.hpp"
 #include "Net/State.hpp"
+#include "Terrain/RasterTerrain.hpp"
+#include "Formatter/ByteSizeFormatter.hpp"
+#include "Util/Macros.hpp"
 
 enum Controls {
   GPS,
@@ -37,6 +40,7 @@ enum Controls {
   Logger,
   Battery,
   Network,
+  TerrainCache,
 };
 
 gcc_pure
@@ -122,6 +126,25 @@ SystemStatusPanel::Refresh()
   SetText(Battery, Temp);
 
   SetText(Network, ToString(GetNetState()));
+
+  if (terrain != nullptr) {
+    const auto stats = terrain->GetTileCacheStatistics();
+
+    TCHAR resident[32], budget[32];
+    FormatByteSize(resident, ARRAY_SIZE(resident),
+                   stats.resident_bytes + stats.pyramid_bytes);
+    FormatByteSize(budget, ARRAY_SIZE(budget), stats.budget);
+    Temp.Format(_T("%u %s, %s / %s"), stats.resident_tiles, _("tiles"),
+                resident, budget);
+
+    const unsigned total = stats.hits + stats.misses;
+    if (total > 0)
+      Temp.AppendFormat(_T(", %.0f%% %s"), stats.hits * 100. / total,
+                        _("hits"));
+
+    SetText(TerrainCache, Temp);
+  } else
+    ClearText(TerrainCache);
 }
 
 void
@@ -134,6 +157,7 @@ SystemStatusPanel::Prepare(ContainerWindow &parent, const PixelRect &rc)
   AddReadOnly(_("Logger"));
   AddReadOnly(_("Supply voltage"));
   AddReadOnly(_("Network"));
+  AddReadOnly(_("Terrain cache"));
 }
 
 void
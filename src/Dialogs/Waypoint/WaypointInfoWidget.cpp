@@ -27,6 +27,7 @@ Copyright_License {
 #include "Engine/GlideSolvers/MacCready.hpp"
 #include "Engine/GlideSolvers/GlideResult.hpp"
 #include "Engine/Util/Gradient.hpp"
+#include "Engine/Route/ReachResult.hpp"
 #include "NMEA/MoreData.hpp"
 #include "NMEA/Derived.hpp"
 #include "Computer/Settings.hpp"
@@ -72,6 +73,15 @@ WaypointInfoWidget::AddGlideResult(const TCHAR *label,
                                 result, settings.task.glide));
 }
 
+void
+WaypointInfoWidget::AddReachResult(const TCHAR *label,
+                                   const ReachResult &reach)
+{
+  TCHAR buffer[64];
+  FormatRelativeUserAltitude(reach.direct, buffer, ARRAY_SIZE(buffer));
+  AddReadOnly(label, nullptr, buffer);
+}
+
 gcc_const
 static BrokenTime
 BreakHourOfDay(double t)
@@ -175,15 +185,28 @@ WaypointInfoWidget::Prepare(ContainerWindow &parent, const PixelRect &rc)
                    MacCready::Solve(settings.task.glide,
                                     gp0, glide_state));
 
-    AddGlideResult(_("Alt. diff. MC safety"),
-                   MacCready::Solve(settings.task.glide,
-                                    calculated.glide_polar_safety,
-                                    glide_state));
-
-    AddGlideResult(_("Alt. diff. MC current"),
-                   MacCready::Solve(settings.task.glide,
-                                    settings.polar.glide_polar_task,
-                                    glide_state));
+    /* a landable within final glide range has already been solved
+       with the reach polar by the ReachabilityComputer */
+    const ReachabilityTable::Entry *entry =
+      calculated.reachability.Find(waypoint->id);
+    const bool reach_task = entry != nullptr &&
+      settings.task.route_planner.reach_polar_mode == RoutePlannerConfig::Polar::TASK;
+
+    if (entry != nullptr && !reach_task)
+      AddReachResult(_("Alt. diff. MC safety"), entry->reach);
+    else
+      AddGlideResult(_("Alt. diff. MC safety"),
+                     MacCready::Solve(settings.task.glide,
+                                      calculated.glide_polar_safety,
+                                      glide_state));
+
+    if (reach_task)
+      AddReachResult(_("Alt. diff. MC current"), entry->reach);
+    else
+      AddGlideResult(_("Alt. diff. MC current"),
+                     MacCready::Solve(settings.task.glide,
+                                      settings.polar.glide_polar_task,
+                                      glide_state));
   }
 
   if (basic.location_available && basic.NavAltitudeAvailable()) {
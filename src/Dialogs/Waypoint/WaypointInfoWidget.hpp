@@ -29,6 +29,7 @@ Copyright_License {
 
 struct Waypoint;
 struct GlideResult;
+struct ReachResult;
 
 struct WaypointInfoWidget : public RowFormWidget {
   const WaypointPtr waypoint;
@@ -39,6 +40,12 @@ public:
 
   void AddGlideResult(const TCHAR *label, const GlideResult &result);
 
+  /**
+   * Add the straight glide arrival height of an entry of
+   * DerivedInfo::reachability.
+   */
+  void AddReachResult(const TCHAR *label, const ReachResult &reach);
+
   /* methods from Widget */
   void Prepare(ContainerWindow &parent, const PixelRect &rc) override;
 };
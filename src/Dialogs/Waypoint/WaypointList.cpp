@@ -52,6 +52,7 @@ Copyright_License {
 #include "Formatter/AngleFormatter.hpp"
 #include "Formatter/UserUnits.hpp"
 #include "Interface.hpp"
+#include "NMEA/Derived.hpp"
 #include "Blackboard/BlackboardListener.hpp"
 #include "Language/Language.hpp"
 
@@ -136,6 +137,12 @@ class WaypointListWidget final
   const GeoPoint location;
   Angle last_heading;
 
+  /**
+   * The DerivedInfo::reachability serial the list was last drawn
+   * with.
+   */
+  unsigned reachability_serial = 0;
+
   OrderedTask *const ordered_task;
   const unsigned ordered_task_index;
 
@@ -200,6 +207,8 @@ public:
 private:
   /* virtual methods from BlackboardListener */
   void OnGPSUpdate(const MoreData &basic) override;
+  void OnCalculatedUpdate(const MoreData &basic,
+                          const DerivedInfo &calculated) override;
 };
 
 class WaypointFilterWidget : public RowFormWidget {
@@ -462,11 +471,22 @@ WaypointListWidget::OnPaintItem(Canvas &canvas, const PixelRect rc,
 
   const struct WaypointListItem &info = items[i];
 
-  WaypointListRenderer::Draw(canvas, rc, *info.waypoint,
-                             info.GetVector(location),
-                             row_renderer,
-                             UIGlobals::GetMapLook().waypoint,
-                             CommonInterface::GetMapSettings().waypoint);
+  /* landables within final glide range: show the arrival height
+     calculated by the ReachabilityComputer */
+  const ReachabilityTable::Entry *entry =
+    CommonInterface::Calculated().reachability.Find(info.waypoint->id);
+  if (entry != nullptr)
+    WaypointListRenderer::Draw(canvas, rc, *info.waypoint,
+                               info.GetVector(location), entry->reach,
+                               row_renderer,
+                               UIGlobals::GetMapLook().waypoint,
+                               CommonInterface::GetMapSettings().waypoint);
+  else
+    WaypointListRenderer::Draw(canvas, rc, *info.waypoint,
+                               info.GetVector(location),
+                               row_renderer,
+                               UIGlobals::GetMapLook().waypoint,
+                               CommonInterface::GetMapSettings().waypoint);
 }
 
 void
@@ -509,6 +529,16 @@ WaypointListWidget::OnGPSUpdate(const MoreData &basic)
   }
 }
 
+void
+WaypointListWidget::OnCalculatedUpdate(const MoreData &basic,
+                                       const DerivedInfo &calculated)
+{
+  if (calculated.reachability.serial != reachability_serial) {
+    reachability_serial = calculated.reachability.serial;
+    GetList().Invalidate();
+  }
+}
+
 WaypointPtr
 ShowWaypointListDialog(const GeoPoint &_location,
                        OrderedTask *_ordered_task, unsigned _ordered_task_index)
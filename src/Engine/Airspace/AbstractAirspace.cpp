@@ -213,22 +213,19 @@ AbstractAirspace::GetGeoBounds() const
   return m_border.CalculateGeoBounds();
 }
 
-const SearchPointVector&
-AbstractAirspace::GetClearance(const FlatProjection &projection) const
+SearchPointVector
+AbstractAirspace::CalculateClearance(const FlatProjection &projection) const
 {
   #define RADIUS 5
 
-  if (!m_clearance.empty())
-    return m_clearance;
+  SearchPointVector clearance = m_border;
+  if (is_convex != TriState::TRUE)
+    clearance.PruneInterior();
 
-  m_clearance = m_border;
-  if (is_convex != TriState::FALSE)
-    is_convex = m_clearance.PruneInterior() ? TriState::FALSE : TriState::TRUE;
-
-  FlatBoundingBox bb = m_clearance.CalculateBoundingbox();
+  FlatBoundingBox bb = clearance.CalculateBoundingbox();
   FlatGeoPoint center = bb.GetCenter();
 
-  for (SearchPoint &i : m_clearance) {
+  for (SearchPoint &i : clearance) {
     FlatGeoPoint p = i.GetFlatLocation();
     FlatRay r(center, p);
     int mag = r.Magnitude();
@@ -237,13 +234,7 @@ AbstractAirspace::GetClearance(const FlatProjection &projection) const
     i = SearchPoint(projection.Unproject(p), p);
   }
 
-  return m_clearance;
-}
-
-void
-AbstractAirspace::ClearClearance() const
-{
-  m_clearance.clear();
+  return clearance;
 }
 
 void
@@ -61,7 +61,7 @@ private:
   AirspaceClass type;
 
 protected:
-  mutable TriState is_convex;
+  TriState is_convex;
   mutable bool active;
 
   /** Base of airspace */
@@ -79,9 +79,6 @@ protected:
   /** Actual border */
   SearchPointVector m_border;
 
-  /** Convex clearance border */
-  mutable SearchPointVector m_clearance;
-
   AirspaceActivity days_of_operation;
 
 public:
@@ -239,6 +236,10 @@ public:
     days_of_operation = mask;
   }
 
+  const AirspaceActivity &GetDays() const {
+    return days_of_operation;
+  }
+
   /**
    * Get type of airspace
    *
@@ -356,14 +357,11 @@ public:
   }
 
   /**
-   * On-demand access of clearance border.  Generated on call,
-   * to deallocate, call clear_clearance().  Uses mutable object
-   * and const methods to allow visitors to generate them on demand
-   * from within a visit method.
+   * Calculate the clearance border: the convex hull of the border,
+   * expanded by a small margin.  This is expensive; the caller
+   * (#AirspaceRoute) is responsible for caching the result.
    */
-  gcc_pure
-  const SearchPointVector &GetClearance(const FlatProjection &projection) const;
-  void ClearClearance() const;
+  SearchPointVector CalculateClearance(const FlatProjection &projection) const;
 
   gcc_pure
   bool IsActive() const {
@@ -372,7 +370,7 @@ public:
 
 protected:
   /** Project border */
-  void Project(const FlatProjection &tp);
+  virtual void Project(const FlatProjection &tp);
 
 private:
   /**
@@ -87,10 +87,3 @@ Airspace::SetActivity(const AirspaceActivity mask) const
   assert(airspace != nullptr);
   airspace->SetActivity(mask);
 }
-
-void
-Airspace::ClearClearance() const
-{
-  assert(airspace != nullptr);
-  airspace->ClearClearance();
-}
@@ -142,11 +142,6 @@ public:
    */
   void SetActivity(const AirspaceActivity mask) const;
 
-  /**
-   * Clear the convex clearance polygon
-   */
-  void ClearClearance() const;
-
   /**
    * Equality operator, matches if contained airspace is the same
    */
@@ -79,9 +79,19 @@ AirspacePolygon::GetCenter() const
   return GeoPoint(Angle::Native(lon), Angle::Native(lat));
 }
 
+void
+AirspacePolygon::Project(const FlatProjection &projection)
+{
+  AbstractAirspace::Project(projection);
+  packed.Update(m_border);
+}
+
 bool
 AirspacePolygon::Inside(const GeoPoint &loc) const
 {
+  if (!packed.IsEmpty())
+    return packed.IsInside(loc);
+
   return m_border.IsInside(loc);
 }
 
@@ -94,6 +104,13 @@ AirspacePolygon::Intersects(const GeoPoint &start, const GeoPoint &end,
 
   AirspaceIntersectSort sorter(start, *this);
 
+  if (!packed.IsEmpty()) {
+    packed.VisitIntersections(ray, [&](double t){
+        sorter.add(t, projection.Unproject(ray.Parametric(t)));
+      });
+    return sorter.all();
+  }
+
   for (auto it = m_border.begin(); it + 1 != m_border.end(); ++it) {
 
     const FlatRay r_seg(it->GetFlatLocation(), (it + 1)->GetFlatLocation());
@@ -110,6 +127,8 @@ AirspacePolygon::ClosestPoint(const GeoPoint &loc,
                               const FlatProjection &projection) const
 {
   const auto p = projection.ProjectInteger(loc);
-  const auto pb = m_border.NearestPoint(p);
+  const auto pb = packed.IsEmpty()
+    ? m_border.NearestPoint(p)
+    : packed.NearestPoint(p);
   return projection.Unproject(pb);
 }
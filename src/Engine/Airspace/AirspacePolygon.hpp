@@ -24,6 +24,8 @@
 #define AIRSPACEPOLYGON_HPP
 
 #include "AbstractAirspace.hpp"
+#include "Geo/PackedPolygon.hpp"
+
 #include <vector>
 
 #ifdef DO_PRINT
@@ -32,6 +34,13 @@
 
 /** General polygon form airspace */
 class AirspacePolygon final : public AbstractAirspace {
+  /**
+   * A packed copy of #m_border for the geometric queries.  It is
+   * built by Project(), i.e. by Airspaces::Optimise(); until then,
+   * the queries fall back to #m_border.
+   */
+  PackedPolygon packed;
+
 public:
   /**
    * Constructor.  For testing, pts vector is a cloud of points,
@@ -54,6 +63,9 @@ public:
   GeoPoint ClosestPoint(const GeoPoint &loc,
                         const FlatProjection &projection) const override;
 
+protected:
+  void Project(const FlatProjection &projection) override;
+
 public:
 #ifdef DO_PRINT
   friend std::ostream &operator<<(std::ostream &f,
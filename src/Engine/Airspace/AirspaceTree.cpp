@@ -0,0 +1,213 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AirspaceTree.hpp"
+
+#include <algorithm>
+
+#include <math.h>
+
+static constexpr const FlatBoundingBox &
+GetBox(const Airspace &airspace)
+{
+  return airspace;
+}
+
+template<typename T>
+static constexpr const FlatBoundingBox &
+GetBox(const T &node)
+{
+  return node.box;
+}
+
+/**
+ * Returns twice the x coordinate of the box center.
+ */
+template<typename T>
+static inline long
+CenterX2(const T &value)
+{
+  const FlatBoundingBox &box = GetBox(value);
+  return long(box.lower_left.x) + box.upper_right.x;
+}
+
+template<typename T>
+static inline long
+CenterY2(const T &value)
+{
+  const FlatBoundingBox &box = GetBox(value);
+  return long(box.lower_left.y) + box.upper_right.y;
+}
+
+/**
+ * Sort the entries into the order of the sort-tile-recursive
+ * algorithm: vertical slices of about sqrt(n/NODE_SIZE) nodes, sorted
+ * by x, and within each slice sorted by y.  Afterwards, each run of
+ * #AirspaceTree::NODE_SIZE entries becomes one node.
+ */
+template<typename T>
+static void
+SortTiles(T *begin, T *end)
+{
+  const unsigned n = end - begin;
+  const unsigned n_nodes =
+    (n + AirspaceTree::NODE_SIZE - 1) / AirspaceTree::NODE_SIZE;
+  const unsigned n_slices = (unsigned)ceil(sqrt(double(n_nodes)));
+  const unsigned slice_size =
+    ((n_nodes + n_slices - 1) / n_slices) * AirspaceTree::NODE_SIZE;
+
+  std::sort(begin, end, [](const T &a, const T &b){
+      return CenterX2(a) < CenterX2(b);
+    });
+
+  for (T *slice = begin; slice < end; slice += slice_size)
+    std::sort(slice, std::min(slice + slice_size, end),
+              [](const T &a, const T &b){
+                return CenterY2(a) < CenterY2(b);
+              });
+}
+
+/**
+ * Append one node for each run of #AirspaceTree::NODE_SIZE entries.
+ */
+template<typename T, typename N>
+static void
+MakeParents(const T *begin, const T *end, unsigned first,
+            std::vector<N> &nodes)
+{
+  for (const T *i = begin; i < end; i += AirspaceTree::NODE_SIZE) {
+    const T *const node_end = std::min(i + AirspaceTree::NODE_SIZE, end);
+
+    N node;
+    node.box = GetBox(*i);
+    for (const T *j = std::next(i); j != node_end; ++j)
+      node.box.Merge(GetBox(*j));
+
+    node.first = first + (i - begin);
+    node.count = node_end - i;
+    nodes.push_back(node);
+  }
+}
+
+void
+AirspaceTree::clear()
+{
+  items.clear();
+  nodes.clear();
+  n_levels = 0;
+}
+
+void
+AirspaceTree::Pack(std::vector<Airspace> &&_items)
+{
+  items = std::move(_items);
+  nodes.clear();
+  n_levels = 0;
+
+  if (items.empty())
+    return;
+
+  SortTiles(items.data(), items.data() + items.size());
+  MakeParents(items.data(), items.data() + items.size(), 0, nodes);
+  n_levels = 1;
+
+  unsigned level_begin = 0;
+  while (nodes.size() - level_begin > 1) {
+    assert(n_levels < MAX_LEVELS);
+
+    const unsigned level_end = nodes.size();
+    SortTiles(nodes.data() + level_begin, nodes.data() + level_end);
+
+    /* MakeParents() reads the source level through pointers into
+       the vector it appends to, so it must not reallocate */
+    nodes.reserve(level_end +
+                  (level_end - level_begin + NODE_SIZE - 1) / NODE_SIZE);
+    MakeParents(nodes.data() + level_begin, nodes.data() + level_end,
+                level_begin, nodes);
+
+    level_begin = level_end;
+    ++n_levels;
+  }
+}
+
+AirspaceTree::const_iterator::const_iterator(const AirspaceTree &_tree,
+                                             const Query &_query)
+  :tree(&_tree), query(_query), depth(0), current(nullptr)
+{
+  if (tree->nodes.empty())
+    return;
+
+  /* the root is the last node */
+  const unsigned root = tree->nodes.size() - 1;
+  if (!query.MatchBox(tree->nodes[root].box))
+    return;
+
+  stack[0].position = root;
+  stack[0].end = root + 1;
+  depth = 1;
+
+  Next();
+}
+
+inline bool
+AirspaceTree::const_iterator::Descend(Cursor &cursor)
+{
+  while (cursor.position < cursor.end) {
+    const Node &node = tree->nodes[cursor.position++];
+    if (query.MatchBox(node.box)) {
+      Cursor &child = stack[depth++];
+      child.position = node.first;
+      child.end = node.first + node.count;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void
+AirspaceTree::const_iterator::Next()
+{
+  const unsigned n_levels = tree->n_levels;
+
+  while (depth > 0) {
+    Cursor &cursor = stack[depth - 1];
+
+    if (depth > n_levels) {
+      /* this cursor walks the items of a leaf */
+      while (cursor.position < cursor.end) {
+        const Airspace &item = tree->items[cursor.position++];
+        if (query.Match(item)) {
+          current = &item;
+          return;
+        }
+      }
+    } else if (Descend(cursor))
+      continue;
+
+    /* all children of this node have been visited */
+    --depth;
+  }
+
+  current = nullptr;
+}
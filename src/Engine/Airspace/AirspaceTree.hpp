@@ -0,0 +1,291 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_AIRSPACE_TREE_HPP
+#define XCSOAR_AIRSPACE_TREE_HPP
+
+#include "Airspace.hpp"
+#include "Geo/Flat/FlatRay.hpp"
+#include "Util/Range.hpp"
+#include "Compiler.h"
+
+#include <iterator>
+#include <vector>
+
+#include <assert.h>
+#include <stdint.h>
+
+/**
+ * A static R-tree of #Airspace envelopes.  It is bulk-loaded with the
+ * sort-tile-recursive (STR) algorithm into two contiguous arrays: the
+ * envelopes in leaf order, and the nodes level by level, leaves first
+ * and the root last.  The children of each node are adjacent, so a
+ * query walks the arrays mostly forward.
+ *
+ * The tree cannot be modified; Pack() replaces its contents.
+ */
+class AirspaceTree {
+public:
+  /**
+   * The maximum number of children of a node.
+   */
+  static constexpr unsigned NODE_SIZE = 16;
+
+  /**
+   * The maximum number of node levels; this limits the tree to
+   * NODE_SIZE^MAX_LEVELS items.
+   */
+  static constexpr unsigned MAX_LEVELS = 7;
+
+  /**
+   * Describes which envelopes a query shall return.
+   */
+  class Query {
+    enum class Type : uint8_t {
+      ALL,
+      OVERLAPPING,
+      INTERSECTING,
+    };
+
+    Type type;
+
+    /**
+     * The query box for Type::OVERLAPPING; the bounding box of the
+     * segment for Type::INTERSECTING.
+     */
+    FlatBoundingBox box;
+
+    /**
+     * The segment for Type::INTERSECTING.
+     */
+    FlatRay ray;
+
+    /**
+     * An optional additional test for each envelope which matches
+     * the geometric condition.
+     */
+    bool (*filter)(const Airspace &airspace, const void *ctx);
+    const void *filter_ctx;
+
+    Query(Type _type, const FlatBoundingBox &_box, const FlatRay &_ray)
+      :type(_type), box(_box), ray(_ray), filter(nullptr) {}
+
+  public:
+    static Query All() {
+      return Query(Type::ALL, FlatBoundingBox(FlatGeoPoint(0, 0)),
+                   FlatRay(FlatGeoPoint(0, 0), FlatGeoPoint(0, 0)));
+    }
+
+    /**
+     * Envelopes which overlap the given box.
+     */
+    static Query Overlapping(const FlatBoundingBox &box) {
+      return Query(Type::OVERLAPPING, box,
+                   FlatRay(FlatGeoPoint(0, 0), FlatGeoPoint(0, 0)));
+    }
+
+    /**
+     * Envelopes which intersect the segment from #a to #b.  This may
+     * return a few more envelopes which only touch the segment
+     * within rounding errors.
+     */
+    static Query Intersecting(const FlatGeoPoint &a, const FlatGeoPoint &b) {
+      FlatBoundingBox box(a);
+      box.Expand(b);
+      return Query(Type::INTERSECTING, box, FlatRay(a, b));
+    }
+
+    /**
+     * Return only envelopes for which the given function returns
+     * true.  The context pointer must remain valid while the query
+     * is being iterated.
+     */
+    Query &Filter(bool (*_filter)(const Airspace &, const void *),
+                  const void *ctx) {
+      filter = _filter;
+      filter_ctx = ctx;
+      return *this;
+    }
+
+    /**
+     * An inline version of FlatBoundingBox::Overlaps(), which is
+     * called for every node and item.
+     */
+    gcc_pure
+    bool Overlaps(const FlatBoundingBox &b) const {
+      return (b.lower_left.x <= box.upper_right.x) &
+        (b.upper_right.x >= box.lower_left.x) &
+        (b.lower_left.y <= box.upper_right.y) &
+        (b.upper_right.y >= box.lower_left.y);
+    }
+
+    gcc_pure
+    bool MatchBox(const FlatBoundingBox &b) const {
+      switch (type) {
+      case Type::ALL:
+        break;
+
+      case Type::OVERLAPPING:
+        return Overlaps(b);
+
+      case Type::INTERSECTING:
+        /* the ray test uses floating point, so grow the box to
+           compensate for rounding errors */
+        return Overlaps(b) && FlatBoundingBox(b).Grow(1).Intersects(ray);
+      }
+
+      return true;
+    }
+
+    gcc_pure
+    bool Match(const Airspace &airspace) const {
+      return MatchBox(airspace) &&
+        (filter == nullptr || filter(airspace, filter_ctx));
+    }
+  };
+
+private:
+  struct Node {
+    FlatBoundingBox box;
+
+    /**
+     * The index of the first child, either in #nodes or (on the leaf
+     * level) in #items.
+     */
+    unsigned first;
+
+    unsigned count;
+  };
+
+  std::vector<Airspace> items;
+  std::vector<Node> nodes;
+
+  /**
+   * The number of node levels; 0 if the tree is empty.
+   */
+  unsigned n_levels = 0;
+
+public:
+  class const_iterator {
+    friend class AirspaceTree;
+
+    /**
+     * A position within the children of one node.
+     */
+    struct Cursor {
+      unsigned position, end;
+    };
+
+    const AirspaceTree *tree;
+    Query query;
+
+    /**
+     * The current path from the root, one cursor per node level and
+     * one for the items of the current leaf.
+     */
+    Cursor stack[MAX_LEVELS + 1];
+    unsigned depth;
+
+    /**
+     * The current item or nullptr if this is the end iterator.
+     */
+    const Airspace *current;
+
+    const_iterator(const AirspaceTree &_tree, const Query &_query);
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Airspace value_type;
+    typedef const Airspace *pointer;
+    typedef const Airspace &reference;
+    typedef ptrdiff_t difference_type;
+
+    /**
+     * Construct an end iterator.
+     */
+    const_iterator()
+      :tree(nullptr), query(Query::All()), depth(0), current(nullptr) {}
+
+    const Airspace &operator*() const {
+      assert(current != nullptr);
+
+      return *current;
+    }
+
+    const Airspace *operator->() const {
+      assert(current != nullptr);
+
+      return current;
+    }
+
+    const_iterator &operator++() {
+      Next();
+      return *this;
+    }
+
+    bool operator==(const const_iterator &other) const {
+      return current == other.current;
+    }
+
+    bool operator!=(const const_iterator &other) const {
+      return current != other.current;
+    }
+
+  private:
+    /**
+     * Push a cursor for the next child of the given node cursor
+     * which matches the query.
+     *
+     * @return false if there is no such child
+     */
+    bool Descend(Cursor &cursor);
+
+    void Next();
+  };
+
+  typedef Range<const_iterator> const_iterator_range;
+
+  gcc_pure
+  unsigned size() const {
+    return items.size();
+  }
+
+  gcc_pure
+  bool empty() const {
+    return items.empty();
+  }
+
+  void clear();
+
+  /**
+   * Replace the contents of this tree.
+   */
+  void Pack(std::vector<Airspace> &&_items);
+
+  gcc_pure
+  const_iterator_range Find(const Query &query) const {
+    return {const_iterator(*this, query), const_iterator()};
+  }
+};
+
+#endif
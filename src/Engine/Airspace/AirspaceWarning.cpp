@@ -26,7 +26,7 @@ Copyright_License {
 #include <algorithm>
 
 AirspaceWarning::AirspaceWarning(const AbstractAirspace &_airspace)
-  :airspace(_airspace),
+  :airspace(&_airspace),
    state(WARNING_CLEAR),
    state_last(WARNING_CLEAR),
    solution(AirspaceInterceptSolution::Invalid()),
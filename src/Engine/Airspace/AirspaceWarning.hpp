@@ -52,7 +52,11 @@ public:
   };
 
 private:
-  const AbstractAirspace &airspace;
+  /**
+   * A pointer instead of a reference, so #AirspaceWarningManager
+   * can keep its warnings in a std::vector and sort them.
+   */
+  const AbstractAirspace *airspace;
   State state;
   State state_last;
   AirspaceInterceptSolution solution;
@@ -115,7 +119,7 @@ public:
    * @return Airspace
    */
   const AbstractAirspace &GetAirspace() const {
-    return airspace;
+    return *airspace;
   }
 
   /**
@@ -22,18 +22,52 @@
 
 #include "AirspaceWarningManager.hpp"
 #include "Geo/GeoVector.hpp"
+#include "Geo/Flat/FlatProjection.hpp"
+#include "Geo/Flat/FlatRay.hpp"
 #include "Airspaces.hpp"
 #include "AbstractAirspace.hpp"
-#include "AirspaceIntersectionVisitor.hpp"
+#include "AirspaceIntersectionVector.hpp"
+#include "AirspaceInterceptSolution.hpp"
 #include "AirspaceAircraftPerformance.hpp"
 #include "Task/Stats/TaskStats.hpp"
 
+#include <algorithm>
+#include <iterator>
+
 #define CRUISE_FILTER_FACT 0.5
 
+struct AirspaceWarningManager::Prediction {
+  /** The predicted location; the path starts at the aircraft */
+  GeoPoint location;
+
+  AirspaceAircraftPerformance perf;
+
+  AirspaceWarning::State warning_state;
+
+  /** Time limit of intercepts */
+  double max_time;
+
+  /** The predicted path, projected by Airspaces::GetProjection() */
+  FlatRay ray;
+
+  /* StaticArray needs a default constructor; it is never used */
+  Prediction():perf(AirspaceAircraftPerformance::Simple()),
+               ray(FlatGeoPoint(0, 0), FlatGeoPoint(0, 0)) {}
+
+  Prediction(const GeoPoint &_location,
+             const AirspaceAircraftPerformance &_perf,
+             AirspaceWarning::State _warning_state, double _max_time)
+    :location(_location), perf(_perf),
+     warning_state(_warning_state), max_time(_max_time),
+     ray(FlatGeoPoint(0, 0), FlatGeoPoint(0, 0)) {}
+};
+
 AirspaceWarningManager::AirspaceWarningManager(const AirspaceWarningConfig &_config,
                                                const Airspaces &_airspaces)
   :airspaces(_airspaces), serial(0)
 {
+  config.SetDefaults();
+
   /* force filter initialisation in the first SetConfig() call */
   config.warning_time = -1;
 
@@ -52,6 +86,12 @@ AirspaceWarningManager::SetConfig(const AirspaceWarningConfig &_config)
   const bool modified_warning_time =
     _config.warning_time != config.warning_time;
 
+  /* the class filter affects IsActive() */
+  if (!std::equal(std::begin(config.class_warnings),
+                  std::end(config.class_warnings),
+                  std::begin(_config.class_warnings)))
+    ++serial;
+
   config = _config;
 
   if (modified_warning_time) {
@@ -65,6 +105,7 @@ AirspaceWarningManager::Reset(const AircraftState &state)
 {
   ++serial;
   warnings.clear();
+  index.Clear();
   cruise_filter.Reset(state);
   circling_filter.Reset(state);
 }
@@ -92,30 +133,42 @@ AirspaceWarningManager::GetWarning(const AbstractAirspace &airspace)
     return *warning;
 
   // not found, create new entry
-  ++serial;
-  warnings.emplace_back(airspace);
-  return warnings.back();
+  return *GetNewWarningPtr(airspace);
 }
 
 
 AirspaceWarning* 
 AirspaceWarningManager::GetWarningPtr(const AbstractAirspace &airspace)
 {
-  for (auto &w : warnings)
-    if (&(w.GetAirspace()) == &airspace)
-      return &w;
+  const auto i = index.Find(&airspace);
+  if (i == index.NOT_FOUND)
+    return nullptr;
 
-  return nullptr;
+  return &warnings[index[i].value];
 }
 
 AirspaceWarning*
 AirspaceWarningManager::GetNewWarningPtr(const AbstractAirspace &airspace)
 {
+  const auto result = index.Insert(&airspace, warnings.size());
+  if (!result.second)
+    /* there is already a warning for this airspace */
+    return &warnings[index[result.first].value];
+
   ++serial;
   warnings.emplace_back(airspace);
   return &warnings.back();
 }
 
+void
+AirspaceWarningManager::RebuildIndex()
+{
+  index.Clear();
+
+  for (unsigned i = 0, n = warnings.size(); i < n; ++i)
+    index.Insert(&warnings[i].GetAirspace(), i);
+}
+
 bool 
 AirspaceWarningManager::Update(const AircraftState& state,
                                const GlidePolar &glide_polar,
@@ -138,150 +191,92 @@ AirspaceWarningManager::Update(const AircraftState& state,
 
   // check from strongest to weakest alerts
   UpdateInside(state, glide_polar);
-  UpdateGlide(state, glide_polar);
-  UpdateFilter(state, circling);
-  UpdateTask(state, glide_polar, task_stats);
-
-  // action changes
-  for (auto it = warnings.begin(), end = warnings.end(); it != end;) {
-    if (it->WarningLive(config.acknowledgement_time, dt)) {
-      if (it->ChangedState())
+
+  PredictionList predictions;
+  PredictGlide(state, glide_polar, predictions);
+  PredictFilter(state, circling, predictions);
+  PredictTask(state, glide_polar, task_stats, predictions);
+  UpdatePredicted(state, predictions);
+
+  // action changes, and remove expired warnings in one pass
+  bool modified = false;
+  auto dest = warnings.begin();
+  for (auto &w : warnings) {
+    if (w.WarningLive(config.acknowledgement_time, dt)) {
+      if (w.ChangedState())
         changed = true;
 
-      it++;
+      if (&*dest != &w)
+        *dest = w;
+      ++dest;
     } else {
       ++serial;
-      it = warnings.erase(it);
+      modified = true;
     }
   }
 
-  // sort by importance, most severe top
-  warnings.sort();
+  warnings.erase(dest, warnings.end());
+
+  // sort by importance, most severe top; the order rarely changes
+  // between two updates, so check that first
+  if (!std::is_sorted(warnings.begin(), warnings.end())) {
+    std::stable_sort(warnings.begin(), warnings.end());
+    modified = true;
+  }
+
+  if (modified)
+    RebuildIndex();
 
   return changed;
 }
 
 /**
- * Class used temporarily to check intersections with warning system
+ * Find the earliest intercept of the given intersections.
  */
-class AirspaceIntersectionWarningVisitor final
-  : public AirspaceIntersectionVisitor
+static AirspaceInterceptSolution
+Intercept(const AbstractAirspace &airspace,
+          const AirspaceIntersectionVector &intersections,
+          const AircraftState &state,
+          const AirspaceAircraftPerformance &perf)
 {
-  const AircraftState state;
-  const AirspaceAircraftPerformance &perf;
-  AirspaceWarningManager &warning_manager;
-  const AirspaceWarning::State warning_state;
-  const double max_time;
-  bool found;
-  const double max_alt;
-  bool mode_inside;
-
-public:
-  /**
-   * Constructor
-   *
-   * @param state State of aircraft
-   * @param perf Aircraft performance model
-   * @param warning_manager Warning manager to add items to
-   * @param warning_state Type of warning
-   * @param max_time Time limit of intercept
-   * @param max_alt Maximum height of base to allow (optional)
-   *
-   * @return Initialised object
-   */
-  AirspaceIntersectionWarningVisitor(const AircraftState &_state,
-                                     const AirspaceAircraftPerformance &_perf,
-                                     AirspaceWarningManager &_warning_manager,
-                                     const AirspaceWarning::State _warning_state,
-                                     const double _max_time,
-                                     const double _max_alt = -1):
-    state(_state),
-    perf(_perf),
-    warning_manager(_warning_manager),
-    warning_state(_warning_state),
-    max_time(_max_time),
-    found(false),
-    max_alt(_max_alt),
-    mode_inside(false)
-    {      
-    };
-
-  /**
-   * Check whether this intersection should be added to, or updated in, the warning manager
-   *
-   * @param airspace Airspace corresponding to current intersection
-   */
-  void Intersection(const AbstractAirspace& airspace) {
-    if (!airspace.IsActive())
-      return; // ignore inactive airspaces completely
-
-    if (!warning_manager.GetConfig().IsClassEnabled(airspace.GetType()) ||
-        ExcludeAltitude(airspace))
-      return;
-
-    AirspaceWarning *warning = warning_manager.GetWarningPtr(airspace);
-    if (warning == nullptr || warning->IsStateAccepted(warning_state)) {
-
-      AirspaceInterceptSolution solution;
-
-      if (mode_inside) {
-        solution = airspace.Intercept(state, perf,
-                                      state.location, state.location);
-      } else {
-        solution = Intercept(airspace, state, perf);
-      }
-      if (!solution.IsValid())
-        return;
-      if (solution.elapsed_time > max_time)
-        return;
-
-      if (warning == nullptr)
-        warning = warning_manager.GetNewWarningPtr(airspace);
-
-      warning->UpdateSolution(warning_state, solution);
-      found = true;
-    }
-  }
-
-  void Visit(const AbstractAirspace &as) override {
-    Intersection(as);
+  AirspaceInterceptSolution solution = AirspaceInterceptSolution::Invalid();
+  for (const auto &i : intersections) {
+    auto new_solution = airspace.Intercept(state, perf, i.first, i.second);
+    if (new_solution.IsEarlierThan(solution))
+      solution = new_solution;
   }
 
-  /**
-   * Determine whether intersections for this type were found (new or modified)
-   *
-   * @return True if intersections were found
-   */
-  bool Found() const {
-    return found;
-  }
+  return solution;
+}
 
-  void SetMode(bool m) {
-    mode_inside = m;
-  }
+static bool
+IsWithin(const AirspaceInterceptSolution &solution, double max_time)
+{
+  return solution.IsValid() && solution.elapsed_time <= max_time;
+}
 
-private:
-  bool ExcludeAltitude(const AbstractAirspace& airspace) {
-    if (max_alt <= 0)
-      return false;
+bool
+AirspaceWarningManager::UpdatePredicted(const AircraftState &state,
+                                        PredictionList &predictions)
+{
+  if (predictions.empty())
+    return false;
 
-    return (airspace.GetBaseAltitude(state) > max_alt);
-  }
-};
+  const FlatProjection &projection = GetProjection();
+  const FlatGeoPoint flat_location = projection.ProjectInteger(state.location);
 
+  GeoPoint ends[MAX_PREDICTIONS];
+  for (unsigned i = 0; i < predictions.size(); ++i) {
+    Prediction &p = predictions[i];
 
-bool 
-AirspaceWarningManager::UpdatePredicted(const AircraftState& state, 
-                                         const GeoPoint &location_predicted,
-                                         const AirspaceAircraftPerformance &perf,
-                                         const AirspaceWarning::State warning_state,
-                                        const double max_time)
-{
-  // this is the time limit of intrusions, beyond which we are not interested.
-  // it can be the minimum of the user set warning time, or the time of the 
-  // task segment
+    // this is the time limit of intrusions, beyond which we are not
+    // interested.  it can be the minimum of the user set warning
+    // time, or the time of the task segment
+    p.max_time = std::min(double(config.warning_time), p.max_time);
 
-  const auto max_time_limit = std::min(double(config.warning_time), max_time);
+    p.ray = FlatRay(flat_location, projection.ProjectInteger(p.location));
+    ends[i] = p.location;
+  }
 
   // the ceiling is the max height for predicted intrusions, given
   // that you may be climbing.  the ceiling is nominally set at 1000m
@@ -294,41 +289,78 @@ AirspaceWarningManager::UpdatePredicted(const AircraftState& state,
   const auto ceiling = state.altitude
     + std::max((unsigned)1000, config.altitude_warning_margin);
 
-  AirspaceIntersectionWarningVisitor visitor(state, perf, 
-                                             *this, 
-                                             warning_state, max_time_limit,
-                                             ceiling);
+  bool found = false;
 
-  airspaces.VisitIntersecting(state.location, location_predicted, visitor);
+  for (const auto &i : airspaces.QuerySwept(state.location,
+                                            ends, predictions.size())) {
+    const AbstractAirspace &airspace = i.GetAirspace();
 
-  visitor.SetMode(true);
+    if (!airspace.IsActive())
+      continue; // ignore inactive airspaces completely
 
-  for (const auto &i : airspaces.QueryInside(state.location)) {
-    const AbstractAirspace &airspace = i.GetAirspace();
-    visitor.Visit(airspace);
+    if (!config.IsClassEnabled(airspace.GetType()) ||
+        airspace.GetBaseAltitude(state) > ceiling)
+      continue;
+
+    /* the ray test uses floating point, so grow the box to
+       compensate for rounding errors */
+    const FlatBoundingBox box = FlatBoundingBox(i).Grow(1);
+
+    /* this test is shared by all predictions */
+    const bool inside = box.IsInside(flat_location) &&
+      i.IsInside(state.location);
+
+    for (const auto &p : predictions) {
+      AirspaceWarning *warning = GetWarningPtr(airspace);
+      if (warning != nullptr && !warning->IsStateAccepted(p.warning_state))
+        continue;
+
+      /* inside the outline, the solution at the aircraft's location
+         overrides the one along the path; the path needs to be
+         checked only if there is no such solution */
+      AirspaceInterceptSolution solution = inside
+        ? airspace.Intercept(state, p.perf, state.location, state.location)
+        : AirspaceInterceptSolution::Invalid();
+
+      if (!IsWithin(solution, p.max_time) && box.Intersects(p.ray))
+        solution = Intercept(airspace,
+                             i.Intersects(state.location, p.location,
+                                          projection),
+                             state, p.perf);
+
+      if (!IsWithin(solution, p.max_time))
+        continue;
+
+      if (warning == nullptr)
+        warning = GetNewWarningPtr(airspace);
+
+      warning->UpdateSolution(p.warning_state, solution);
+      found = true;
+    }
   }
 
-  return visitor.Found();
+  return found;
 }
 
 
-bool 
-AirspaceWarningManager::UpdateTask(const AircraftState &state,
-                                   const GlidePolar &glide_polar,
-                                   const TaskStats &task_stats)
+void
+AirspaceWarningManager::PredictTask(const AircraftState &state,
+                                    const GlidePolar &glide_polar,
+                                    const TaskStats &task_stats,
+                                    PredictionList &predictions) const
 {
   if (!glide_polar.IsValid())
-    return false;
+    return;
 
   const ElementStat &current_leg = task_stats.current_leg;
 
   if (!task_stats.task_valid || !current_leg.location_remaining.IsValid())
-    return false;
+    return;
 
   const GlideResult &solution = current_leg.solution_remaining;
   if (!solution.IsOk() || !solution.IsAchievable())
     /* glide solver failed, cannot continue */
-    return false;
+    return;
 
   const AirspaceAircraftPerformance perf_task(glide_polar,
                                               current_leg.solution_remaining);
@@ -342,47 +374,50 @@ AirspaceWarningManager::UpdateTask(const AircraftState &state,
        the configured warning time */
     location_tp = state.location.IntermediatePoint(location_tp, max_distance);
 
-  return UpdatePredicted(state, location_tp, perf_task,
-                          AirspaceWarning::WARNING_TASK, time_remaining);
+  predictions.append(Prediction(location_tp, perf_task,
+                                AirspaceWarning::WARNING_TASK,
+                                time_remaining));
 }
 
 
-bool 
-AirspaceWarningManager::UpdateFilter(const AircraftState& state, const bool circling)
+void
+AirspaceWarningManager::PredictFilter(const AircraftState& state,
+                                      const bool circling,
+                                      PredictionList &predictions)
 {
   // update both filters even though we are using only one
   cruise_filter.Update(state);
   circling_filter.Update(state);
 
-  const GeoPoint location_predicted = circling?
-    circling_filter.GetPredictedState(prediction_time_filter).location:
-    cruise_filter.GetPredictedState(prediction_time_filter).location;
-
-  if (circling) 
-    return UpdatePredicted(state, location_predicted,
-                           AirspaceAircraftPerformance(circling_filter),
-                            AirspaceWarning::WARNING_FILTER, prediction_time_filter);
-  else
-    return UpdatePredicted(state, location_predicted,
-                           AirspaceAircraftPerformance(cruise_filter),
-                            AirspaceWarning::WARNING_FILTER, prediction_time_filter);
+  const AircraftStateFilter &filter = circling
+    ? circling_filter
+    : cruise_filter;
+
+  const GeoPoint location_predicted =
+    filter.GetPredictedState(prediction_time_filter).location;
+
+  predictions.append(Prediction(location_predicted,
+                                AirspaceAircraftPerformance(filter),
+                                AirspaceWarning::WARNING_FILTER,
+                                prediction_time_filter));
 }
 
 
-bool 
-AirspaceWarningManager::UpdateGlide(const AircraftState &state,
-                                    const GlidePolar &glide_polar)
+void
+AirspaceWarningManager::PredictGlide(const AircraftState &state,
+                                     const GlidePolar &glide_polar,
+                                     PredictionList &predictions) const
 {
   if (!glide_polar.IsValid())
-    return false;
+    return;
 
   const GeoPoint location_predicted = 
     state.GetPredictedState(prediction_time_glide).location;
 
-  const AirspaceAircraftPerformance perf_glide(glide_polar);
-  return UpdatePredicted(state, location_predicted,
-                          perf_glide,
-                          AirspaceWarning::WARNING_GLIDE, prediction_time_glide);
+  predictions.append(Prediction(location_predicted,
+                                AirspaceAircraftPerformance(glide_polar),
+                                AirspaceWarning::WARNING_GLIDE,
+                                prediction_time_glide));
 }
 
 bool
@@ -451,6 +486,9 @@ AirspaceWarningManager::AcknowledgeDay(const AbstractAirspace& airspace,
                                         const bool set)
 {
   GetWarning(airspace).AcknowledgeDay(set);
+
+  /* this affects IsActive() */
+  ++serial;
 }
 
 bool
@@ -25,15 +25,16 @@
 #include "AirspaceWarning.hpp"
 #include "AirspaceWarningConfig.hpp"
 #include "Util/AircraftStateFilter.hpp"
+#include "Util/OpenHashMap.hpp"
+#include "Util/StaticArray.hxx"
 #include "Compiler.h"
 
-#include <list>
+#include <vector>
 
 class TaskStats;
 class GlidePolar;
 class Airspaces;
 class FlatProjection;
-class AirspaceAircraftPerformance;
 
 /**
  * Class to detect and track airspace warnings
@@ -57,10 +58,20 @@ class AirspaceWarningManager {
   AircraftStateFilter cruise_filter;
   AircraftStateFilter circling_filter;
 
-  typedef std::list<AirspaceWarning> AirspaceWarningList;
+  typedef std::vector<AirspaceWarning> AirspaceWarningList;
 
+  /**
+   * The warnings, most severe first (after Update() has returned).
+   */
   AirspaceWarningList warnings;
 
+  /**
+   * Maps each airspace to the index of its warning in #warnings.  It
+   * is rebuilt by Update() after warnings have been removed or
+   * reordered.
+   */
+  OpenHashMap<const AbstractAirspace *, unsigned> index;
+
   /**
    * This number is incremented each time this object is modified.
    */
@@ -92,7 +103,8 @@ public:
 
   /**
    * Returns a serial for the current state.  The serial gets
-   * incremented each time the list of warnings is modified.
+   * incremented each time the list of warnings is modified, and
+   * each time the result of IsActive() may change.
    */
   unsigned GetSerial() const {
     return serial;
@@ -138,6 +150,10 @@ public:
   /**
    * Find corresponding airspace warning item in store for an airspace
    *
+   * The returned reference (and the pointers returned by
+   * GetWarningPtr() and GetNewWarningPtr()) is only valid until the
+   * next warning is created or until Update() is called.
+   *
    * @param airspace Airspace to find warning for
    *
    * @return Reference to airspace warning item
@@ -182,6 +198,7 @@ public:
   void clear() {
     ++serial;
     warnings.clear();
+    index.Clear();
   }
 
   /**
@@ -261,17 +278,43 @@ public:
   bool IsActive(const AbstractAirspace &airspace) const;
 
 private:
-  bool UpdateTask(const AircraftState &state, const GlidePolar &glide_polar,
-                  const TaskStats &task_stats);
-  bool UpdateFilter(const AircraftState& state, const bool circling);
-  bool UpdateGlide(const AircraftState& state, const GlidePolar &glide_polar);
+  /**
+   * Rebuild #index after #warnings has been modified.
+   */
+  void RebuildIndex();
+
+  /**
+   * A predicted flight path from the aircraft's location, which is
+   * checked for airspace intrusions by UpdatePredicted().
+   */
+  struct Prediction;
+
+  /**
+   * The predictions of one Update() call: glide, filter and task,
+   * strongest first.
+   */
+  static constexpr unsigned MAX_PREDICTIONS = 3;
+  typedef StaticArray<Prediction, MAX_PREDICTIONS> PredictionList;
+
+  void PredictTask(const AircraftState &state, const GlidePolar &glide_polar,
+                   const TaskStats &task_stats,
+                   PredictionList &predictions) const;
+  void PredictFilter(const AircraftState& state, const bool circling,
+                     PredictionList &predictions);
+  void PredictGlide(const AircraftState& state, const GlidePolar &glide_polar,
+                    PredictionList &predictions) const;
   bool UpdateInside(const AircraftState& state, const GlidePolar &glide_polar);
 
-  bool UpdatePredicted(const AircraftState& state, 
-                       const GeoPoint &location_predicted,
-                       const AirspaceAircraftPerformance &perf,
-                       const AirspaceWarning::State warning_state,
-                       double max_time);
+  /**
+   * Check all predictions in one sweep: the airspaces are searched
+   * once for the bounding box of all predicted paths, and each
+   * candidate is then tested against each path.
+   *
+   * @param predictions the list of predictions; the time limits are
+   * clipped to the configured warning time
+   */
+  bool UpdatePredicted(const AircraftState& state,
+                       PredictionList &predictions);
 };
 
 #endif
@@ -26,19 +26,15 @@
 #include "Predicate/AirspacePredicate.hpp"
 #include "Navigation/Aircraft.hpp"
 
-#include <boost/geometry/geometries/linestring.hpp>
-
-namespace bgi = boost::geometry::index;
-
 Airspaces::const_iterator_range
 Airspaces::QueryWithinRange(const GeoPoint &location, double range) const
 {
   if (IsEmpty())
     // nothing to do
-    return {airspace_tree.qend(), airspace_tree.qend()};
+    return {};
 
   const FlatBoundingBox box = task_projection.ProjectSquare(location, range);
-  return {airspace_tree.qbegin(bgi::intersects(box)), airspace_tree.qend()};
+  return airspace_tree.Find(AirspaceTree::Query::Overlapping(box));
 }
 
 Airspaces::const_iterator_range
@@ -46,14 +42,26 @@ Airspaces::QueryIntersecting(const GeoPoint &a, const GeoPoint &b) const
 {
   if (IsEmpty())
     // nothing to do
-    return {airspace_tree.qend(), airspace_tree.qend()};
+    return {};
 
-  // TODO: use StaticArray instead of std::vector
-  boost::geometry::model::linestring<FlatGeoPoint> line;
-  line.push_back(task_projection.ProjectInteger(a));
-  line.push_back(task_projection.ProjectInteger(b));
+  const auto flat_a = task_projection.ProjectInteger(a);
+  const auto flat_b = task_projection.ProjectInteger(b);
+  return airspace_tree.Find(AirspaceTree::Query::Intersecting(flat_a, flat_b));
+}
 
-  return {airspace_tree.qbegin(bgi::intersects(line)), airspace_tree.qend()};
+Airspaces::const_iterator_range
+Airspaces::QuerySwept(const GeoPoint &location,
+                      const GeoPoint *ends, unsigned n) const
+{
+  if (IsEmpty())
+    // nothing to do
+    return {};
+
+  FlatBoundingBox box(task_projection.ProjectInteger(location));
+  for (unsigned i = 0; i < n; ++i)
+    box.Expand(task_projection.ProjectInteger(ends[i]));
+
+  return airspace_tree.Find(AirspaceTree::Query::Overlapping(box));
 }
 
 void
@@ -88,22 +96,25 @@ Airspaces::Optimise()
     /* avoid assertion failure in uninitialised task_projection */
     return;
 
-  if (!owns_children || task_projection.Update()) {
-    // dont update task_projection if not owner!
-
-    // task projection changed, so need to push items back onto stack
-    // to re-build airspace envelopes
-
-    for (const auto &i : QueryAll())
-      tmp_as.push_back(&i.GetAirspace());
+  // dont update task_projection if not owner!
+  const bool projection_changed =
+    !owns_children || task_projection.Update();
 
-    airspace_tree.clear();
+  AirspaceVector v;
+  v.reserve(airspace_tree.size() + tmp_as.size());
+
+  for (const auto &i : QueryAll()) {
+    if (projection_changed)
+      // task projection changed, so need to re-build airspace envelopes
+      v.emplace_back(i.GetAirspace(), task_projection);
+    else
+      v.push_back(i);
   }
 
-  for (AbstractAirspace *i : tmp_as) {
-    Airspace as(*i, task_projection);
-    airspace_tree.insert(as);
-  }
+  for (AbstractAirspace *i : tmp_as)
+    v.emplace_back(*i, task_projection);
+
+  airspace_tree.Pack(std::move(v));
 
   tmp_as.clear();
 
@@ -179,6 +190,8 @@ Airspaces::SetFlightLevels(const AtmosphericPressure &press)
 
     for (auto &v : QueryAll())
       v.SetFlightLevel(press);
+
+    ++serial;
   }
 }
 
@@ -190,14 +203,9 @@ Airspaces::SetActivity(const AirspaceActivity mask)
 
     for (auto &v : QueryAll())
       v.SetActivity(mask);
-  }
-}
 
-void
-Airspaces::ClearClearances()
-{
-  for (auto &v : QueryAll())
-    v.ClearClearance();
+    ++serial;
+  }
 }
 
 gcc_pure
@@ -234,47 +242,56 @@ Airspaces::SynchroniseInRange(const Airspaces &master,
                               const double range,
                               const AirspacePredicate &condition)
 {
-  qnh = master.qnh;
-  activity_mask = master.activity_mask;
-  task_projection = master.task_projection;
-
   AirspaceVector contents_master;
   for (const auto &i : master.QueryWithinRange(location, range))
     if (condition(i.GetAirspace()))
       contents_master.push_back(i);
 
+  return Synchronise(master, contents_master);
+}
+
+bool
+Airspaces::Synchronise(const Airspaces &master,
+                       const AirspaceVector &contents_master)
+{
+  qnh = master.qnh;
+  activity_mask = master.activity_mask;
+  task_projection = master.task_projection;
+
   if (CompareAirspaceVectors(contents_master, AsVector()))
     return false;
 
-  for (auto &i : QueryAll())
-    i.ClearClearance();
-  airspace_tree.clear();
-
-  for (const auto &i : contents_master)
-    airspace_tree.insert(i);
+  airspace_tree.Pack(AirspaceVector(contents_master));
 
   ++serial;
 
   return true;
 }
 
+static bool
+IsInsideLocation(const Airspace &airspace, const void *ctx)
+{
+  return airspace.IsInside(*(const GeoPoint *)ctx);
+}
+
 Airspaces::const_iterator_range
 Airspaces::QueryInside(const GeoPoint &loc) const
 {
   if (IsEmpty())
     // nothing to do
-    return {airspace_tree.qend(), airspace_tree.qend()};
+    return {};
 
   const auto flat_location = task_projection.ProjectInteger(loc);
   const FlatBoundingBox box(flat_location, flat_location);
 
-  const auto _begin =
-    airspace_tree.qbegin(bgi::intersects(box) &&
-                         bgi::satisfies([&loc](const Airspace &as){
-                             return as.IsInside(loc);
-                           }));
+  return airspace_tree.Find(AirspaceTree::Query::Overlapping(box)
+                            .Filter(IsInsideLocation, &loc));
+}
 
-  return {_begin, airspace_tree.qend()};
+static bool
+IsInsideAircraft(const Airspace &airspace, const void *ctx)
+{
+  return airspace.IsInside(*(const AircraftState *)ctx);
 }
 
 Airspaces::const_iterator_range
@@ -282,16 +299,11 @@ Airspaces::QueryInside(const AircraftState &aircraft) const
 {
   if (IsEmpty())
     // nothing to do
-    return {airspace_tree.qend(), airspace_tree.qend()};
+    return {};
 
   const auto flat_location = task_projection.ProjectInteger(aircraft.location);
   const FlatBoundingBox box(flat_location, flat_location);
 
-  const auto _begin =
-    airspace_tree.qbegin(bgi::intersects(box) &&
-                         bgi::satisfies([&aircraft](const Airspace &as){
-                             return as.IsInside(aircraft);
-                           }));
-
-  return {_begin, airspace_tree.qend()};
+  return airspace_tree.Find(AirspaceTree::Query::Overlapping(box)
+                            .Filter(IsInsideAircraft, &aircraft));
 }
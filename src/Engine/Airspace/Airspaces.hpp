@@ -52,8 +52,9 @@ class Airspaces : public AirspacesInterface {
   std::deque<AbstractAirspace *> tmp_as;
 
   /**
-   * This attribute keeps track of changes to this project.  It is
-   * used by the renderer cache.
+   * This attribute keeps track of changes to this project, including
+   * changes of airspace altitudes and activity.  It is used by the
+   * #AirspaceRoute cache.
    */
   Serial serial;
 
@@ -97,9 +98,18 @@ public:
    * Re-organise the internal airspace tree after inserting/deleting.
    * Should be called after inserting/deleting airspaces prior to performing
    * any searches, but can be done once after a batch insert/delete.
+   * The tree is bulk-loaded from scratch each time.
    */
   void Optimise();
 
+  /**
+   * Returns the airspaces which have been added since the last
+   * Optimise() call, in the order of the Add() calls.
+   */
+  const std::deque<AbstractAirspace *> &GetPending() const {
+    return tmp_as;
+  }
+
   /**
    * Clear the airspace store, deleting airspace objects if m_owner is true
    */
@@ -146,10 +156,7 @@ public:
 
   gcc_pure
   const_iterator_range QueryAll() const {
-    auto predicate = boost::geometry::index::satisfies([](const Airspace &){
-        return true;
-      });
-    return {airspace_tree.qbegin(predicate), airspace_tree.qend()};
+    return airspace_tree.Find(AirspaceTree::Query::All());
   }
 
   /**
@@ -170,6 +177,18 @@ public:
   const_iterator_range QueryIntersecting(const GeoPoint &a,
                                          const GeoPoint &b) const;
 
+  /**
+   * Query airspaces which overlap the bounding box of all vectors
+   * from #location to one of #ends: the candidates for intersections
+   * with any of these vectors, and for containing #location.  This
+   * searches the tree only once for several vectors; the caller
+   * checks each candidate against each vector.  The result is in no
+   * specific order.
+   */
+  gcc_pure
+  const_iterator_range QuerySwept(const GeoPoint &location,
+                                  const GeoPoint *ends, unsigned n) const;
+
   /**
    * Call visitor class on airspaces intersected by vector.
    * Note that the visitor is not instantiated separately for each match
@@ -210,11 +229,6 @@ public:
     return task_projection;
   }
 
-  /**
-   * Empty clearance polygons of all airspaces in this database
-   */
-  void ClearClearances();
-
   /**
    * Copy/delete objects in this database based on query of master
    *
@@ -229,6 +243,16 @@ public:
                           const GeoPoint &location, double range,
                           const AirspacePredicate &condition);
 
+  /**
+   * Like SynchroniseInRange(), but the caller has already selected
+   * the objects to be copied from the master.
+   *
+   * @param contents a list of airspaces from #master
+   *
+   * @return True on change
+   */
+  bool Synchronise(const Airspaces &master, const AirspaceVector &contents);
+
 private:
   gcc_pure
   AirspaceVector AsVector() const;
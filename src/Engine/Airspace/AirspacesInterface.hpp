@@ -22,11 +22,9 @@
 #ifndef AIRSPACESINTERFACE_HPP
 #define AIRSPACESINTERFACE_HPP
 
-#include "Airspace.hpp"
-#include "Geo/Flat/BoostFlatBoundingBox.hpp"
+#include "AirspaceTree.hpp"
 
-#include <boost/geometry/index/rtree.hpp>
-#include <boost/range/iterator_range_core.hpp>
+#include <vector>
 
 /**
  * Abstract class for interface to #Airspaces database.
@@ -34,26 +32,12 @@
  * facade protected class where locking is required.
  */
 class AirspacesInterface {
-  struct AirspaceIndexable {
-    typedef FlatBoundingBox result_type;
-
-    result_type operator()(const Airspace &airspace) const {
-      return airspace;
-    }
-  };
-
 public:
   typedef std::vector<Airspace> AirspaceVector; /**< Vector of airspaces (used internally) */
 
-  /**
-   * Type of KD-tree data structure for airspace container
-   */
-  typedef boost::geometry::index::rtree<Airspace, boost::geometry::index::rstar<16>,
-                                        AirspaceIndexable> AirspaceTree;
-
-  typedef AirspaceTree::const_query_iterator const_iterator;
+  typedef AirspaceTree::const_iterator const_iterator;
 
-  typedef boost::iterator_range<const_iterator> const_iterator_range;
+  typedef AirspaceTree::const_iterator_range const_iterator_range;
 };
 
 #endif
@@ -35,5 +35,7 @@ Airspaces::SetGroundLevels(const RasterTerrain &terrain)
     GeoPoint g = task_projection.Unproject(c_flat);
     v.SetGroundLevel(terrain.GetTerrainHeight(g).GetValueOr0());
   }
+
+  ++serial;
 }
 
@@ -25,9 +25,13 @@
 #include "GlidePolar.hpp"
 #include "GlideResult.hpp"
 #include "Math/ZeroFinder.hpp"
+#include "Math/Util.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Geo/SpeedVector.hpp"
 #include "Util/Tolerances.hpp"
 
 #include <assert.h>
+#include <math.h>
 
 MacCready::MacCready(const GlideSettings &_settings,
                      const GlidePolar &_glide_polar,
@@ -276,6 +280,71 @@ MacCready::SolveStraight(const GlideState &task) const
   return SolveGlide(task, glide_polar.GetVBestLD());
 }
 
+void
+MacCready::SolveStraight(const GeoVector *vectors,
+                         const double *min_arrival_altitudes, unsigned n,
+                         double altitude, const SpeedVector &wind,
+                         double *altitude_differences, bool *valid) const
+{
+  if (!glide_polar.IsValid() || glide_polar.GetMC() <= 0) {
+    /* the speed to fly depends on the head wind, so there is no
+       shortcut; solve each destination separately */
+    for (unsigned i = 0; i < n; ++i) {
+      const GlideState state(vectors[i], min_arrival_altitudes[i],
+                             altitude, wind);
+      const GlideResult result = SolveStraight(state);
+      valid[i] = result.IsOk();
+      altitude_differences[i] = result.pure_glide_altitude_difference;
+    }
+
+    return;
+  }
+
+  /* see SolveGlide() and GlideState::CalcAverageSpeed() */
+  const auto v_set = glide_polar.GetVBestLD();
+  const auto sink_rate = glide_polar.SinkRate(v_set);
+  const auto v = v_set * cruise_efficiency;
+
+  const bool has_wind = wind.IsNonZero();
+  const auto wind_speed = has_wind ? wind.norm : 0.;
+  const auto sc_wind = wind.bearing.Reciprocal().SinCos();
+  const auto sin_wind = sc_wind.first, cos_wind = sc_wind.second;
+  const auto discriminant_base = Square(v) - Square(wind_speed);
+
+  for (unsigned i = 0; i < n; ++i) {
+    const GeoVector &vector = vectors[i];
+    const auto altitude_difference = altitude - min_arrival_altitudes[i];
+
+    if (vector.distance <= 0) {
+      /* SolveVertical() */
+      const GlideState state(vector, min_arrival_altitudes[i],
+                             altitude, wind);
+      const GlideResult result = SolveStraight(state);
+      valid[i] = result.IsOk();
+      altitude_differences[i] = result.pure_glide_altitude_difference;
+      continue;
+    }
+
+    double ground_speed = v;
+    if (has_wind) {
+      /* cos(wind.bearing.Reciprocal() - vector.bearing) */
+      const auto sc = vector.bearing.SinCos();
+      const auto head_wind = -wind_speed *
+        (cos_wind * sc.second + sin_wind * sc.first);
+
+      const auto discriminant = Square(head_wind) + discriminant_base;
+      ground_speed = discriminant >= 0
+        ? sqrt(discriminant) - head_wind
+        : -1;
+    }
+
+    valid[i] = ground_speed > 0;
+    altitude_differences[i] = valid[i]
+      ? altitude_difference - vector.distance / ground_speed * sink_rate
+      : altitude_difference;
+  }
+}
+
 GlideResult
 MacCready::Solve(const GlideState &task) const
 {
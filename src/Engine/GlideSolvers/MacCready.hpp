@@ -27,6 +27,8 @@
 struct GlideSettings;
 struct GlideState;
 struct GlideResult;
+struct GeoVector;
+struct SpeedVector;
 class GlidePolar;
 
 /**
@@ -87,6 +89,29 @@ public:
   gcc_pure
   GlideResult SolveStraight(const GlideState &task) const;
 
+  /**
+   * Like SolveStraight(), but for many destinations from the same
+   * location at once, and only calculates
+   * GlideResult::pure_glide_altitude_difference.  This is much
+   * cheaper than calling SolveStraight() for each destination,
+   * because the speed to fly and the sink rate are determined only
+   * once.
+   *
+   * @param vectors the vectors from the aircraft to the destinations
+   * @param min_arrival_altitudes the minimum arrival altitude at each
+   * destination
+   * @param n the number of destinations
+   * @param altitude the current aircraft altitude
+   * @param altitude_differences receives the pure glide altitude
+   * difference for each destination
+   * @param valid receives false for each destination where
+   * SolveStraight() would not have returned a valid result
+   */
+  void SolveStraight(const GeoVector *vectors,
+                     const double *min_arrival_altitudes, unsigned n,
+                     double altitude, const SpeedVector &wind,
+                     double *altitude_differences, bool *valid) const;
+
   /** 
    * Calculates the glide solution for a classical MacCready theory task.
    * Internally different calculations are used depending on the nature of the
@@ -25,10 +25,9 @@ Copyright_License {
 #define ASTAR_HPP
 
 #include "Util/ReservablePriorityQueue.hpp"
+#include "Util/OpenHashMap.hpp"
 #include "Compiler.h"
 
-#include <unordered_map>
-
 struct AStarPriorityValue
 {
   static constexpr unsigned MINMAX_OFFSET = 134217727;
@@ -75,25 +74,29 @@ template <class Node, class Hash=std::hash<Node>,
           bool m_min=true>
 class AStar
 {
-  typedef std::unordered_map<Node, AStarPriorityValue, Hash, KeyEqual> node_value_map;
+  struct NodeData {
+    /** The value of the node (accumulated distance) */
+    AStarPriorityValue value;
 
-  typedef typename node_value_map::iterator node_value_iterator;
-  typedef typename node_value_map::const_iterator node_value_const_iterator;
+    /** The best predecessor found so far */
+    Node parent;
 
-  typedef std::unordered_map<Node, Node, Hash, KeyEqual> node_parent_map;
+    constexpr
+    NodeData(const AStarPriorityValue &_value, const Node &_parent)
+      :value(_value), parent(_parent) {}
+  };
 
-  typedef typename node_parent_map::iterator node_parent_iterator;
-  typedef typename node_parent_map::const_iterator node_parent_const_iterator;
+  typedef OpenHashMap<Node, NodeData, Hash, KeyEqual> NodeMap;
+  typedef typename NodeMap::size_type node_index;
 
   struct NodeValue {
     AStarPriorityValue priority;
 
-    node_value_iterator iterator;
+    node_index index;
 
     constexpr
-    NodeValue(const AStarPriorityValue &_priority,
-              node_value_iterator _iterator)
-      :priority(_priority), iterator(_iterator) {}
+    NodeValue(const AStarPriorityValue &_priority, node_index _index)
+      :priority(_priority), index(_index) {}
   };
 
   struct Rank: public std::binary_function<NodeValue, NodeValue, bool>
@@ -105,23 +108,18 @@ class AStar
   };
 
   /**
-   * Stores the value of each node.  It is updated by push(), if a
-   * value lower than the current one is found.
-   */
-  node_value_map node_values;
-
-  /**
-   * Stores the predecessor of each node.  It is maintained by
-   * set_predecessor().
+   * Stores the value and the predecessor of each node.  It is
+   * updated by Push(), if a value lower than the current one is
+   * found.  Its memory is reused by the next search after Clear().
    */
-  node_parent_map node_parents;
+  NodeMap nodes;
 
   /**
    * A sorted list of all possible node paths, lowest distance first.
    */
   reservable_priority_queue<NodeValue, std::vector<NodeValue>, Rank> q;
 
-  node_value_iterator cur;
+  node_index cur;
 
 public:
   static constexpr unsigned DEFAULT_QUEUE_SIZE = 1024;
@@ -132,6 +130,7 @@ public:
    * @param is_min Whether this algorithm will search for min or max distance
    */
   AStar(unsigned reserve_default = DEFAULT_QUEUE_SIZE)
+    :cur(NodeMap::NOT_FOUND)
   {
     Reserve(reserve_default);
   }
@@ -143,6 +142,7 @@ public:
    * @param is_min Whether this algorithm will search for min or max distance
    */
   AStar(const Node &node, unsigned reserve_default = DEFAULT_QUEUE_SIZE)
+    :cur(NodeMap::NOT_FOUND)
   {
     Reserve(reserve_default);
     Push(node, node, AStarPriorityValue(0));
@@ -163,10 +163,9 @@ public:
     // Clear the search queue
     q.clear();
 
-    // Clear the node_parent_map
-    node_parents.clear();
-    // Clear the node_value_map
-    node_values.clear();
+    // Clear the node table
+    nodes.Clear();
+    cur = NodeMap::NOT_FOUND;
   }
 
   /**
@@ -189,20 +188,30 @@ public:
     return q.size();
   }
 
+  /**
+   * Return the number of nodes which have been reached since the
+   * last Restart() or Clear()
+   */
+  gcc_pure
+  unsigned GetNodeCount() const {
+    return nodes.GetSize();
+  }
+
   /**
    * Return top element of queue for processing
    *
    * @return Node for processing
    */
-  const Node &Pop() {
-    cur = q.top().iterator;
+  Node Pop() {
+    cur = q.top().index;
 
     do { // remove this item
       q.pop();
-    } while (!q.empty() && (q.top().priority > q.top().iterator->second));
+    } while (!q.empty() &&
+             (q.top().priority > nodes[q.top().index].value.value));
     // and all lower rank than this
 
-    return cur->first;
+    return nodes[cur].key;
   }
 
   /**
@@ -227,9 +236,9 @@ public:
    */
   gcc_pure
   Node GetPredecessor(const Node &node) const {
-    // Try to find the given node in the node_parent_map
-    node_parent_const_iterator it = node_parents.find(node);
-    if (it == node_parents.end())
+    // Try to find the given node in the node table
+    const node_index i = nodes.Find(node);
+    if (i == NodeMap::NOT_FOUND)
       // first entry
       // If the node wasn't found
       // -> Return the given node itself
@@ -237,7 +246,7 @@ public:
 
     // If the node was found
     // -> Return the parent node
-    return it->second;
+    return nodes[i].value.parent;
   }
 
   /** Reserve queue size (if available) */
@@ -245,20 +254,27 @@ public:
     q.reserve(size);
   }
 
+  /**
+   * Reserve memory for the specified number of nodes.
+   */
+  void ReserveNodes(unsigned size) {
+    nodes.Reserve(size);
+  }
+
   /**
    * Obtain the value of this node (accumulated distance to this node)
    * Returns 0 on failure to find the node.
    */
   gcc_pure
   AStarPriorityValue GetNodeValue(const Node &node) const {
-    node_value_const_iterator it = node_values.find(node);
-    if (cur->first == node)
-      return cur->second;
+    if (cur != NodeMap::NOT_FOUND && nodes[cur].key == node)
+      return nodes[cur].value.value;
 
-    if (it == node_values.end())
+    const node_index i = nodes.Find(node);
+    if (i == NodeMap::NOT_FOUND)
       return AStarPriorityValue(0);
 
-    return it->second;
+    return nodes[i].value.value;
   }
 
 private:
@@ -271,39 +287,26 @@ private:
    */
   void Push(const Node &node, const Node &parent,
             const AStarPriorityValue &edge_value) {
-    // Try to find the given node n in the node_value_map
-    node_value_iterator it = node_values.find(node);
-    if (it == node_values.end()) {
-      // first entry
-      // If the node wasn't found
-      // -> Insert a new node into the node_value_map
-      it = node_values.insert(std::make_pair(node, edge_value)).first;
-
-      // Remember the parent node
-      SetPredecessor(node, parent);
-    } else if (it->second > edge_value) {
-      // If the node was found and the new value is smaller
-      // -> Replace the value with the new one
-      it->second = edge_value;
-      // replace, it's bigger
-
-      // Remember the new parent node
-      SetPredecessor(node, parent);
-    } else
-      // If the node was found but the value is higher or equal
-      // -> Don't use this new leg
-      return;
-
-    q.push(NodeValue(edge_value, it));
-  }
+    // Try to find the given node n in the node table, insert it if
+    // it wasn't found
+    const auto result = nodes.Insert(node, NodeData(edge_value, parent));
+    if (!result.second) {
+      NodeData &data = nodes[result.first].value;
+      if (data.value > edge_value) {
+        // If the node was found and the new value is smaller
+        // -> Replace the value with the new one
+        data.value = edge_value;
+        // replace, it's bigger
+
+        // Remember the new parent node
+        data.parent = parent;
+      } else
+        // If the node was found but the value is higher or equal
+        // -> Don't use this new leg
+        return;
+    }
 
-  void SetPredecessor(const Node &node, const Node &parent) {
-    // Try to find the given node in the node_parent_map
-    auto result = node_parents.insert(std::make_pair(node, parent));
-    if (!result.second)
-      // If the node was found
-      // -> Replace the according parent node with the new one
-      result.first->second = parent;
+    q.push(NodeValue(edge_value, result.first));
   }
 };
 
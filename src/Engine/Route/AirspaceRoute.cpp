@@ -28,6 +28,17 @@
 #include "Airspace/Predicate/AirspacePredicate.hpp"
 #include "Geo/Flat/FlatRay.hpp"
 
+/**
+ * The margin around the route corridor which is loaded into the
+ * corridor cache [m].
+ */
+static constexpr double CORRIDOR_MARGIN = 10000;
+
+/**
+ * The margin of the corridor cache's height band [m].
+ */
+static constexpr int CORRIDOR_HEIGHT_MARGIN = 500;
+
 // Airspace query helpers
 
 /**
@@ -185,52 +196,109 @@ AirspaceRoute::AirspaceRoute():m_airspaces(false)
   Reset();
 }
 
-AirspaceRoute::~AirspaceRoute()
-{
-  // clean up, we dont need the clearances any more
-  m_airspaces.ClearClearances();
-}
+AirspaceRoute::~AirspaceRoute() {}
 
 void
 AirspaceRoute::Reset()
 {
   RoutePlanner::Reset();
-  m_airspaces.ClearClearances();
   m_airspaces.Clear();
+  corridor.valid = false;
+  corridor.airspaces.clear();
+  clearances.Clear();
+}
+
+bool
+AirspaceRoute::Corridor::Contains(const Airspaces &master,
+                                  unsigned _condition_serial,
+                                  const FlatBoundingBox &_box,
+                                  int _h_min, int _h_max) const
+{
+  return valid && master.GetSerial() == master_serial &&
+    _condition_serial == condition_serial &&
+    box.IsInside(_box.GetTopLeft()) && box.IsInside(_box.GetBottomRight()) &&
+    _h_min >= h_min && _h_max <= h_max;
 }
 
 void
 AirspaceRoute::Synchronise(const Airspaces &master,
                            const AirspacePredicate &_condition,
+                           const unsigned condition_serial,
                            const AGeoPoint &origin,
                            const AGeoPoint &destination)
 {
-  // @todo: also synchronise with AirspaceWarningManager to filter out items that are
-  // acknowledged.
   h_min = std::min((int)origin.altitude, std::min((int)destination.altitude, h_min));
   h_max = std::max((int)origin.altitude, std::max((int)destination.altitude, h_max));
 
-  // @todo: have margin for h_max to allow for climb
-  AirspacePredicateHeightRangeExcludeTwo h_condition(h_min, h_max, origin, destination);
+  const GeoPoint center = origin.Middle(destination);
+  const double range = 0.5 * origin.Distance(destination);
+  const FlatBoundingBox box = master.GetProjection().ProjectSquare(center,
+                                                                   range);
+
+  if (master.GetSerial() != clearances_serial) {
+    /* the airspaces may have been modified or deleted */
+    clearances.Clear();
+    clearances_serial = master.GetSerial();
+  }
+
+  if (!corridor.Contains(master, condition_serial, box, h_min, h_max)) {
+    /* query the master database with a margin, so the following
+       calls can be served from the cache */
+    corridor.valid = true;
+    corridor.master_serial = master.GetSerial();
+    corridor.condition_serial = condition_serial;
+    corridor.box = master.GetProjection().ProjectSquare(center,
+                                                        range + CORRIDOR_MARGIN);
+    corridor.h_min = h_min - CORRIDOR_HEIGHT_MARGIN;
+    corridor.h_max = h_max + CORRIDOR_HEIGHT_MARGIN;
+
+    // @todo: have margin for h_max to allow for climb
+    const AirspacePredicateHeightRange h_condition(corridor.h_min,
+                                                   corridor.h_max);
+
+    corridor.airspaces.clear();
+    for (const auto &i : master.QueryWithinRange(center,
+                                                 range + CORRIDOR_MARGIN))
+      if (h_condition(i.GetAirspace()) && _condition(i.GetAirspace()))
+        corridor.airspaces.push_back(i);
+  }
+
+  /* this selects the same airspaces as Airspaces::QueryWithinRange()
+     with the exact height range, because the corridor contains all
+     airspaces intersecting the box */
+  const AirspacePredicateHeightRangeExcludeTwo h_condition(h_min, h_max,
+                                                           origin,
+                                                           destination);
 
-  const auto and_condition = MakeAndPredicate(h_condition,
-                                              AirspacePredicateRef(_condition));
-  const auto predicate = WrapAirspacePredicate(and_condition);
+  AirspacesInterface::AirspaceVector contents;
+  for (const auto &i : corridor.airspaces)
+    if (box.Overlaps(i) && h_condition(i.GetAirspace()))
+      contents.push_back(i);
 
-  if (m_airspaces.SynchroniseInRange(master, origin.Middle(destination),
-                                     0.5 * origin.Distance(destination),
-                                     predicate)) {
+  if (m_airspaces.Synchronise(master, contents)) {
     if (!m_airspaces.IsEmpty())
       dirty = true;
   }
 }
 
+const SearchPointVector &
+AirspaceRoute::GetClearance(const AbstractAirspace &airspace)
+{
+  auto i = clearances.Find(&airspace);
+  if (i == clearances.NOT_FOUND) {
+    i = clearances.Insert(&airspace, SearchPointVector()).first;
+    clearances[i].value =
+      airspace.CalculateClearance(m_airspaces.GetProjection());
+  }
+
+  return clearances[i].value;
+}
+
 void
 AirspaceRoute::AddNearbyAirspace(const RouteAirspaceIntersection &inx,
                                  const RouteLink &e)
 {
-  const SearchPointVector &fat =
-    inx.airspace->GetClearance(m_airspaces.GetProjection());
+  const SearchPointVector &fat = GetClearance(*inx.airspace);
   const ClearingPair p = GetPairs(fat, e.first, e.second);
   const ClearingPair pb = GetBackupPairs(fat, e.first, inx.point);
 
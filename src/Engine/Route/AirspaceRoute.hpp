@@ -25,10 +25,49 @@
 
 #include "RoutePlanner.hpp"
 #include "Airspace/Airspaces.hpp"
+#include "Geo/Flat/FlatBoundingBox.hpp"
+#include "Util/OpenHashMap.hpp"
+#include "Util/Serial.hpp"
 
 class AirspaceRoute : public RoutePlanner {
   Airspaces m_airspaces;
 
+  /**
+   * Airspaces of the master database which pass the caller's
+   * predicate, within a corridor which is wider (and a height band
+   * which is higher) than needed by one Synchronise() call.  As long
+   * as the route stays inside, Synchronise() does not need to query
+   * the master database and evaluate the predicate again.
+   */
+  struct Corridor {
+    bool valid = false;
+
+    Serial master_serial;
+    unsigned condition_serial;
+
+    /**
+     * The corridor in the master's projection.
+     */
+    FlatBoundingBox box;
+
+    int h_min, h_max;
+
+    AirspacesInterface::AirspaceVector airspaces;
+
+    gcc_pure
+    bool Contains(const Airspaces &master, unsigned condition_serial,
+                  const FlatBoundingBox &box, int h_min, int h_max) const;
+  } corridor;
+
+  /**
+   * The clearance polygons (see AbstractAirspace::CalculateClearance())
+   * which were calculated so far.  They are kept until the master
+   * database changes (see #clearances_serial), even if the airspace
+   * leaves the corridor.
+   */
+  OpenHashMap<const AbstractAirspace *, SearchPointVector> clearances;
+  Serial clearances_serial;
+
   struct RouteAirspaceIntersection {
     const AbstractAirspace *airspace;
 
@@ -50,7 +89,16 @@ public:
   AirspaceRoute();
   virtual ~AirspaceRoute();
 
+  /**
+   * Select the airspaces relevant for a route from the master
+   * database.
+   *
+   * @param condition_serial a number which identifies the state of
+   * the #condition; whenever the predicate may return a different
+   * result, this number must be different, too
+   */
   void Synchronise(const Airspaces &master, const AirspacePredicate &condition,
+                   unsigned condition_serial,
                    const AGeoPoint &origin,
                    const AGeoPoint &destination);
 
@@ -74,6 +122,11 @@ private:
   void AddNearbyAirspace(const RouteAirspaceIntersection &inx,
                          const RouteLink &e);
 
+  /**
+   * Returns the (cached) clearance polygon of the specified airspace.
+   */
+  const SearchPointVector &GetClearance(const AbstractAirspace &airspace);
+
   RouteAirspaceIntersection FirstIntersecting(const RouteLink &e) const;
 
   const AbstractAirspace *InsideOthers(const AGeoPoint &origin) const;
@@ -34,6 +34,11 @@
 #define REACH_MIN_STEP 25
 #define REACH_MAX_VERTICES 2000
 
+/* child fans of the previous calculation are reused if their origin
+   is within this distance [m] of the new origin, and can be reached
+   from there (see TakePrevious()) */
+#define REACH_REUSE_DISTANCE 250
+
 static bool
 AlmostTheSame(const FlatGeoPoint p1, const FlatGeoPoint p2)
 {
@@ -63,24 +68,58 @@ FlatTriangleFanTree::CalcBB()
   }
 }
 
+void
+FlatTriangleFanTree::Reproject(const FlatProjection &from,
+                               const FlatProjection &to)
+{
+  for (auto &v : vs)
+    v = to.ProjectInteger(from.Unproject(v));
+
+  for (auto &child : children)
+    child.Reproject(from, to);
+}
+
 void
 FlatTriangleFanTree::FillReach(const AFlatGeoPoint &origin,
-                               ReachFanParms &parms)
+                               ReachFanParms &parms,
+                               ReachFanExecutor *executor, bool reuse)
 {
   gaps_filled = false;
 
+  assert(previous.empty());
+  if (reuse) {
+    /* recalculate this fan, and offer the old children to
+       FindGaps() */
+    FlatTriangleFan::Clear();
+    previous.swap(children);
+  }
+
   FillReach(origin, 0, ROUTEPOLAR_POINTS, parms);
 
   for (parms.set_depth = 0; parms.set_depth < REACH_MAX_DEPTH;
       ++parms.set_depth)
-    if (!FillDepth(origin, parms))
+    if (!(executor != nullptr
+          ? FillDepth(origin, parms, *executor)
+          : FillDepth(origin, parms)))
       // stop searching
       break;
 
+  if (reuse)
+    ClearPrevious();
+
   // this boundingbox update visits the tree recursively
   CalcBB();
 }
 
+void
+FlatTriangleFanTree::ClearPrevious()
+{
+  previous.clear();
+
+  for (auto &child : children)
+    child.ClearPrevious();
+}
+
 void
 FlatTriangleFanTree::DummyReach(const AFlatGeoPoint &ao)
 {
@@ -113,6 +152,64 @@ FlatTriangleFanTree::FillDepth(const AFlatGeoPoint &origin,
   return true;
 }
 
+void
+FlatTriangleFanTree::CollectDepth(unsigned char set_depth,
+                                  std::vector<FlatTriangleFanTree *> &result)
+{
+  if (depth == set_depth) {
+    if (!gaps_filled)
+      result.push_back(this);
+  } else if (depth < set_depth) {
+    for (auto &child : children)
+      child.CollectDepth(set_depth, result);
+  }
+}
+
+bool
+FlatTriangleFanTree::FillDepth(const AFlatGeoPoint &origin,
+                               ReachFanParms &parms,
+                               ReachFanExecutor &executor)
+{
+  std::vector<FlatTriangleFanTree *> fans;
+  CollectDepth(parms.set_depth, fans);
+  if (fans.empty())
+    return true;
+
+  /* the fans of one depth are independent of each other: only the
+     limits checked below depend on the children found so far, and
+     these are applied during the serial merge */
+  std::vector<std::vector<FlatTriangleFanTree>> results(fans.size());
+  const ReachFanParms &const_parms = parms;
+  executor.ForEach(fans.size(), [&](unsigned i){
+      fans[i]->FindGaps(origin, const_parms, results[i]);
+    });
+
+  for (unsigned i = 0; i < fans.size(); ++i) {
+    FlatTriangleFanTree &fan = *fans[i];
+    fan.gaps_filled = true;
+
+    if (parms.vertex_counter > REACH_MAX_VERTICES)
+      return false;
+    if (parms.fan_counter > REACH_MAX_FANS)
+      return false;
+
+    fan.AddChildren(std::move(results[i]), parms);
+  }
+
+  return true;
+}
+
+void
+FlatTriangleFanTree::AddChildren(std::vector<FlatTriangleFanTree> &&new_children,
+                                 ReachFanParms &parms)
+{
+  for (auto &child : new_children) {
+    parms.vertex_counter += child.vs.size();
+    parms.fan_counter++;
+    children.emplace_back(std::move(child));
+  }
+}
+
 bool
 FlatTriangleFanTree::FillReach(const AFlatGeoPoint &origin, const int index_low,
                                const int index_high,
@@ -120,6 +217,8 @@ FlatTriangleFanTree::FillReach(const AFlatGeoPoint &origin, const int index_low,
 {
   const GeoPoint geo_origin = parms.projection.Unproject(origin);
   height = origin.altitude;
+  polar_low = index_low;
+  polar_high = index_high;
 
   // fill vector
   if (!IsRoot()) {
@@ -148,6 +247,16 @@ FlatTriangleFanTree::FillReach(const AFlatGeoPoint &origin, const int index_low,
 
 void
 FlatTriangleFanTree::FillGaps(const AFlatGeoPoint &origin, ReachFanParms &parms)
+{
+  std::vector<FlatTriangleFanTree> new_children;
+  FindGaps(origin, parms, new_children);
+  AddChildren(std::move(new_children), parms);
+}
+
+void
+FlatTriangleFanTree::FindGaps(const AFlatGeoPoint &origin,
+                              const ReachFanParms &parms,
+                              std::vector<FlatTriangleFanTree> &result)
 {
   // worth checking for gaps?
   if (vs.size() > 2 && parms.rpolars.IsTurningReachEnabled()) {
@@ -162,7 +271,7 @@ FlatTriangleFanTree::FillGaps(const AFlatGeoPoint &origin, ReachFanParms &parms)
 
       const RouteLink e(RoutePoint(*x, 0), origin, parms.projection);
       // check if children need to be added
-      CheckGap(origin, e_last, e, parms);
+      CheckGap(origin, e_last, e, parms, result);
 
       e_last = e;
     }
@@ -178,17 +287,31 @@ FlatTriangleFanTree::UpdateTerrainBase(const FlatGeoPoint o,
     return;
   }
 
-  for (const auto &x : vs) {
-    const FlatGeoPoint av = (o + x) * 0.5;
-    const GeoPoint p = parms.projection.Unproject(av);
-    const auto h = parms.terrain->GetHeight(p);
-
-    if (h.IsWater())
-      /* water: assume 0m MSL */
-      parms.terrain_counter++;
-    else if (!h.IsInvalid()) {
-      parms.terrain_counter++;
-      parms.terrain_base += h.GetValue();
+  /* look up the heights in chunks, to share the projection and tile
+     lookups */
+  constexpr unsigned CHUNK = 32;
+  GeoPoint points[CHUNK];
+  TerrainHeight heights[CHUNK];
+
+  for (auto x = vs.cbegin(), end = vs.cend(); x != end;) {
+    unsigned n = 0;
+    for (; x != end && n < CHUNK; ++x, ++n) {
+      const FlatGeoPoint av = (o + *x) * 0.5;
+      points[n] = parms.projection.Unproject(av);
+    }
+
+    parms.terrain->GetHeights(points, heights, n);
+
+    for (unsigned i = 0; i < n; ++i) {
+      const auto h = heights[i];
+
+      if (h.IsWater())
+        /* water: assume 0m MSL */
+        parms.terrain_counter++;
+      else if (!h.IsInvalid()) {
+        parms.terrain_counter++;
+        parms.terrain_base += h.GetValue();
+      }
     }
   }
 
@@ -198,7 +321,8 @@ FlatTriangleFanTree::UpdateTerrainBase(const FlatGeoPoint o,
 
 bool
 FlatTriangleFanTree::CheckGap(const AFlatGeoPoint &n, const RouteLink &e_1,
-                              const RouteLink &e_2, ReachFanParms &parms)
+                              const RouteLink &e_2, const ReachFanParms &parms,
+                              std::vector<FlatTriangleFanTree> &result)
 {
   const bool side = (e_1.d > e_2.d);
   const RouteLink &e_long = (side ? e_1 : e_2);
@@ -227,6 +351,10 @@ FlatTriangleFanTree::CheckGap(const AFlatGeoPoint &n, const RouteLink &e_1,
     index_right = e_long.polar_index + REACH_SWEEP;
   }
 
+  const int tolerance = previous.empty()
+    ? 0
+    : int(REACH_REUSE_DISTANCE / parms.projection.GetApproximateScale());
+
   for (auto f = f0; f < 0.9; f += 0.1) {
     // find corner point
     const FlatGeoPoint px = (dp * f + FlatGeoPoint(n));
@@ -237,10 +365,10 @@ FlatTriangleFanTree::CheckGap(const AFlatGeoPoint &n, const RouteLink &e_1,
     const AFlatGeoPoint x(px, h);
 
     FlatTriangleFanTree child(depth + 1);
-    if (child.FillReach(x, index_left, index_right, parms)) {
-      parms.vertex_counter += child.vs.size();
-      parms.fan_counter++;
-      children.emplace_back(std::move(child));
+    if (child.TakePrevious(x, index_left, index_right,
+                           tolerance, parms, previous) ||
+        child.FillReach(x, index_left, index_right, parms)) {
+      result.emplace_back(std::move(child));
       return true;
     }
   }
@@ -248,6 +376,72 @@ FlatTriangleFanTree::CheckGap(const AFlatGeoPoint &n, const RouteLink &e_1,
   return false;
 }
 
+/**
+ * Can the old fan origin #previous be reached from the new fan origin
+ * with at least its old height?  If yes, everything inside the old
+ * fan is reachable via #previous, and its vertices and arrival
+ * heights are not optimistic for the new origin.
+ */
+gcc_pure
+static bool
+CanReachPrevious(const AFlatGeoPoint &origin, const AFlatGeoPoint &previous,
+                 const ReachFanParms &parms)
+{
+  if (FlatGeoPoint(origin) == FlatGeoPoint(previous))
+    return previous.altitude <= origin.altitude;
+
+  if (parms.rpolars.CalcGlideArrival(origin, previous,
+                                     parms.projection) < previous.altitude)
+    return false;
+
+  if (parms.terrain == nullptr)
+    return true;
+
+  const AGeoPoint a(parms.projection.Unproject(origin), origin.altitude);
+  const AGeoPoint b(parms.projection.Unproject(previous), previous.altitude);
+  return !parms.rpolars.Intersection(a, b, parms.terrain,
+                                     parms.projection).IsValid();
+}
+
+bool
+FlatTriangleFanTree::TakePrevious(const AFlatGeoPoint &origin,
+                                  int index_low, int index_high,
+                                  int tolerance,
+                                  const ReachFanParms &parms,
+                                  LeafVector &candidates)
+{
+  assert(IsEmpty());
+  assert(previous.empty());
+
+  for (auto &candidate : candidates) {
+    /* candidates which have already been taken are empty; they are
+       not erased here, because this may run in a worker thread, and
+       the list allocator is not thread-safe */
+    if (candidate.IsEmpty() ||
+        candidate.polar_low != index_low ||
+        candidate.polar_high != index_high)
+      continue;
+
+    const FlatGeoPoint k = candidate.vs.front() - FlatGeoPoint(origin);
+    if (std::max(abs(k.x), abs(k.y)) > tolerance ||
+        candidate.height > origin.altitude)
+      continue;
+
+    if (!CanReachPrevious(origin, candidate.GetOrigin(), parms))
+      continue;
+
+    vs = std::move(candidate.vs);
+    candidate.vs.clear();
+    height = candidate.height;
+    polar_low = index_low;
+    polar_high = index_high;
+    previous.swap(candidate.children);
+    return true;
+  }
+
+  return false;
+}
+
 int
 FlatTriangleFanTree::DirectArrival(FlatGeoPoint dest,
                                    const ReachFanParms &parms) const
@@ -288,6 +482,48 @@ FlatTriangleFanTree::FindPositiveArrival(const FlatGeoPoint n,
   return retval;
 }
 
+void
+FlatTriangleFanTree::FindPositiveArrivals(ArrivalQuery *queries,
+                                          std::vector<unsigned> &indices,
+                                          const size_t begin,
+                                          const ReachFanParms &parms) const
+{
+  const size_t end = indices.size();
+
+  for (size_t i = begin; i < end; ++i) {
+    const unsigned j = indices[i];
+    ArrivalQuery &query = queries[j];
+
+    if (height < query.arrival_height)
+      continue; // can't possibly improve
+
+    if (!bb_children.IsInside(query.point))
+      continue; // not in scope
+
+    if (IsInside(query.point)) { // found in this segment
+      const int h = parms.rpolars.CalcGlideArrival(GetOrigin(), query.point,
+                                                   parms.projection);
+      if (h > query.arrival_height) {
+        query.arrival_height = h;
+        query.found = true;
+      }
+
+      /* stop here; it is impossible for a child to find a positive
+         arrival height if this one didn't */
+      continue;
+    }
+
+    /* let the children check this one */
+    indices.push_back(j);
+  }
+
+  if (indices.size() > end)
+    for (const auto &child : children)
+      child.FindPositiveArrivals(queries, indices, end, parms);
+
+  indices.resize(end);
+}
+
 void
 FlatTriangleFanTree::AcceptInRange(const FlatBoundingBox &bb,
                                    FlatTriangleFanVisitor &visitor) const
@@ -28,6 +28,8 @@
 #include "FlatTriangleFan.hpp"
 
 #include <list>
+#include <vector>
+#include <functional>
 
 class FlatProjection;
 struct GeoPoint;
@@ -42,6 +44,21 @@ public:
                         ConstBuffer<FlatGeoPoint> fan) = 0;
 };
 
+/**
+ * Runs independent parts of the reach calculation concurrently.  The
+ * engine does not depend on a thread library; the application may
+ * implement this interface, e.g. with a thread pool.
+ */
+class ReachFanExecutor {
+public:
+  /**
+   * Invoke f(i) for each i in [0, n), in any order and possibly
+   * concurrently, and return after all invocations have finished.
+   */
+  virtual void ForEach(unsigned n,
+                       const std::function<void(unsigned)> &f) = 0;
+};
+
 class FlatTriangleFanTree: public FlatTriangleFan
 {
 public:
@@ -53,6 +70,20 @@ private:
 
   FlatBoundingBox bb_children;
   LeafVector children;
+
+  /**
+   * The child fans of the previous calculation, which may be reused
+   * by FindGaps() instead of being calculated again.  This list is
+   * only used during FillReach(), and fans which have been reused
+   * are left empty.
+   */
+  LeafVector previous;
+
+  /**
+   * The range of polar indices this (child) fan was filled with.
+   */
+  int polar_low, polar_high;
+
   const unsigned char depth;
   bool gaps_filled;
 
@@ -60,7 +91,8 @@ public:
   friend class PrintHelper;
 
   FlatTriangleFanTree(const unsigned char _depth = 0)
-    :depth(_depth),
+    :polar_low(0), polar_high(0),
+     depth(_depth),
      gaps_filled(false) {}
 
   bool IsRoot() const {
@@ -74,12 +106,28 @@ public:
 
   void CalcBB();
 
+  /**
+   * Convert all vertices of the tree to another projection.
+   */
+  void Reproject(const FlatProjection &from, const FlatProjection &to);
+
   gcc_pure
   bool IsInside(FlatGeoPoint p) const {
     return FlatTriangleFan::IsInside(p, IsRoot());
   }
 
-  void FillReach(const AFlatGeoPoint &origin, ReachFanParms &parms);
+  /**
+   * @param executor if not nullptr, then the child fans of each depth
+   * are searched concurrently; the resulting tree is identical to the
+   * one built serially
+   * @param reuse if true, then the child fans of the existing tree
+   * are reused where the new tree would have a child fan with the
+   * same shape at almost the same location; this is much cheaper
+   * than calculating all fans from scratch, and is meant for small
+   * changes of the origin
+   */
+  void FillReach(const AFlatGeoPoint &origin, ReachFanParms &parms,
+                 ReachFanExecutor *executor=nullptr, bool reuse=false);
   void DummyReach(const AFlatGeoPoint &origin);
 
   /**
@@ -101,15 +149,66 @@ public:
                  const ReachFanParms &parms);
 
   bool FillDepth(const AFlatGeoPoint &origin, ReachFanParms &parms);
+
+  /**
+   * Like FillDepth(), but search the gaps of all fans of the current
+   * depth concurrently, and then add the new children in the order
+   * FillDepth() would have added them.
+   */
+  bool FillDepth(const AFlatGeoPoint &origin, ReachFanParms &parms,
+                 ReachFanExecutor &executor);
+
   void FillGaps(const AFlatGeoPoint &origin, ReachFanParms &parms);
 
+  /**
+   * Search the gaps of this fan for new child fans.  This method
+   * modifies only the #previous list of this fan, and does not
+   * modify the counters in #ReachFanParms; it may therefore be called
+   * for different fans from several threads at a time.
+   */
+  void FindGaps(const AFlatGeoPoint &origin, const ReachFanParms &parms,
+                std::vector<FlatTriangleFanTree> &result);
+
   bool CheckGap(const AFlatGeoPoint &n, const RouteLink &e_1,
-                const RouteLink &e_2, ReachFanParms &parms);
+                const RouteLink &e_2, const ReachFanParms &parms,
+                std::vector<FlatTriangleFanTree> &result);
 
   bool FindPositiveArrival(FlatGeoPoint n,
                            const ReachFanParms &parms,
                            int &arrival_height) const;
 
+  /**
+   * One destination of FindPositiveArrivals().
+   */
+  struct ArrivalQuery {
+    FlatGeoPoint point;
+
+    /**
+     * The best arrival height found so far.  Initialise with the
+     * minimum arrival height which is of interest.
+     */
+    int arrival_height;
+
+    /**
+     * Set to true if #arrival_height was improved.
+     */
+    bool found;
+  };
+
+  /**
+   * Like FindPositiveArrival(), but for many destinations in one
+   * traversal of the tree.  The results are the same as calling
+   * FindPositiveArrival() for each destination.
+   *
+   * @param indices the indices (into #queries) of the destinations
+   * to be checked, starting at the specified position; the vector is
+   * used as scratch space by the recursion, and its size is restored
+   * before returning
+   */
+  void FindPositiveArrivals(ArrivalQuery *queries,
+                            std::vector<unsigned> &indices, size_t begin,
+                            const ReachFanParms &parms) const;
+
   void AcceptInRange(const FlatBoundingBox &bb,
                      FlatTriangleFanVisitor &visitor) const;
 
@@ -117,6 +216,38 @@ public:
 
   gcc_pure
   int DirectArrival(FlatGeoPoint dest, const ReachFanParms &parms) const;
+
+private:
+  /**
+   * Append all fans of the specified depth whose gaps have not been
+   * filled yet to the list, in the order FillDepth() visits them.
+   */
+  void CollectDepth(unsigned char set_depth,
+                    std::vector<FlatTriangleFanTree *> &result);
+
+  void AddChildren(std::vector<FlatTriangleFanTree> &&new_children,
+                   ReachFanParms &parms);
+
+  /**
+   * Take over a fan from the list of candidates (usually the
+   * #previous list of the parent) which was filled with the same
+   * polar index range from an origin within the given tolerance.
+   * A fan is only taken over if its origin can be reached from the
+   * new origin with at least its old height, i.e. if it is never
+   * optimistic.  Its children become the #previous list of this
+   * object.
+   *
+   * @return true if a fan has been taken over
+   */
+  bool TakePrevious(const AFlatGeoPoint &origin,
+                    int index_low, int index_high,
+                    int tolerance, const ReachFanParms &parms,
+                    LeafVector &candidates);
+
+  /**
+   * Discard the #previous lists of the whole tree.
+   */
+  void ClearPrevious();
 };
 
 #endif
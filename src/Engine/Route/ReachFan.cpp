@@ -25,8 +25,18 @@
 #include "ReachFanParms.hpp"
 #include "ReachResult.hpp"
 
+#include <algorithm>
+#include <vector>
+
 static constexpr int MIN_FLOOR_CLEARANCE = 100;
 
+/**
+ * Child fans keep the arrival heights they were calculated with, so
+ * they are pessimistic after a climb.  Calculate from scratch when
+ * the origin has climbed more than this [m].
+ */
+static constexpr int MAX_REUSE_CLIMB = 20;
+
 void
 ReachFan::Reset()
 {
@@ -34,14 +44,35 @@ ReachFan::Reset()
   terrain_base = 0;
 }
 
+bool
+ReachFan::IsReusable() const
+{
+  return !root.IsEmpty() && !root.IsDummy() && projection.IsValid();
+}
+
 bool
 ReachFan::Solve(const AGeoPoint origin, const RoutePolars &rpolars,
-                const RasterMap* terrain, const bool do_solve)
+                const RasterMap* terrain, const bool do_solve,
+                ReachFanExecutor *executor, bool incremental)
 {
-  Reset();
+  const bool reuse = incremental && do_solve && IsReusable() &&
+    origin.altitude <= reuse_altitude + MAX_REUSE_CLIMB;
+  if (reuse) {
+    /* keep the tree; FillReach() will reuse the child fans which
+       are still valid */
+    terrain_base = 0;
+    reuse_altitude = std::min(reuse_altitude, origin.altitude);
+
+    const FlatProjection old_projection = projection;
+    projection = FlatProjection(origin);
+    root.Reproject(old_projection, projection);
+  } else {
+    Reset();
+    reuse_altitude = origin.altitude;
 
-  // initialise projection
-  projection = FlatProjection(origin);
+    // initialise projection
+    projection = FlatProjection(origin);
+  }
 
   const auto h = terrain
     ? terrain->GetHeight(origin)
@@ -56,13 +87,14 @@ ReachFan::Solve(const AGeoPoint origin, const RoutePolars &rpolars,
   if ((!h.IsInvalid() &&
       (origin.altitude <= h2 + rpolars.GetSafetyHeight()))
       || (origin.altitude < MIN_FLOOR_CLEARANCE + rpolars.GetFloor() + rpolars.GetSafetyHeight())) {
+    Reset();
     terrain_base = h2;
     root.DummyReach(ao);
     return false;
   }
 
   if (do_solve)
-    root.FillReach(ao, parms);
+    root.FillReach(ao, parms, executor, reuse);
   else
     root.DummyReach(ao);
 
@@ -116,6 +148,69 @@ ReachFan::FindPositiveArrival(const AGeoPoint dest, const RoutePolars &rpolars,
   return true;
 }
 
+bool
+ReachFan::FindPositiveArrivals(const AGeoPoint *destinations,
+                               ReachResult *results, unsigned n,
+                               const RoutePolars &rpolars) const
+{
+  if (root.IsEmpty())
+    return false;
+
+  const ReachFanParms parms(rpolars, projection, terrain_base);
+
+  std::vector<FlatTriangleFanTree::ArrivalQuery> queries(n);
+  std::vector<unsigned> indices;
+  indices.reserve(n);
+
+  for (unsigned i = 0; i < n; ++i) {
+    const AGeoPoint &dest = destinations[i];
+    ReachResult &result_r = results[i];
+    auto &query = queries[i];
+
+    query.point = projection.ProjectInteger(dest);
+
+    result_r.Clear();
+
+    // first calculate direct (terrain-independent height)
+    result_r.direct = root.DirectArrival(query.point, parms);
+
+    if (root.IsDummy())
+      /* terrain reach is not available, stop here */
+      continue;
+
+    // if can't reach even with no terrain, exit early
+    if (std::min(root.GetHeight(), result_r.direct) < dest.altitude) {
+      result_r.terrain = result_r.direct;
+      result_r.terrain_valid = ReachResult::Validity::UNREACHABLE;
+      continue;
+    }
+
+    query.arrival_height = dest.altitude - 1;
+    query.found = false;
+    indices.push_back(i);
+  }
+
+  if (indices.empty())
+    return true;
+
+  const size_t n_queries = indices.size();
+  root.FindPositiveArrivals(queries.data(), indices, 0, parms);
+  assert(indices.size() == n_queries);
+
+  // now collect the turning solutions
+  for (const unsigned i : indices) {
+    ReachResult &result_r = results[i];
+    const auto &query = queries[i];
+
+    result_r.terrain = query.arrival_height;
+    result_r.terrain_valid = query.found
+      ? ReachResult::Validity::VALID
+      : ReachResult::Validity::UNREACHABLE;
+  }
+
+  return true;
+}
+
 void
 ReachFan::AcceptInRange(const GeoBounds &bounds,
                         FlatTriangleFanVisitor &visitor) const
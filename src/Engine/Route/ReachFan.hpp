@@ -37,8 +37,15 @@ class ReachFan
   FlatTriangleFanTree root;
   int terrain_base;
 
+  /**
+   * The lowest origin altitude since the tree was last calculated
+   * from scratch.  Child fans which are reused may have been
+   * calculated at this altitude.
+   */
+  double reuse_altitude;
+
 public:
-  ReachFan():terrain_base(0) {}
+  ReachFan():terrain_base(0), reuse_altitude(0) {}
 
   friend class PrintHelper;
 
@@ -52,12 +59,42 @@ public:
 
   void Reset();
 
+  /**
+   * @param executor an optional #ReachFanExecutor which searches the
+   * child fans concurrently
+   * @param incremental reuse child fans of the previous solution if
+   * the origin has moved only a little and has not climbed; the
+   * caller must make sure that the glide performance model and the
+   * terrain have not changed significantly since then
+   */
   bool Solve(const AGeoPoint origin, const RoutePolars &rpolars,
-             const RasterMap *terrain, const bool do_solve = true);
+             const RasterMap *terrain, const bool do_solve = true,
+             ReachFanExecutor *executor = nullptr,
+             bool incremental = false);
+
+private:
+  /**
+   * Can the current solution be updated incrementally?
+   */
+  gcc_pure
+  bool IsReusable() const;
+
+public:
 
   bool FindPositiveArrival(const AGeoPoint dest, const RoutePolars &rpolars,
                            ReachResult &result_r) const;
 
+  /**
+   * Like FindPositiveArrival(), but for many destinations at a time;
+   * this traverses the tree of fans only once.
+   *
+   * @return false if no reach has been calculated (and the results
+   * are undefined)
+   */
+  bool FindPositiveArrivals(const AGeoPoint *destinations,
+                            ReachResult *results, unsigned n,
+                            const RoutePolars &rpolars) const;
+
   void AcceptInRange(const GeoBounds &bounds,
                      FlatTriangleFanVisitor &visitor) const;
 
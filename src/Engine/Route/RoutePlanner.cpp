@@ -23,11 +23,27 @@
 #include "RoutePlanner.hpp"
 #include "Terrain/RasterMap.hpp"
 #include "Geo/Flat/FlatProjection.hpp"
+#include "GlideSolvers/GlidePolar.hpp"
+
+#include <algorithm>
+
+#include <math.h>
+#include <stdlib.h>
+
+/* the reach fans are calculated from scratch when one of these
+   changes by more than the given amount since the last full
+   calculation */
+static constexpr double REACH_MAX_MC_DELTA = 0.05; // m/s
+static constexpr double REACH_MAX_LD_RATIO = 0.01;
+static constexpr double REACH_MAX_WIND_DELTA = 1; // m/s
+static constexpr int REACH_MAX_WORKING_DELTA = 20; // m
 
 RoutePlanner::RoutePlanner()
-  :terrain(NULL), planner(0),
-   unique_links(50000),
-   reach_polar_mode(RoutePlannerConfig::Polar::TASK)
+  :terrain(NULL), reach_executor(nullptr), incremental_reach(false),
+   planner(0),
+   unique_links(4096),
+   reach_polar_mode(RoutePlannerConfig::Polar::TASK),
+   reach_inputs(), reach_terrain_inputs(), reach_working_inputs()
 {
   Reset();
 }
@@ -37,6 +53,7 @@ RoutePlanner::ClearReach()
 {
   reach_terrain.Reset();
   reach_working.Reset();
+  ++reach_terrain_serial;
 }
 
 void
@@ -47,10 +64,12 @@ RoutePlanner::Reset()
   dirty = true;
   solution_route.clear();
   planner.Clear();
-  unique_links.clear();
+  unique_links.Clear();
   h_min = -1;
   h_max = 0;
   search_hull.clear();
+  count_dij = count_unique = count_supressed = count_nodes = 0;
+  count_airspace = count_terrain = 0;
   ClearReach();
 }
 
@@ -62,7 +81,10 @@ RoutePlanner::SolveReachTerrain(const AGeoPoint &origin,
   rpolars_reach.SetConfig(config, origin.altitude, h_ceiling);
   reach_polar_mode = config.reach_polar_mode;
 
-  return reach_terrain.Solve(origin, rpolars_reach, terrain, do_solve);
+  const bool incremental = CheckReachInputs(reach_terrain_inputs, config);
+  ++reach_terrain_serial;
+  return reach_terrain.Solve(origin, rpolars_reach, terrain, do_solve,
+                             reach_executor, incremental);
 }
 
 bool
@@ -73,7 +95,57 @@ RoutePlanner::SolveReachWorking(const AGeoPoint &origin,
   rpolars_reach_working.SetConfig(config, origin.altitude, h_ceiling);
   // reach_polar_mode previously set by SolveReachTerrain
 
-  return reach_working.Solve(origin, rpolars_reach_working, terrain, do_solve);
+  const bool incremental = CheckReachInputs(reach_working_inputs, config);
+  return reach_working.Solve(origin, rpolars_reach_working, terrain, do_solve,
+                             reach_executor, incremental);
+}
+
+static bool
+IsSimilarLD(double a, double b)
+{
+  return fabs(a - b) <= REACH_MAX_LD_RATIO * std::max(a, b);
+}
+
+static bool
+IsSimilarWind(const SpeedVector a, const SpeedVector b)
+{
+  const auto sc_a = a.bearing.SinCos(), sc_b = b.bearing.SinCos();
+  const double dx = a.norm * sc_a.first - b.norm * sc_b.first;
+  const double dy = a.norm * sc_a.second - b.norm * sc_b.second;
+  return hypot(dx, dy) <= REACH_MAX_WIND_DELTA;
+}
+
+bool
+RoutePlanner::ReachInputs::IsSimilar(const ReachInputs &other) const
+{
+  return terrain == other.terrain && terrain_serial == other.terrain_serial &&
+    mode == other.mode && polar_mode == other.polar_mode &&
+    safety_height == other.safety_height &&
+    fabs(mc - other.mc) <= REACH_MAX_MC_DELTA &&
+    fabs(working_mc - other.working_mc) <= REACH_MAX_MC_DELTA &&
+    IsSimilarLD(best_ld, other.best_ld) &&
+    IsSimilarLD(working_best_ld, other.working_best_ld) &&
+    IsSimilarWind(wind, other.wind) &&
+    abs(height_min_working - other.height_min_working) <= REACH_MAX_WORKING_DELTA;
+}
+
+bool
+RoutePlanner::CheckReachInputs(ReachInputs &last,
+                               const RoutePlannerConfig &config)
+{
+  ReachInputs current = reach_inputs;
+  current.safety_height = config.safety_height_terrain;
+  current.mode = config.reach_calc_mode;
+  current.polar_mode = config.reach_polar_mode;
+  current.terrain = terrain;
+  if (terrain != nullptr)
+    current.terrain_serial = terrain->GetSerial();
+
+  if (incremental_reach && last.IsSimilar(current))
+    return true;
+
+  last = current;
+  return false;
 }
 
 bool
@@ -165,14 +237,19 @@ RoutePlanner::Solve(const AGeoPoint &origin, const AGeoPoint &destination,
     if (IsSetUnique(e))
       AddEdges(e);
 
-    while (!links.empty()) {
-      AddEdges(links.front());
-      links.pop();
+    /* AddEdges() may append new candidates, which are processed
+       in the same loop; the vector keeps its memory for the next
+       iteration */
+    for (RouteLinkQueue::size_type i = 0; i < links.size(); ++i) {
+      const RouteLink link = links[i];
+      AddEdges(link);
     }
+    links.clear();
 
   }
 
-  count_unique = unique_links.size();
+  count_unique = unique_links.GetSize();
+  count_nodes = planner.GetNodeCount();
 
   if (retval) {
     // correct solution for rounding
@@ -193,7 +270,7 @@ RoutePlanner::Solve(const AGeoPoint &origin, const AGeoPoint &destination,
   }
 
   planner.Clear();
-  unique_links.clear();
+  unique_links.Clear();
   // m_search_hull.clear();
   return retval;
 }
@@ -289,7 +366,7 @@ RoutePlanner::LinkCleared(const RouteLink &e)
 bool
 RoutePlanner::IsSetUnique(const RouteLinkBase &e)
 {
-  const bool inserted = unique_links.insert(e).second;
+  const bool inserted = unique_links.Insert(e);
   if (inserted)
     return true;
 
@@ -308,7 +385,7 @@ RoutePlanner::AddCandidate(const RouteLinkBase& e)
   const RouteLink c_link =
       rpolars_route.GenerateIntermediate(e.first, e.second, projection);
 
-  links.push(c_link);
+  links.push_back(c_link);
 }
 
 void
@@ -317,7 +394,7 @@ RoutePlanner::AddCandidate(const RouteLink &e)
   if (!IsSetUnique(e))
     return;
 
-  links.push(e);
+  links.push_back(e);
 }
 
 void
@@ -383,18 +460,32 @@ RoutePlanner::UpdatePolar(const GlideSettings &settings,
                           const int height_min_working)
 {
   rpolars_route.SetConfig(config);
-  rpolars_route.Initialise(settings, task_polar, wind);
+  rpolars_route.Initialise(polar_cache, settings, task_polar, wind);
   switch (reach_polar_mode) {
   case RoutePlannerConfig::Polar::TASK:
     rpolars_reach = rpolars_route;
     // make copy to avoid waste
     break;
   case RoutePlannerConfig::Polar::SAFETY:
-    rpolars_reach.Initialise(settings, safety_polar, wind);
+    rpolars_reach.Initialise(polar_cache, settings, safety_polar, wind);
     break;
   }
   rpolars_reach_working.SetConfig(config);
-  rpolars_reach_working.Initialise(settings, task_polar, wind, height_min_working);
+  rpolars_reach_working.Initialise(polar_cache, settings, task_polar, wind,
+                                   height_min_working);
+
+  const GlidePolar &reach_polar =
+    reach_polar_mode == RoutePlannerConfig::Polar::SAFETY
+    ? safety_polar
+    : task_polar;
+  reach_inputs.mc = reach_polar.GetMC();
+  reach_inputs.best_ld = reach_polar.IsValid() ? reach_polar.GetBestLD() : 0;
+  reach_inputs.working_mc = task_polar.GetMC();
+  reach_inputs.working_best_ld = task_polar.IsValid()
+    ? task_polar.GetBestLD()
+    : 0;
+  reach_inputs.wind = wind;
+  reach_inputs.height_min_working = height_min_working;
 }
 
 /*
@@ -24,15 +24,19 @@
 #define ROUTE_PLANNER_HPP
 
 #include "RoutePolars.hpp"
+#include "RoutePolarCache.hpp"
 #include "Route.hpp"
 #include "RouteLink.hpp"
 #include "AStar.hpp"
 #include "Geo/Flat/FlatProjection.hpp"
 #include "Geo/SearchPointVector.hpp"
 #include "ReachFan.hpp"
+#include "Geo/SpeedVector.hpp"
+#include "Util/Serial.hpp"
+#include "Util/OpenHashMap.hpp"
 
 #include <utility>
-#include <unordered_set>
+#include <vector>
 
 #include <limits.h>
 
@@ -110,8 +114,14 @@ protected:
   RoutePolars rpolars_reach;
   /** Aircraft performance model for reach to working floor */
   RoutePolars rpolars_reach_working;
+  /** Recently used performance tables for the above */
+  RoutePolarCache polar_cache;
   /** Terrain raster */
   const RasterMap *terrain;
+  /** Optional executor for concurrent reach calculations */
+  ReachFanExecutor *reach_executor;
+  /** Update the reach fans incrementally if possible? */
+  bool incremental_reach;
   /** Minimum height scanned during solution (m) */
   int h_min;
   /** Maxmimum height scanned during solution (m) */
@@ -127,12 +137,18 @@ private:
    */
   SearchPointVector search_hull;
 
-  typedef std::unordered_set<RouteLinkBase, RouteLinkBaseHasher> RouteLinkSet;
+  typedef OpenHashSet<RouteLinkBase, RouteLinkBaseHasher> RouteLinkSet;
 
-  /** Links that have been visited during solution */
+  /**
+   * Links that have been visited during solution.  Its memory is
+   * reused by the next solution.
+   */
   RouteLinkSet unique_links;
-  typedef std::queue< RouteLink> RouteLinkQueue;
-  /** Link candidates to be processed for intersection tests */
+  typedef std::vector<RouteLink> RouteLinkQueue;
+  /**
+   * Link candidates to be processed for intersection tests, in
+   * first-in-first-out order; see Solve()
+   */
   RouteLinkQueue links;
 
   /** Result route found by solve() method */
@@ -146,11 +162,48 @@ private:
   ReachFan reach_terrain;
   ReachFan reach_working;
 
+  /** Incremented each time #reach_terrain is modified */
+  Serial reach_terrain_serial;
+
   RoutePlannerConfig::Polar reach_polar_mode;
 
+  /**
+   * The inputs of a reach calculation.  When they change beyond a
+   * threshold, the reach fans must be calculated from scratch;
+   * smaller changes are tolerated by incremental updates.
+   */
+  struct ReachInputs {
+    /** MacCready setting and best L/D of the reach polar */
+    double mc, best_ld;
+    /** MacCready setting and best L/D of the working reach polar */
+    double working_mc, working_best_ld;
+    SpeedVector wind;
+    int height_min_working;
+
+    double safety_height;
+    RoutePlannerConfig::ReachMode mode;
+    RoutePlannerConfig::Polar polar_mode;
+
+    const RasterMap *terrain;
+    Serial terrain_serial;
+
+    gcc_pure
+    bool IsSimilar(const ReachInputs &other) const;
+  };
+
+  /** The inputs passed to the most recent UpdatePolar() call */
+  ReachInputs reach_inputs;
+
+  /**
+   * The inputs #reach_terrain and #reach_working were last calculated
+   * from scratch with.
+   */
+  ReachInputs reach_terrain_inputs, reach_working_inputs;
+
   mutable unsigned long count_dij;
   mutable unsigned long count_unique;
   mutable unsigned long count_supressed;
+  unsigned count_nodes;
 
 protected:
   RoutePoint astar_goal;
@@ -175,6 +228,27 @@ public:
     terrain = _terrain;
   }
 
+  /**
+   * Set an executor which is used to parallelise the reach
+   * calculation.  The result does not depend on it.
+   *
+   * @param executor the executor or nullptr to calculate serially
+   */
+  void SetReachExecutor(ReachFanExecutor *executor) {
+    reach_executor = executor;
+  }
+
+  /**
+   * Enable incremental reach updates: while the origin moves only a
+   * little between two calls, and the glide performance model, the
+   * wind and the terrain do not change significantly, the child fans
+   * of the previous solution are reused instead of being calculated
+   * again.  This trades a small inaccuracy for speed.
+   */
+  void SetIncrementalReach(bool enable) {
+    incremental_reach = enable;
+  }
+
   bool IsTerrainReachEmpty() const {
     return reach_terrain.IsEmpty();
   }
@@ -239,6 +313,37 @@ public:
     return solution_route;
   }
 
+  /**
+   * Counters describing the effort of the most recent search.  A
+   * Solve() call which finds the problem trivial does not update
+   * them; all are zero after Reset().
+   */
+  struct Statistics {
+    /** Number of distinct nodes reached by the A* search */
+    unsigned nodes;
+
+    /** Number of links added to the A* search */
+    unsigned long links;
+
+    /** Number of distinct links which were examined */
+    unsigned long unique_links;
+
+    /** Number of links which were skipped because they were seen before */
+    unsigned long suppressed_links;
+
+    /** Number of terrain intersection tests */
+    unsigned long terrain_checks;
+
+    /** Number of airspace intersection tests */
+    unsigned long airspace_checks;
+  };
+
+  gcc_pure
+  Statistics GetStatistics() const {
+    return {count_nodes, count_dij, count_unique, count_supressed,
+        count_terrain, count_airspace};
+  }
+
   /**
    * Update aircraft performance model used for path planning.
    *
@@ -287,10 +392,27 @@ public:
     return reach_terrain.FindPositiveArrival(dest, rpolars_reach, result_r);
   }
 
+  /**
+   * Like FindPositiveArrival(), but for many destinations at a time.
+   * This is cheaper than calling FindPositiveArrival() for each
+   * destination, because the reach tree is traversed only once.
+   *
+   * @return true if check was successful
+   */
+  bool FindPositiveArrivals(const AGeoPoint *destinations,
+                            ReachResult *results, unsigned n) const {
+    return reach_terrain.FindPositiveArrivals(destinations, results, n,
+                                              rpolars_reach);
+  }
+
   int GetTerrainBase() const {
     return reach_terrain.GetTerrainBase();
   }
 
+  Serial GetTerrainReachSerial() const {
+    return reach_terrain_serial;
+  }
+
 protected:
   /**
    * Test whether a solution is required or the solution is trivial
@@ -372,6 +494,16 @@ protected:
   bool CheckClearanceTerrain(const RouteLink &e, RoutePoint& inp) const;
 
 private:
+  /**
+   * Decide whether a reach fan may be updated incrementally.  If not,
+   * the current inputs are stored in the specified object.
+   *
+   * @param last the inputs the reach fan was last calculated from
+   * scratch with
+   * @return true if the reach fan may be updated incrementally
+   */
+  bool CheckReachInputs(ReachInputs &last, const RoutePlannerConfig &config);
+
   /**
    * Check a second category of obstacle clearance.  This allows compound
    * obstacle categories by subclasses.
@@ -0,0 +1,102 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "RoutePolarCache.hpp"
+#include "GlideSolvers/GlidePolar.hpp"
+#include "GlideSolvers/GlideSettings.hpp"
+#include "Geo/SpeedVector.hpp"
+
+#include <math.h>
+
+RoutePolarCache::Key::Key(const GlideSettings &settings,
+                          const GlidePolar &polar,
+                          const SpeedVector &wind)
+  :coefficients(polar.GetRealCoefficients()),
+   mc(polar.GetMC()), cruise_efficiency(polar.GetCruiseEfficiency()),
+   v_max(polar.GetVMax()),
+   wind_east(lround(wind.norm * wind.bearing.sin() / WIND_QUANTUM)),
+   wind_north(lround(wind.norm * wind.bearing.cos() / WIND_QUANTUM)),
+   predict_wind_drift(settings.predict_wind_drift) {}
+
+bool
+RoutePolarCache::Key::operator==(const Key &other) const
+{
+  return coefficients.a == other.coefficients.a &&
+    coefficients.b == other.coefficients.b &&
+    coefficients.c == other.coefficients.c &&
+    mc == other.mc && cruise_efficiency == other.cruise_efficiency &&
+    v_max == other.v_max &&
+    wind_east == other.wind_east && wind_north == other.wind_north &&
+    predict_wind_drift == other.predict_wind_drift;
+}
+
+SpeedVector
+RoutePolarCache::Key::GetWind() const
+{
+  if (wind_east == 0 && wind_north == 0)
+    return SpeedVector::Zero();
+
+  return SpeedVector(wind_east * WIND_QUANTUM, wind_north * WIND_QUANTUM);
+}
+
+void
+RoutePolarCache::Get(const GlideSettings &settings, const GlidePolar &polar,
+                     const SpeedVector &wind,
+                     RoutePolar &glide, RoutePolar &cruise)
+{
+  const Key key(settings, polar, wind);
+
+  ++clock;
+
+  Entry *entry = nullptr;
+  for (unsigned i = 0; i < n_entries; ++i) {
+    if (entries[i].key == key) {
+      entry = &entries[i];
+      break;
+    }
+  }
+
+  if (entry == nullptr) {
+    if (n_entries < SIZE) {
+      entry = &entries[n_entries++];
+    } else {
+      /* evict the least recently used entry */
+      entry = &entries[0];
+      for (unsigned i = 1; i < n_entries; ++i)
+        if (entries[i].last_used < entry->last_used)
+          entry = &entries[i];
+    }
+
+    ++n_misses;
+
+    const SpeedVector quantised_wind = key.GetWind();
+    entry->key = key;
+    entry->glide.Initialise(settings, polar, quantised_wind, true);
+    entry->cruise.Initialise(settings, polar, quantised_wind, false);
+  }
+
+  entry->last_used = clock;
+
+  glide = entry->glide;
+  cruise = entry->cruise;
+}
@@ -0,0 +1,117 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_ROUTE_POLAR_CACHE_HPP
+#define XCSOAR_ROUTE_POLAR_CACHE_HPP
+
+#include "RoutePolar.hpp"
+#include "GlideSolvers/PolarCoefficients.hpp"
+#include "Compiler.h"
+
+class GlidePolar;
+struct GlideSettings;
+struct SpeedVector;
+
+/**
+ * A small cache of #RoutePolar tables.  Calculating a table requires
+ * one #MacCready solution per direction, but its inputs (glide
+ * polar, MacCready setting and wind) change rarely, and when they
+ * do, they often return to a previous state (e.g. when the pilot
+ * turns the MacCready setting back).
+ *
+ * The wind vector is quantised to #WIND_QUANTUM, so small
+ * fluctuations of the wind estimate do not cause a recalculation.
+ * The tables are calculated with the quantised wind.
+ */
+class RoutePolarCache {
+public:
+  /**
+   * The resolution of the east and north wind components [m/s].
+   */
+  static constexpr double WIND_QUANTUM = 0.5;
+
+private:
+  static constexpr unsigned SIZE = 8;
+
+  struct Key {
+    PolarCoefficients coefficients;
+    double mc, cruise_efficiency, v_max;
+
+    /** the wind components in multiples of #WIND_QUANTUM */
+    int wind_east, wind_north;
+
+    bool predict_wind_drift;
+
+    Key() = default;
+    Key(const GlideSettings &settings, const GlidePolar &polar,
+        const SpeedVector &wind);
+
+    gcc_pure
+    bool operator==(const Key &other) const;
+
+    gcc_pure
+    SpeedVector GetWind() const;
+  };
+
+  struct Entry {
+    Key key;
+
+    /**
+     * The value of #clock when this entry was used last.
+     */
+    unsigned last_used;
+
+    RoutePolar glide, cruise;
+  };
+
+  Entry entries[SIZE];
+  unsigned n_entries = 0;
+
+  unsigned clock = 0;
+
+  /**
+   * The number of table pairs which were calculated (for
+   * statistics and unit tests).
+   */
+  unsigned n_misses = 0;
+
+public:
+  void Clear() {
+    n_entries = 0;
+  }
+
+  unsigned GetMisses() const {
+    return n_misses;
+  }
+
+  /**
+   * Obtain the pure glide and cruise-climb tables for the specified
+   * parameters.  They are copied from the cache if available, and
+   * calculated otherwise.
+   */
+  void Get(const GlideSettings &settings, const GlidePolar &polar,
+           const SpeedVector &wind,
+           RoutePolar &glide, RoutePolar &cruise);
+};
+
+#endif
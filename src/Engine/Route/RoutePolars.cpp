@@ -21,6 +21,7 @@
  */
 
 #include "RoutePolars.hpp"
+#include "RoutePolarCache.hpp"
 #include "RouteLink.hpp"
 #include "GlideSolvers/GlidePolar.hpp"
 #include "Geo/Flat/FlatProjection.hpp"
@@ -44,12 +45,12 @@ RoutePolars::MSLIntercept(const int index, const FlatGeoPoint &fp,
 }
 
 void
-RoutePolars::Initialise(const GlideSettings &settings, const GlidePolar &polar,
+RoutePolars::Initialise(RoutePolarCache &cache,
+                        const GlideSettings &settings, const GlidePolar &polar,
                         const SpeedVector &wind,
                         const int _height_min_working)
 {
-  polar_glide.Initialise(settings, polar, wind, true);
-  polar_cruise.Initialise(settings, polar, wind, false);
+  cache.Get(settings, polar, wind, polar_glide, polar_cruise);
   inv_mc = MC_CEILING_PENALTY_FACTOR * polar.GetInvMC();
   height_min_working = std::max(0, _height_min_working - GetSafetyHeight());
 }
@@ -30,6 +30,7 @@
 #include <limits.h>
 
 class GlidePolar;
+class RoutePolarCache;
 struct GlideSettings;
 class FlatProjection;
 class RasterMap;
@@ -67,10 +68,12 @@ public:
   /**
    * Re-initialise performance tables when polar or wind changes
    *
+   * @param cache the performance tables are obtained from this cache
    * @param polar Polar used for performance
    * @param wind Wind condition
    */
-  void Initialise(const GlideSettings &settings, const GlidePolar& polar,
+  void Initialise(RoutePolarCache &cache,
+                  const GlideSettings &settings, const GlidePolar& polar,
                   const SpeedVector& wind,
                   const int _height_min_working=0);
 
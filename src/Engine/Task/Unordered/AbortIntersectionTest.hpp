@@ -24,11 +24,25 @@ Copyright_License {
 #ifndef XCSOAR_ABORT_INTERSECTION_TEST_HPP
 #define XCSOAR_ABORT_INTERSECTION_TEST_HPP
 
-struct AGeoPoint;
+#include "Geo/GeoPoint.hpp"
 
 class AbortIntersectionTest {
 public:
   virtual bool Intersects(const AGeoPoint &destination) = 0;
+
+  /**
+   * Test many destinations at a time.  The default implementation
+   * calls Intersects() for each of them; implementations may
+   * override this with something cheaper.
+   *
+   * @param results an array of #n elements which receives the
+   * result for each destination
+   */
+  virtual void Intersects(const AGeoPoint *destinations, bool *results,
+                          unsigned n) {
+    for (unsigned i = 0; i < n; ++i)
+      results[i] = Intersects(destinations[i]);
+  }
 };
 
 #endif
@@ -32,6 +32,9 @@
 #include "Util/ReservablePriorityQueue.hpp"
 #include "Util/Clamp.hpp"
 
+#include <memory>
+#include <vector>
+
 /** min search range in m */
 static constexpr double min_search_range = 50000;
 
@@ -147,46 +150,74 @@ AbortTask::FillReachable(const AircraftState &state,
 
   const AGeoPoint p_start(state.location, state.altitude);
 
-  bool found_final_glide = false;
-  reservable_priority_queue<AlternatePoint, AlternateList, AbortRank> q;
-  q.reserve(32);
+  /* first pass: calculate the glide solution of each candidate and
+     collect the destinations which need a terrain check; these are
+     submitted to the AbortIntersectionTest in one batch */
+  const unsigned n = approx_waypoints.size();
+  std::vector<GlideResult> results(n);
+  std::vector<bool> reachable(n, false);
+
+  std::vector<AGeoPoint> test_destinations;
+  std::vector<unsigned> test_indices;
 
-  for (auto v = approx_waypoints.begin(); v != approx_waypoints.end();) {
-    if (only_airfield && !v->waypoint->IsAirport()) {
-      ++v;
+  for (unsigned i = 0; i < n; ++i) {
+    const AlternatePoint &v = approx_waypoints[i];
+    if (only_airfield && !v.waypoint->IsAirport())
       continue;
-    }
 
-    auto wp = v->waypoint;
+    auto wp = v.waypoint;
     UnorderedTaskPoint t(std::move(wp), task_behaviour);
-    GlideResult result =
-        TaskSolution::GlideSolutionRemaining(t, state,
-                                             task_behaviour.glide, polar);
+    results[i] = TaskSolution::GlideSolutionRemaining(t, state,
+                                                      task_behaviour.glide,
+                                                      polar);
+
+    if (!IsReachable(results[i], final_glide))
+      continue;
+
+    reachable[i] = true;
 
-    if (IsReachable(result, final_glide)) {
-      bool intersects = false;
-      const bool is_reachable_final = IsReachable(result, true);
+    if (intersection_test && final_glide && IsReachable(results[i], true)) {
+      test_destinations.emplace_back(v.waypoint->location,
+                                     results[i].min_arrival_altitude);
+      test_indices.push_back(i);
+    }
+  }
 
-      if (intersection_test && final_glide && is_reachable_final)
-        intersects = intersection_test->Intersects(
-            AGeoPoint(v->waypoint->location, result.min_arrival_altitude));
+  if (!test_indices.empty()) {
+    std::unique_ptr<bool[]> intersects(new bool[test_indices.size()]);
+    intersection_test->Intersects(test_destinations.data(), intersects.get(),
+                                  test_indices.size());
 
-      if (!intersects) {
-        wp = v->waypoint;
-        q.push(AlternatePoint(std::move(wp), result));
-        // remove it since it's already in the list now      
-        v = approx_waypoints.erase(v);
+    for (unsigned j = 0; j < test_indices.size(); ++j)
+      if (intersects[j])
+        reachable[test_indices[j]] = false;
+  }
 
-        if (is_reachable_final)
-          found_final_glide = true;
+  /* second pass: move the reachable candidates to the queue */
+  bool found_final_glide = false;
+  reservable_priority_queue<AlternatePoint, AlternateList, AbortRank> q;
+  q.reserve(32);
+
+  unsigned n_remaining = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    AlternatePoint &v = approx_waypoints[i];
 
-        continue; // skip incrementing v since we just erased it
-      }
-    } 
+    if (reachable[i]) {
+      q.push(AlternatePoint(std::move(v.waypoint), results[i]));
 
-    ++v;
+      if (IsReachable(results[i], true))
+        found_final_glide = true;
+    } else {
+      // keep it for the next call
+      if (n_remaining != i)
+        approx_waypoints[n_remaining] = std::move(v);
+      ++n_remaining;
+    }
   }
 
+  approx_waypoints.erase(approx_waypoints.begin() + n_remaining,
+                         approx_waypoints.end());
+
   while (!q.empty() && !IsTaskFull()) {
     auto top = q.top();
     task_points.emplace_back(std::move(top.waypoint), task_behaviour,
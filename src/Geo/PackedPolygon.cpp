@@ -0,0 +1,262 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "PackedPolygon.hpp"
+#include "SearchPointVector.hpp"
+#include "Flat/FlatRay.hpp"
+
+#include <limits>
+
+#include <math.h>
+#include <stdlib.h>
+
+constexpr unsigned PackedPolygon::BLOCK_SIZE;
+
+void
+PackedPolygon::Clear()
+{
+  longitudes.clear();
+  latitudes.clear();
+  xs.clear();
+  ys.clear();
+}
+
+void
+PackedPolygon::Update(const SearchPointVector &spv)
+{
+  Clear();
+
+  const unsigned n = spv.size();
+  longitudes.reserve(n);
+  latitudes.reserve(n);
+  xs.reserve(n);
+  ys.reserve(n);
+
+  for (const auto &i : spv) {
+    const GeoPoint &location = i.GetLocation();
+    longitudes.push_back(location.longitude.Native());
+    latitudes.push_back(location.latitude.Native());
+
+    const FlatGeoPoint &flat = i.GetFlatLocation();
+    xs.push_back(flat.x);
+    ys.push_back(flat.y);
+  }
+}
+
+bool
+PackedPolygon::IsInside(const GeoPoint &p) const
+{
+  const unsigned n = size();
+  if (n < 3)
+    return false;
+
+  const double px = p.longitude.Native(), py = p.latitude.Native();
+  const double *gcc_restrict x = longitudes.data();
+  const double *gcc_restrict y = latitudes.data();
+
+  /* the winding number test of PolygonInterior(); only edges which
+     cross the point's latitude need the cross product */
+  int wn = 0;
+  bool below = y[0] <= py;
+  for (unsigned i = 0; i < n - 1; ++i) {
+    const bool next_below = y[i + 1] <= py;
+    if (below == next_below)
+      continue;
+
+    const double left = (x[i + 1] - x[i]) * (py - y[i]) -
+      (px - x[i]) * (y[i + 1] - y[i]);
+
+    if (below) {
+      // an upward crossing
+      if (left > 0)
+        ++wn;
+    } else {
+      // a downward crossing
+      if (left < 0)
+        --wn;
+    }
+
+    below = next_below;
+  }
+
+  return wn != 0;
+}
+
+bool
+PackedPolygon::FindIntersections(const FlatRay &ray,
+                                 unsigned start, unsigned n,
+                                 uint8_t *gcc_restrict hits) const
+{
+  const int rx = ray.point.x, ry = ray.point.y;
+  const int vx = ray.vector.x, vy = ray.vector.y;
+  const int *gcc_restrict x = xs.data() + start;
+  const int *gcc_restrict y = ys.data() + start;
+
+  /* the same tests as FlatRay::DistinctIntersection() */
+  unsigned n_hits = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    const int wx = x[i + 1] - x[i], wy = y[i + 1] - y[i];
+    const int dx = x[i] - rx, dy = y[i] - ry;
+
+    const int denominator = vx * wy - wx * vy;
+    const int ua = dx * wy - wx * dy;
+    const int ub = dx * vy - vx * dy;
+
+    const bool positive = denominator >= 0;
+    const int abs_denominator = abs(denominator);
+
+    const bool hit = (denominator != 0) &
+      ((ua >= 0) == positive) & (abs(ua) <= abs_denominator) &
+      ((ub >= 0) == positive) & (abs(ub) <= abs_denominator) &
+      ((positive ? ua : -ua) > 0) & (abs(ua) < abs_denominator);
+
+    hits[i] = hit;
+    n_hits += hit;
+  }
+
+  return n_hits > 0;
+}
+
+double
+PackedPolygon::GetIntersection(const FlatRay &ray, unsigned edge) const
+{
+  const int wx = xs[edge + 1] - xs[edge], wy = ys[edge + 1] - ys[edge];
+  const int dx = xs[edge] - ray.point.x, dy = ys[edge] - ray.point.y;
+
+  const int denominator = ray.vector.x * wy - wx * ray.vector.y;
+  const int ua = dx * wy - wx * dy;
+  return double(ua) / double(denominator);
+}
+
+/**
+ * The squared distance from the point to the segment, without the
+ * rounding of SearchPointVector::NearestPoint().
+ */
+gcc_const
+static inline double
+SegmentDistanceSquared(double x1, double y1, double x2, double y2,
+                       double px, double py)
+{
+  const double dx = x2 - x1, dy = y2 - y1;
+  const double qx = px - x1, qy = py - y1;
+
+  /* all coordinates are integers, so a non-zero squared length is at
+     least 1; this avoids a division by zero without a branch */
+  const double rsq = dx * dx + dy * dy;
+  const double t = std::min(std::max((qx * dx + qy * dy) / std::max(rsq, 1.),
+                                     0.), 1.);
+
+  const double ex = qx - t * dx, ey = qy - t * dy;
+  return ex * ex + ey * ey;
+}
+
+/**
+ * The exact calculation of SearchPointVector::NearestPoint() for one
+ * segment.
+ */
+gcc_pure
+static FlatGeoPoint
+SegmentNearestPoint(const FlatGeoPoint &p1, const FlatGeoPoint &p2,
+                    const FlatGeoPoint &p3)
+{
+  const FlatGeoPoint p12 = p2 - p1;
+  const double rsq(p12.DotProduct(p12));
+  if (rsq <= 0)
+    return p1;
+
+  const FlatGeoPoint p13 = p3 - p1;
+  const double numerator(p13.DotProduct(p12));
+
+  if (numerator <= 0)
+    return p1;
+  else if (numerator >= rsq)
+    return p2;
+  else
+    return p1 + p12 * (numerator / rsq);
+}
+
+FlatGeoPoint
+PackedPolygon::NearestPoint(const FlatGeoPoint &p) const
+{
+  const unsigned n = size();
+  if (n == 0)
+    return p;
+
+  if (n == 1)
+    return FlatGeoPoint(xs[0], ys[0]);
+
+  const double px = p.x, py = p.y;
+  const int *gcc_restrict x = xs.data();
+  const int *gcc_restrict y = ys.data();
+
+  /* the exact calculation of SearchPointVector::NearestPoint() is
+     only done for segments whose unrounded distance is close to the
+     smallest one seen so far; rounding the nearest point to integer
+     coordinates moves it by less than one unit in each axis, so the
+     others cannot win */
+  unsigned distance_min = 0 - 1;
+  FlatGeoPoint point_best = p;
+  double min_distance = std::numeric_limits<double>::max();
+  double threshold = min_distance;
+
+  auto check = [&](unsigned i, unsigned next, double distance) {
+    if (distance < min_distance) {
+      min_distance = distance;
+      threshold = Square(sqrt(distance) + 2);
+    }
+
+    if (distance > threshold)
+      return;
+
+    const FlatGeoPoint pa =
+      SegmentNearestPoint(FlatGeoPoint(x[i], y[i]),
+                          FlatGeoPoint(x[next], y[next]), p);
+    const unsigned d = p.DistanceSquared(pa);
+    if (d < distance_min) {
+      distance_min = d;
+      point_best = pa;
+    }
+  };
+
+  double distances[BLOCK_SIZE];
+  for (unsigned start = 0; start < n - 1; start += BLOCK_SIZE) {
+    const unsigned block_size = std::min(BLOCK_SIZE, n - 1 - start);
+
+    /* a vectorisable loop which calculates the unrounded distances of
+       this block */
+    for (unsigned j = 0; j < block_size; ++j) {
+      const unsigned i = start + j;
+      distances[j] = SegmentDistanceSquared(x[i], y[i], x[i + 1], y[i + 1],
+                                            px, py);
+    }
+
+    for (unsigned j = 0; j < block_size; ++j)
+      check(start + j, start + j + 1, distances[j]);
+  }
+
+  // the last segment closes the polygon
+  check(n - 1, 0,
+        SegmentDistanceSquared(x[n - 1], y[n - 1], x[0], y[0], px, py));
+
+  return point_best;
+}
@@ -0,0 +1,138 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_PACKED_POLYGON_HPP
+#define XCSOAR_PACKED_POLYGON_HPP
+
+#include "Flat/FlatGeoPoint.hpp"
+#include "Compiler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <stdint.h>
+
+struct GeoPoint;
+class FlatRay;
+class SearchPointVector;
+
+/**
+ * A read-only copy of a projected #SearchPointVector, with each
+ * coordinate stored in its own array ("structure of arrays").  The
+ * loops over all edges only touch the coordinates they need, and
+ * they are written so the compiler can vectorise them.
+ *
+ * The results are the same as those of the corresponding
+ * #SearchPointVector methods.
+ */
+class PackedPolygon {
+  /**
+   * The number of edges which are tested at a time by the
+   * vectorisable kernels.
+   */
+  static constexpr unsigned BLOCK_SIZE = 64;
+
+  /**
+   * The geographic coordinates of the vertices [Angle::Native()].
+   */
+  std::vector<double> longitudes, latitudes;
+
+  /**
+   * The projected coordinates of the vertices.
+   */
+  std::vector<int> xs, ys;
+
+public:
+  gcc_pure
+  bool IsEmpty() const {
+    return xs.empty();
+  }
+
+  gcc_pure
+  unsigned size() const {
+    return xs.size();
+  }
+
+  void Clear();
+
+  /**
+   * Copy the vertices of the specified #SearchPointVector, which must
+   * have been projected already.
+   */
+  void Update(const SearchPointVector &spv);
+
+  /**
+   * @see SearchPointVector::IsInside(const GeoPoint &)
+   */
+  gcc_pure
+  bool IsInside(const GeoPoint &p) const;
+
+  /**
+   * @see SearchPointVector::NearestPoint()
+   */
+  gcc_pure
+  FlatGeoPoint NearestPoint(const FlatGeoPoint &p) const;
+
+  /**
+   * Invoke the specified function for each edge (from vertex i to
+   * vertex i+1) which has a distinct intersection with the ray, with
+   * the ray parameter of the intersection (see
+   * FlatRay::DistinctIntersection()).
+   */
+  template<typename F>
+  void VisitIntersections(const FlatRay &ray, F &&f) const {
+    uint8_t hits[BLOCK_SIZE];
+
+    const unsigned n_edges = xs.size() > 1 ? xs.size() - 1 : 0;
+    for (unsigned start = 0; start < n_edges; start += BLOCK_SIZE) {
+      const unsigned n = std::min(BLOCK_SIZE, n_edges - start);
+      if (!FindIntersections(ray, start, n, hits))
+        continue;
+
+      for (unsigned i = 0; i < n; ++i)
+        if (hits[i])
+          f(GetIntersection(ray, start + i));
+    }
+  }
+
+private:
+  /**
+   * Test the edges [start, start+n) for a distinct intersection with
+   * the ray.
+   *
+   * @param hits receives a non-zero value for each edge which
+   * intersects
+   * @return true if at least one edge intersects
+   */
+  bool FindIntersections(const FlatRay &ray, unsigned start, unsigned n,
+                         uint8_t *hits) const;
+
+  /**
+   * Calculate the ray parameter of the intersection with the
+   * specified edge, which is known to intersect.
+   */
+  gcc_pure
+  double GetIntersection(const FlatRay &ray, unsigned edge) const;
+};
+
+#endif
@@ -122,7 +122,7 @@ FileCache::Flush(const TCHAR *name)
 }
 
 FILE *
-FileCache::Load(const TCHAR *name, Path original_path)
+FileCache::Open(const TCHAR *name, Path original_path, const TCHAR *mode)
 {
   FileInfo original_info;
   if (!GetRegularFileInfo(original_path, original_info))
@@ -142,7 +142,7 @@ FileCache::Load(const TCHAR *name, Path original_path)
     return nullptr;
   }
 
-  FILE *file = _tfopen(path.c_str(), _T("rb"));
+  FILE *file = _tfopen(path.c_str(), mode);
   if (file == nullptr)
     return nullptr;
 
@@ -160,6 +160,18 @@ FileCache::Load(const TCHAR *name, Path original_path)
   return file;
 }
 
+FILE *
+FileCache::Load(const TCHAR *name, Path original_path)
+{
+  return Open(name, original_path, _T("rb"));
+}
+
+FILE *
+FileCache::LoadWritable(const TCHAR *name, Path original_path)
+{
+  return Open(name, original_path, _T("r+b"));
+}
+
 FILE *
 FileCache::Save(const TCHAR *name, Path original_path)
 {
@@ -41,10 +41,19 @@ protected:
     return AllocatedPath::Build(cache_path, name);
   }
 
+  FILE *Open(const TCHAR *name, Path original_path, const TCHAR *mode);
+
 public:
   void Flush(const TCHAR *name);
   FILE *Load(const TCHAR *name, Path original_path);
 
+  /**
+   * Like Load(), but open the file for reading and writing.  This is
+   * used for cache files which are mapped into memory and updated
+   * in-place.
+   */
+  FILE *LoadWritable(const TCHAR *name, Path original_path);
+
   FILE *Save(const TCHAR *name, Path original_path);
   bool Commit(const TCHAR *name, FILE *file);
   void Cancel(const TCHAR *name, FILE *file);
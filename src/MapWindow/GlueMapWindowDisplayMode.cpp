@@ -122,8 +122,18 @@ GlueMapWindow::UpdateScreenBounds()
      it's used by other calculations, therefore don't check if terrain
      display is enabled */
   if (terrain_thread != nullptr &&
-      visible_projection.IsValid())
-    terrain_thread->Trigger(visible_projection);
+      visible_projection.IsValid()) {
+    /* prefetch terrain along the predicted flight path, so it is
+       available in full resolution for reach and route
+       calculations */
+    const NMEAInfo &basic = CommonInterface::Basic();
+    if (basic.location_available && basic.track_available &&
+        basic.MovementDetected())
+      terrain_thread->Trigger(visible_projection, basic.location,
+                              basic.track, basic.ground_speed);
+    else
+      terrain_thread->Trigger(visible_projection);
+  }
 }
 
 void
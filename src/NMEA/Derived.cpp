@@ -96,6 +96,8 @@ DerivedInfo::Reset()
   airspace_warnings.Clear();
 
   planned_route.clear();
+
+  reachability.Clear();
 }
 
 void
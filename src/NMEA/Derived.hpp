@@ -44,6 +44,7 @@ Copyright_License {
 #include "Engine/GlideSolvers/GlidePolar.hpp"
 #include "Atmosphere/Pressure.hpp"
 #include "Engine/Route/Route.hpp"
+#include "NMEA/ReachabilityTable.hpp"
 #include "Computer/WaveResult.hpp"
 #include "Util/TypeTraits.hpp"
 
@@ -249,6 +250,9 @@ struct DerivedInfo:
   /** Route plan for current leg avoiding airspace */
   StaticRoute planned_route;
 
+  /** Arrival heights at the landables within final glide range */
+  ReachabilityTable reachability;
+
   /**
    * Thermal value of next leg that is equivalent (gives the same average
    * speed) to the current MacCready setting. A negative value should be
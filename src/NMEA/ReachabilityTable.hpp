@@ -0,0 +1,116 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_REACHABILITY_TABLE_HPP
+#define XCSOAR_REACHABILITY_TABLE_HPP
+
+#include "NMEA/Validity.hpp"
+#include "Engine/Route/ReachResult.hpp"
+#include "Util/TrivialArray.hxx"
+#include "Util/TypeTraits.hpp"
+#include "Compiler.h"
+
+#include <algorithm>
+
+/**
+ * The arrival heights at the landable waypoints within final glide
+ * range, calculated once per fix by the calculation thread.  Consumers
+ * look up results here instead of solving the glide themselves.
+ */
+struct ReachabilityTable {
+  static constexpr unsigned MAX_SIZE = 256;
+
+  struct Entry {
+    /**
+     * The id of the #Waypoint.
+     */
+    unsigned id;
+
+    /**
+     * The arrival height above the waypoint's elevation plus the
+     * arrival safety height.
+     */
+    ReachResult reach;
+  };
+
+  /**
+   * The entries, sorted by waypoint id.
+   */
+  TrivialArray<Entry, MAX_SIZE> entries;
+
+  Validity available;
+
+  /**
+   * Incremented each time the table is modified.
+   */
+  unsigned serial;
+
+  /**
+   * Were the entries calculated from the terrain reach?  If not, only
+   * ReachResult::direct is valid.
+   */
+  bool terrain;
+
+  void Clear() {
+    entries.clear();
+    available.Clear();
+    serial = 0;
+    terrain = false;
+  }
+
+  /**
+   * Discard the entries because no result could be calculated.
+   */
+  void Invalidate() {
+    if (!available)
+      return;
+
+    entries.clear();
+    available.Clear();
+    ++serial;
+  }
+
+  /**
+   * Look up the result for the specified waypoint.  Returns nullptr
+   * if the waypoint is not in the table, i.e. it is not landable or
+   * out of final glide range.
+   */
+  gcc_pure
+  const Entry *Find(unsigned id) const {
+    if (!available)
+      return nullptr;
+
+    auto i = std::lower_bound(entries.begin(), entries.end(), id,
+                              [](const Entry &entry, unsigned _id) {
+                                return entry.id < _id;
+                              });
+    return i != entries.end() && i->id == id
+      ? &*i
+      : nullptr;
+  }
+};
+
+static_assert(is_trivial_ndebug<ReachabilityTable>::value,
+              "type is not trivial");
+
+#endif
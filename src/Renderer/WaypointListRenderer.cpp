@@ -27,6 +27,7 @@ Copyright_License {
 #include "Screen/Layout.hpp"
 #include "Renderer/WaypointIconRenderer.hpp"
 #include "Engine/Waypoint/Waypoint.hpp"
+#include "Engine/Route/ReachResult.hpp"
 #include "Geo/GeoVector.hpp"
 #include "Formatter/UserUnits.hpp"
 #include "Formatter/AngleFormatter.hpp"
@@ -53,9 +54,24 @@ FormatWaypointDetails(Buffer &buffer, const Waypoint &waypoint)
   }
 }
 
+gcc_pure
+static WaypointIconRenderer::Reachability
+GetReachability(const ReachResult &reach)
+{
+  if (!reach.IsReachableDirect())
+    return WaypointIconRenderer::Unreachable;
+
+  if (reach.terrain_valid != ReachResult::Validity::INVALID &&
+      !reach.IsReachableTerrain())
+    return WaypointIconRenderer::ReachableStraight;
+
+  return WaypointIconRenderer::ReachableTerrain;
+}
+
 static void
 Draw(Canvas &canvas, PixelRect rc,
      const Waypoint &waypoint, const GeoVector *vector,
+     const ReachResult *reach,
      const TwoTextRowsRenderer &row_renderer,
      const WaypointLook &look,
      const WaypointRendererSettings &settings)
@@ -66,7 +82,10 @@ Draw(Canvas &canvas, PixelRect rc,
   // Draw icon
   const PixelPoint pt(rc.left + line_height / 2, rc.top + line_height / 2);
   WaypointIconRenderer wir(settings, look, canvas);
-  wir.Draw(waypoint, pt);
+  if (reach != nullptr)
+    wir.Draw(waypoint, pt, GetReachability(*reach));
+  else
+    wir.Draw(waypoint, pt);
 
   rc.left += line_height + padding;
 
@@ -86,6 +105,18 @@ Draw(Canvas &canvas, PixelRect rc,
 
   // Draw details line
   FormatWaypointDetails(buffer, waypoint);
+
+  if (reach != nullptr) {
+    const int arrival_altitude =
+      reach->terrain_valid == ReachResult::Validity::VALID
+      ? reach->terrain
+      : reach->direct;
+
+    TCHAR alt[20];
+    FormatRelativeUserAltitude(arrival_altitude, alt, true);
+    buffer.AppendFormat(_T(" - %s: %s"), _("Arrival Alt"), alt);
+  }
+
   row_renderer.DrawSecondRow(canvas, rc, buffer);
 
   // Draw waypoint name
@@ -99,17 +130,31 @@ WaypointListRenderer::Draw(Canvas &canvas, const PixelRect rc,
                            const WaypointLook &look,
                            const WaypointRendererSettings &renderer_settings)
 {
-  ::Draw(canvas, rc, waypoint, nullptr, row_renderer, look, renderer_settings);
+  ::Draw(canvas, rc, waypoint, nullptr, nullptr,
+         row_renderer, look, renderer_settings);
+}
+
+void
+WaypointListRenderer::Draw(Canvas &canvas, const PixelRect rc,
+                           const Waypoint &waypoint, const GeoVector &vector,
+                           const TwoTextRowsRenderer &row_renderer,
+                           const WaypointLook &look,
+                           const WaypointRendererSettings &settings)
+{
+  ::Draw(canvas, rc, waypoint, &vector, nullptr,
+         row_renderer, look, settings);
 }
 
 void
 WaypointListRenderer::Draw(Canvas &canvas, const PixelRect rc,
                            const Waypoint &waypoint, const GeoVector &vector,
+                           const ReachResult &reach,
                            const TwoTextRowsRenderer &row_renderer,
                            const WaypointLook &look,
                            const WaypointRendererSettings &settings)
 {
-  ::Draw(canvas, rc, waypoint, &vector, row_renderer, look, settings);
+  ::Draw(canvas, rc, waypoint, &vector, &reach,
+         row_renderer, look, settings);
 }
 
 void
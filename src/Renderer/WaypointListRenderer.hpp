@@ -31,6 +31,7 @@ struct Waypoint;
 struct GeoVector;
 struct WaypointLook;
 struct WaypointRendererSettings;
+struct ReachResult;
 
 namespace WaypointListRenderer
 {
@@ -45,6 +46,16 @@ namespace WaypointListRenderer
             const WaypointLook &look,
             const WaypointRendererSettings &settings);
 
+  /**
+   * Draw a landable with its arrival height relative to the arrival
+   * safety height, which was looked up in DerivedInfo::reachability.
+   */
+  void Draw(Canvas &canvas, const PixelRect rc, const Waypoint &waypoint,
+            const GeoVector &vector, const ReachResult &reach,
+            const TwoTextRowsRenderer &row_renderer,
+            const WaypointLook &look,
+            const WaypointRendererSettings &settings);
+
   void Draw(Canvas &canvas, const PixelRect rc, const Waypoint &waypoint,
             double distance, double arrival_altitude,
             const TwoTextRowsRenderer &row_renderer,
@@ -32,9 +32,8 @@ Copyright_License {
 #include "Engine/Waypoint/Waypoint.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 #include "Engine/Waypoint/WaypointVisitor.hpp"
-#include "Engine/GlideSolvers/GlideState.hpp"
-#include "Engine/GlideSolvers/GlideResult.hpp"
 #include "Engine/GlideSolvers/MacCready.hpp"
+#include "Geo/GeoVector.hpp"
 #include "Engine/Task/TaskManager.hpp"
 #include "Engine/Task/AbstractTask.hpp"
 #include "Engine/Task/Unordered/UnorderedTaskPoint.hpp"
@@ -68,6 +67,11 @@ struct VisibleWaypoint {
 
   bool in_task;
 
+  /**
+   * Was the reachability taken from DerivedInfo::reachability?
+   */
+  bool published;
+
   void Set(const WaypointPtr &_waypoint, PixelPoint &_point,
            bool _in_task) {
     waypoint = _waypoint;
@@ -75,6 +79,7 @@ struct VisibleWaypoint {
     reach.Clear();
     reachable = WaypointRenderer::Invalid;
     in_task = _in_task;
+    published = false;
   }
 
   bool IsReachable() const {
@@ -82,45 +87,50 @@ struct VisibleWaypoint {
       reachable == WaypointRenderer::ReachableTerrain;
   }
 
-  void CalculateReachabilityDirect(const MoreData &basic,
-                                   const SpeedVector &wind,
-                                   const MacCready &mac_cready,
-                                   const TaskBehaviour &task_behaviour) {
-    assert(basic.location_available);
-    assert(basic.NavAltitudeAvailable());
-
-    const auto elevation = waypoint->elevation +
-      task_behaviour.safety_height_arrival;
-    const GlideState state(GeoVector(basic.location, waypoint->location),
-                           elevation, basic.nav_altitude, wind);
-
-    const GlideResult result = mac_cready.SolveStraight(state);
-    if (!result.IsOk())
-      return;
-
-    reach.direct = result.pure_glide_altitude_difference;
-    if (result.pure_glide_altitude_difference > 0)
-      reachable = WaypointRenderer::ReachableTerrain;
+  /**
+   * The altitude at which the aircraft shall arrive at this waypoint.
+   */
+  gcc_pure
+  double GetArrivalElevation(const TaskBehaviour &task_behaviour) const {
+    return waypoint->elevation + task_behaviour.safety_height_arrival;
   }
 
-  bool CalculateRouteArrival(const RoutePlannerGlue &route_planner,
-                             const TaskBehaviour &task_behaviour) {
-    const double elevation = waypoint->elevation +
-      task_behaviour.safety_height_arrival;
-    const AGeoPoint p_dest (waypoint->location, elevation);
-    if (!route_planner.FindPositiveArrival(p_dest, reach))
-      return false;
-
-    reach.Subtract(elevation);
-    return true;
+  /**
+   * Apply a result of MacCready::SolveStraight().
+   */
+  void CalculateReachabilityDirect(double altitude_difference) {
+    reach.direct = altitude_difference;
+    if (altitude_difference > 0)
+      reachable = WaypointRenderer::ReachableTerrain;
   }
 
-  void CalculateReachability(const RoutePlannerGlue &route_planner,
+  /**
+   * Apply a result of RoutePlannerGlue::FindPositiveArrivals().
+   */
+  void CalculateReachability(const ReachResult &result,
                              const TaskBehaviour &task_behaviour)
   {
-    if (!CalculateRouteArrival(route_planner, task_behaviour))
-      return;
+    reach = result;
+    reach.Subtract(GetArrivalElevation(task_behaviour));
+    SetReachability(task_behaviour);
+  }
+
+  /**
+   * Apply an entry of DerivedInfo::reachability.
+   */
+  void CalculateReachability(const ReachabilityTable &table,
+                             const ReachabilityTable::Entry &entry,
+                             const TaskBehaviour &task_behaviour) {
+    if (table.terrain) {
+      reach = entry.reach;
+      SetReachability(task_behaviour);
+    } else
+      CalculateReachabilityDirect(entry.reach.direct);
 
+    published = true;
+  }
+
+  void SetReachability(const TaskBehaviour &task_behaviour) {
     if (!reach.IsReachableDirect())
       reachable = WaypointRenderer::Unreachable;
     else if (task_behaviour.route_planner.IsReachEnabled() &&
@@ -389,20 +399,79 @@ public:
     task_valid = true;
   }
 
-  void CalculateRoute(const ProtectedRoutePlanner &route_planner) {
-    const ProtectedRoutePlanner::Lease lease(route_planner);
-
+  /**
+   * Apply the cached results to the waypoints which need a
+   * reachability calculation, and collect those which are not in the
+   * cache.
+   */
+  void LookupReachCache(const WaypointRenderer::ReachCache &cache,
+                        StaticArray<VisibleWaypoint *, 256> &missing) {
     for (VisibleWaypoint &vwp : waypoints) {
       const Waypoint &way_point = *vwp.waypoint;
+      if ((!way_point.IsLandable() && !way_point.flags.watched) ||
+          vwp.published)
+        continue;
+
+      const auto *entry = cache.Find(way_point.id);
+      if (entry != nullptr) {
+        vwp.reach = entry->reach;
+        vwp.reachable = entry->reachable;
+      } else
+        missing.append(&vwp);
+    }
+  }
 
-      if (way_point.IsLandable() || way_point.flags.watched)
-        vwp.CalculateReachability(lease, task_behaviour);
+  static void
+  StoreReachCache(WaypointRenderer::ReachCache &cache,
+                  const StaticArray<VisibleWaypoint *, 256> &calculated) {
+    for (const VisibleWaypoint *vwp : calculated)
+      cache.Put(vwp->waypoint->id, vwp->reach, vwp->reachable);
+  }
+
+  void CalculateRoute(const ProtectedRoutePlanner &route_planner,
+                      Serial waypoints_serial,
+                      WaypointRenderer::ReachCache &cache) {
+    StaticArray<VisibleWaypoint *, 256> route_waypoints;
+    StaticArray<AGeoPoint, 256> destinations;
+    ReachResult results[256];
+
+    {
+      const ProtectedRoutePlanner::Lease lease(route_planner);
+
+      WaypointRenderer::ReachCache::Key key;
+      key.route = true;
+      key.waypoints_serial = waypoints_serial;
+      key.reach_serial = lease->GetTerrainReachSerial();
+      key.safety_height = task_behaviour.safety_height_arrival;
+      key.reach_enabled = task_behaviour.route_planner.IsReachEnabled();
+      cache.Update(key);
+
+      LookupReachCache(cache, route_waypoints);
+      if (route_waypoints.empty())
+        return;
+
+      /* look up the arrival heights of all waypoints in one query,
+         which traverses the reach tree only once */
+      for (const VisibleWaypoint *vwp : route_waypoints)
+        destinations.append(AGeoPoint(vwp->waypoint->location,
+                                      vwp->GetArrivalElevation(task_behaviour)));
+
+      if (!lease->FindPositiveArrivals(destinations.begin(), results,
+                                       destinations.size()))
+        return;
     }
+
+    for (unsigned i = 0; i < route_waypoints.size(); ++i)
+      route_waypoints[i]->CalculateReachability(results[i], task_behaviour);
+
+    StoreReachCache(cache, route_waypoints);
   }
 
   void CalculateDirect(const PolarSettings &polar_settings,
                        const TaskBehaviour &task_behaviour,
-                       const DerivedInfo &calculated) {
+                       const DerivedInfo &calculated,
+                       Serial waypoints_serial,
+                       WaypointRenderer::ReachCache &cache) {
     if (!basic.location_available || !basic.NavAltitudeAvailable())
       return;
 
@@ -410,25 +479,73 @@ public:
       task_behaviour.route_planner.reach_polar_mode == RoutePlannerConfig::Polar::TASK
       ? polar_settings.glide_polar_task
       : calculated.glide_polar_safety;
+    const SpeedVector wind = calculated.GetWindOrZero();
+
+    WaypointRenderer::ReachCache::Key key;
+    key.route = false;
+    key.waypoints_serial = waypoints_serial;
+    key.location = basic.location;
+    key.altitude = basic.nav_altitude;
+    key.wind = wind;
+    key.polar = glide_polar.GetRealCoefficients();
+    key.mc = glide_polar.GetMC();
+    key.cruise_efficiency = glide_polar.GetCruiseEfficiency();
+    key.v_max = glide_polar.GetVMax();
+    key.safety_height = task_behaviour.safety_height_arrival;
+    key.reach_enabled = false;
+    cache.Update(key);
+
+    StaticArray<VisibleWaypoint *, 256> direct_waypoints;
+    LookupReachCache(cache, direct_waypoints);
+    if (direct_waypoints.empty())
+      return;
+
+    /* solve all waypoints at once; the speed to fly is determined
+       only once */
+    const unsigned n = direct_waypoints.size();
+    GeoVector vectors[256];
+    double min_arrival_altitudes[256];
+    for (unsigned i = 0; i < n; ++i) {
+      const VisibleWaypoint &vwp = *direct_waypoints[i];
+      vectors[i] = GeoVector(basic.location, vwp.waypoint->location);
+      min_arrival_altitudes[i] = vwp.GetArrivalElevation(task_behaviour);
+    }
+
+    double altitude_differences[256];
+    bool valid[256];
     const MacCready mac_cready(task_behaviour.glide, glide_polar);
+    mac_cready.SolveStraight(vectors, min_arrival_altitudes, n,
+                             basic.nav_altitude, wind,
+                             altitude_differences, valid);
 
-    for (VisibleWaypoint &vwp : waypoints) {
-      const Waypoint &way_point = *vwp.waypoint;
+    for (unsigned i = 0; i < n; ++i)
+      if (valid[i])
+        direct_waypoints[i]->CalculateReachabilityDirect(
+          altitude_differences[i]);
 
-      if (way_point.IsLandable() || way_point.flags.watched)
-        vwp.CalculateReachabilityDirect(basic, calculated.GetWindOrZero(),
-                                        mac_cready, task_behaviour);
-    }
+    StoreReachCache(cache, direct_waypoints);
   }
 
   void Calculate(const ProtectedRoutePlanner *route_planner,
                  const PolarSettings &polar_settings,
                  const TaskBehaviour &task_behaviour,
-                 const DerivedInfo &calculated) {
+                 const DerivedInfo &calculated,
+                 Serial waypoints_serial,
+                 WaypointRenderer::ReachCache &cache) {
+    /* the calculation thread has already solved the landables within
+       final glide range; only the others are calculated here */
+    const ReachabilityTable &table = calculated.reachability;
+    for (VisibleWaypoint &vwp : waypoints) {
+      const auto *entry = table.Find(vwp.waypoint->id);
+      if (entry != nullptr)
+        vwp.CalculateReachability(table, *entry, task_behaviour);
+    }
+
     if (route_planner != nullptr && !route_planner->IsTerrainReachEmpty())
-      CalculateRoute(*route_planner);
+      CalculateRoute(*route_planner, waypoints_serial, cache);
     else
-      CalculateDirect(polar_settings, task_behaviour, calculated);
+      CalculateDirect(polar_settings, task_behaviour, calculated,
+                      waypoints_serial, cache);
   }
 
   void Draw(Canvas &canvas) {
@@ -437,6 +554,25 @@ public:
   }
 };
 
+bool
+WaypointRenderer::ReachCache::Key::operator==(const Key &other) const
+{
+  if (route != other.route || waypoints_serial != other.waypoints_serial ||
+      safety_height != other.safety_height ||
+      reach_enabled != other.reach_enabled)
+    return false;
+
+  if (route)
+    return reach_serial == other.reach_serial;
+
+  return location == other.location && altitude == other.altitude &&
+    wind.bearing == other.wind.bearing && wind.norm == other.wind.norm &&
+    polar.a == other.polar.a && polar.b == other.polar.b &&
+    polar.c == other.polar.c &&
+    mc == other.mc && cruise_efficiency == other.cruise_efficiency &&
+    v_max == other.v_max;
+}
+
 static void
 MapWaypointLabelRender(Canvas &canvas, unsigned width, unsigned height,
                        LabelBlock &label_block,
@@ -486,7 +622,8 @@ WaypointRenderer::render(Canvas &canvas, LabelBlock &label_block,
   way_points->VisitWithinRange(projection.GetGeoScreenCenter(),
                                  projection.GetScreenDistanceMeters(), v);
 
-  v.Calculate(route_planner, polar_settings, task_behaviour, calculated);
+  v.Calculate(route_planner, polar_settings, task_behaviour, calculated,
+              way_points->GetSerial(), reach_cache);
 
   v.Draw(canvas);
 
@@ -25,6 +25,12 @@ Copyright_License {
 #define XCSOAR_WAY_POINT_RENDERER_HPP
 
 #include "Util/NonCopyable.hpp"
+#include "Util/OpenHashMap.hpp"
+#include "Util/Serial.hpp"
+#include "Engine/Route/ReachResult.hpp"
+#include "Engine/GlideSolvers/PolarCoefficients.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Geo/SpeedVector.hpp"
 
 struct WaypointRendererSettings;
 struct WaypointLook;
@@ -38,6 +44,7 @@ struct MoreData;
 struct DerivedInfo;
 class ProtectedTaskManager;
 class ProtectedRoutePlanner;
+class GlidePolar;
 
 /**
  * Renders way point icons and labels into a #Canvas.
@@ -56,12 +63,108 @@ public:
     ReachableTerrain,
   };
 
+  /**
+   * The reachability of waypoints calculated by earlier render()
+   * calls.  It remains valid until one of the inputs of the
+   * calculation changes, usually with the next GPS fix; until then,
+   * redraws (e.g. while panning) need not calculate anything.
+   */
+  class ReachCache {
+  public:
+    /**
+     * The inputs the cached results were calculated with.
+     */
+    struct Key {
+      /**
+       * Were the results taken from the terrain reach of the route
+       * planner (or calculated by straight glide)?
+       */
+      bool route;
+
+      /** The Waypoints::GetSerial() value */
+      Serial waypoints_serial;
+
+      /** The terrain reach serial (for #route) */
+      Serial reach_serial;
+
+      /** The inputs of the straight glide (if not #route) */
+      GeoPoint location;
+      double altitude;
+      SpeedVector wind;
+      PolarCoefficients polar;
+      double mc, cruise_efficiency, v_max;
+
+      double safety_height;
+      bool reach_enabled;
+
+      gcc_pure
+      bool operator==(const Key &other) const;
+
+      bool operator!=(const Key &other) const {
+        return !(*this == other);
+      }
+    };
+
+    struct Entry {
+      ReachResult reach;
+      Reachability reachable;
+
+      Entry(const ReachResult &_reach, Reachability _reachable)
+        :reach(_reach), reachable(_reachable) {}
+    };
+
+  private:
+    Key key;
+    bool valid = false;
+
+    /**
+     * Maps Waypoint::id to its result.
+     */
+    OpenHashMap<unsigned, Entry> entries;
+
+  public:
+    /**
+     * Prepare for a calculation with the given inputs.  Discards all
+     * results if they have changed.
+     */
+    void Update(const Key &_key) {
+      if (valid && key == _key)
+        return;
+
+      entries.Clear();
+      key = _key;
+      valid = true;
+    }
+
+    void Clear() {
+      entries.Clear();
+      valid = false;
+    }
+
+    gcc_pure
+    const Entry *Find(unsigned id) const {
+      const auto i = entries.Find(id);
+      return i != entries.NOT_FOUND
+        ? &entries[i].value
+        : nullptr;
+    }
+
+    void Put(unsigned id, const ReachResult &reach, Reachability reachable) {
+      entries.Insert(id, Entry(reach, reachable));
+    }
+  };
+
+private:
+  ReachCache reach_cache;
+
+public:
   WaypointRenderer(const Waypoints *_way_points,
                    const WaypointLook &_look)
     :way_points(_way_points), look(_look) {}
 
   void set_way_points(const Waypoints *_way_points) {
     way_points = _way_points;
+    reach_cache.Clear();
   }
 
   void render(Canvas &canvas, LabelBlock &label_block,
@@ -28,6 +28,9 @@ Copyright_License {
 #include "Engine/Task/Points/TaskWaypoint.hpp"
 #include "Engine/Route/ReachResult.hpp"
 
+#include <algorithm>
+#include <memory>
+
 ProtectedTaskManager::ProtectedTaskManager(TaskManager &_task_manager,
                                            const TaskBehaviour &tb)
   :Guard<TaskManager>(_task_manager),
@@ -145,6 +148,16 @@ ProtectedTaskManager::SetRoutePlanner(const RoutePlannerGlue *_route) {
   lease->SetIntersectionTest(&intersection_test);
 }
 
+gcc_pure
+static bool
+IsTerrainIntersection(const ReachResult &result,
+                      const AGeoPoint &destination)
+{
+  return result.terrain_valid == ReachResult::Validity::UNREACHABLE ||
+    (result.terrain_valid == ReachResult::Validity::VALID &&
+     result.terrain < destination.altitude);
+}
+
 bool
 ReachIntersectionTest::Intersects(const AGeoPoint& destination)
 {
@@ -157,9 +170,24 @@ ReachIntersectionTest::Intersects(const AGeoPoint& destination)
 
   // we use find_positive_arrival here instead of is_inside, because may use
   // arrival height for sorting later
-  return result.terrain_valid == ReachResult::Validity::UNREACHABLE ||
-    (result.terrain_valid == ReachResult::Validity::VALID &&
-     result.terrain < destination.altitude);
+  return IsTerrainIntersection(result, destination);
+}
+
+void
+ReachIntersectionTest::Intersects(const AGeoPoint *destinations,
+                                  bool *results, unsigned n)
+{
+  std::fill_n(results, n, false);
+
+  if (!route)
+    return;
+
+  std::unique_ptr<ReachResult[]> reach(new ReachResult[n]);
+  if (!route->FindPositiveArrivals(destinations, reach.get(), n))
+    return;
+
+  for (unsigned i = 0; i < n; ++i)
+    results[i] = IsTerrainIntersection(reach[i], destinations[i]);
 }
 
 void
@@ -48,6 +48,8 @@ public:
   }
 
   virtual bool Intersects(const AGeoPoint& destination);
+  virtual void Intersects(const AGeoPoint *destinations, bool *results,
+                          unsigned n);
 };
 
 /**
@@ -0,0 +1,56 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+
+#ifndef XCSOAR_REACH_THREAD_POOL_HPP
+#define XCSOAR_REACH_THREAD_POOL_HPP
+
+#include "Engine/Route/FlatTriangleFanTree.hpp"
+#include "Thread/ThreadPool.hpp"
+
+/**
+ * A #ReachFanExecutor which runs the reach calculation on a
+ * #ThreadPool.  The calling thread participates, therefore the pool
+ * has one thread less than there are CPUs.
+ */
+class ReachThreadPool final : public ReachFanExecutor {
+  ThreadPool pool;
+
+public:
+  ReachThreadPool()
+    :pool("Reach", ThreadPool::GetProcessorCount() - 1) {}
+
+  /**
+   * Is it worth using this class on this machine?
+   */
+  static bool IsUseful() {
+    return ThreadPool::GetProcessorCount() >= 2;
+  }
+
+  /* virtual methods from class ReachFanExecutor */
+  void ForEach(unsigned n,
+               const std::function<void(unsigned)> &f) override {
+    pool.ForEach(n, f);
+  }
+};
+
+#endif
@@ -21,10 +21,28 @@
  */
 
 #include "RoutePlannerGlue.hpp"
+#include "ReachThreadPool.hpp"
 #include "Terrain/RasterTerrain.hpp"
 #include "Airspace/ActivePredicate.hpp"
+#include "Airspace/ProtectedAirspaceWarningManager.hpp"
+#include "Engine/Airspace/AirspaceWarningManager.hpp"
 #include "Engine/Airspace/Predicate/AirspacePredicate.hpp"
 
+RoutePlannerGlue::RoutePlannerGlue()
+  :terrain(nullptr)
+{
+  /* the reach is recalculated every few seconds; most of the time,
+     the aircraft has moved only a little since the last time */
+  planner.SetIncrementalReach(true);
+
+  if (ReachThreadPool::IsUseful()) {
+    reach_pool.reset(new ReachThreadPool());
+    planner.SetReachExecutor(reach_pool.get());
+  }
+}
+
+RoutePlannerGlue::~RoutePlannerGlue() = default;
+
 void
 RoutePlannerGlue::SetTerrain(const RasterTerrain *_terrain)
 {
@@ -49,7 +67,14 @@ RoutePlannerGlue::Synchronise(const Airspaces &master,
   const auto predicate =
     WrapAirspacePredicate(ActiveAirspacePredicate(warnings));
 
-  planner.Synchronise(master, predicate, origin, destination);
+  unsigned warnings_serial = 0;
+  if (warnings != nullptr) {
+    ProtectedAirspaceWarningManager::Lease lease(*warnings);
+    warnings_serial = lease->GetSerial();
+  }
+
+  planner.Synchronise(master, predicate, warnings_serial,
+                      origin, destination);
 }
 
 bool
@@ -84,6 +109,14 @@ RoutePlannerGlue::FindPositiveArrival(const AGeoPoint &dest,
   return planner.FindPositiveArrival(dest, result_r);
 }
 
+bool
+RoutePlannerGlue::FindPositiveArrivals(const AGeoPoint *destinations,
+                                       ReachResult *results,
+                                       unsigned n) const
+{
+  return planner.FindPositiveArrivals(destinations, results, n);
+}
+
 GeoPoint
 RoutePlannerGlue::Intersection(const AGeoPoint &origin,
                                const AGeoPoint &destination) const
@@ -25,16 +25,26 @@
 
 #include "Route/AirspaceRoute.hpp"
 
+#include <memory>
+
 struct GlideSettings;
 class RasterTerrain;
 class ProtectedAirspaceWarningManager;
+class ReachThreadPool;
 
 class RoutePlannerGlue {
   const RasterTerrain *terrain;
   AirspaceRoute planner;
 
+  /**
+   * Calculates the reach on all CPUs.  This is nullptr on single-CPU
+   * machines.
+   */
+  std::unique_ptr<ReachThreadPool> reach_pool;
+
 public:
-  RoutePlannerGlue():terrain(nullptr) {}
+  RoutePlannerGlue();
+  ~RoutePlannerGlue();
 
   void SetTerrain(const RasterTerrain *terrain);
 
@@ -78,6 +88,9 @@ public:
 
   bool FindPositiveArrival(const AGeoPoint &dest, ReachResult &result_r) const;
 
+  bool FindPositiveArrivals(const AGeoPoint *destinations,
+                            ReachResult *results, unsigned n) const;
+
   const FlatProjection &GetTerrainReachProjection() const {
     return planner.GetTerrainReachProjection();
   }
@@ -88,6 +101,10 @@ public:
     planner.AcceptInRange(bounds, visitor, working);
   }
 
+  Serial GetTerrainReachSerial() const {
+    return planner.GetTerrainReachSerial();
+  }
+
   gcc_pure
   GeoPoint Intersection(const AGeoPoint &origin,
                         const AGeoPoint &destination) const;
@@ -30,7 +30,12 @@ Copyright_License {
 #include "Projection/WindowProjection.hpp"
 #endif
 
+#include <algorithm>
+
 #include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 void
 HeightMatrix::SetSize(size_t _size)
@@ -77,6 +82,182 @@ HeightMatrix::Fill(const RasterMap &map, const GeoBounds &bounds,
 
 #else
 
+/**
+ * Reuse the old samples only if the new grid is less than this
+ * fraction of a cell away from a whole-cell translation.  The
+ * difference does not accumulate, because the grid keeps its
+ * original reference location.
+ */
+static constexpr double MAX_SHIFT_RESIDUAL = 0.25;
+
+gcc_const
+static Angle
+ClipLatitude(Angle latitude)
+{
+  /* same as in Projection::ScreenToGeo() */
+  return std::min(Angle::Degrees(80),
+                  std::max(Angle::Degrees(-80), latitude));
+}
+
+GeoPoint
+HeightMatrix::Grid::ToGeo(double x, double y) const
+{
+  GeoPoint g;
+  g.latitude = location.latitude -
+    Angle::Radians((y - origin_y) * angle_per_pixel);
+  g.longitude = location.longitude +
+    Angle::Radians((x - origin_x) * angle_per_pixel)
+    * ClipLatitude(g.latitude).invfastcosine();
+  return g;
+}
+
+/**
+ * Round the offset to whole cells.
+ *
+ * @return false if the offset is too far from a whole number
+ */
+static bool
+ToCells(double offset, int &cells_r)
+{
+  const double rounded = round(offset);
+  if (fabs(offset - rounded) > MAX_SHIFT_RESIDUAL)
+    return false;
+
+  cells_r = (int)rounded;
+  return true;
+}
+
+bool
+HeightMatrix::GetTranslation(const Grid &n, int &dx_r, int &dy_r) const
+{
+  if (grid.map == nullptr || grid.map != n.map || grid.serial != n.serial ||
+      grid.rotated || n.rotated ||
+      grid.angle_per_pixel != n.angle_per_pixel ||
+      grid.screen_width != n.screen_width ||
+      grid.screen_height != n.screen_height ||
+      grid.quantisation_pixels != n.quantisation_pixels ||
+      grid.interpolate != n.interpolate ||
+      width < 2 || height < 2)
+    return false;
+
+  const double row_height = n.quantisation_pixels;
+  const double column_width = double(n.screen_width) / width;
+
+  /* the latitude of a row depends only on its distance from the
+     origin */
+  const double row_offset = grid.origin_y - n.origin_y +
+    (grid.location.latitude - n.location.latitude).Radians()
+    / n.angle_per_pixel;
+  int dy;
+  if (!ToCells(row_offset / row_height, dy) || unsigned(abs(dy)) >= height)
+    return false;
+
+  /* the longitude scale depends on the latitude; the column offset
+     must be the same in the first and in the last row */
+  const Angle delta_longitude =
+    (n.location.longitude - grid.location.longitude).AsDelta();
+
+  int dx = 0;
+  for (unsigned row = 0; row < height; row += height - 1) {
+    const GeoPoint p = n.ToGeo(0, row * row_height);
+    const double column_offset = grid.origin_x - n.origin_x +
+      delta_longitude.Radians() /
+      (n.angle_per_pixel * ClipLatitude(p.latitude).invfastcosine());
+
+    int cells;
+    if (!ToCells(column_offset / column_width, cells) ||
+        (row > 0 && cells != dx))
+      return false;
+
+    dx = cells;
+  }
+
+  if (unsigned(abs(dx)) >= width)
+    return false;
+
+  dx_r = dx;
+  dy_r = dy;
+  return true;
+}
+
+void
+HeightMatrix::ScanRow(const RasterMap &map, TerrainHeight *row, double y,
+                      unsigned start_column, unsigned end_column) const
+{
+  assert(start_column < end_column);
+  assert(end_column <= width);
+  assert(width >= 2);
+
+  if (start_column == 0 && end_column == width) {
+    /* a whole row: scan it just like Fill() does */
+    map.ScanLine(grid.ToGeo(0, y), grid.ToGeo(grid.screen_width, y),
+                 row, width, grid.interpolate);
+    return;
+  }
+
+  const double column_width = double(grid.screen_width) / width;
+
+  if (end_column - start_column < 2) {
+    /* RasterMap::ScanLine() needs at least two samples; scan the
+       next column, too, but into a temporary buffer, so the known
+       sample there remains unchanged */
+    TerrainHeight buffer[2];
+    map.ScanLine(grid.ToGeo(start_column * column_width, y),
+                 grid.ToGeo((start_column + 1) * column_width, y),
+                 buffer, 2, grid.interpolate);
+    row[start_column] = buffer[0];
+    return;
+  }
+
+  /* RasterMap::ScanLine() puts its first and its last sample on the
+     end points of the line, so scan from the first to the last
+     column */
+  map.ScanLine(grid.ToGeo(start_column * column_width, y),
+               grid.ToGeo((end_column - 1) * column_width, y),
+               row + start_column, end_column - start_column,
+               grid.interpolate);
+}
+
+void
+HeightMatrix::Shift(const RasterMap &map, int dx, int dy)
+{
+  /* the new grid is the old one, moved by whole cells; keep the
+     reference location, so rounding errors do not accumulate */
+  grid.origin_x -= dx * (double(grid.screen_width) / width);
+  grid.origin_y -= dy * (double)grid.quantisation_pixels;
+
+  /* the range of columns which can be copied from the old row */
+  const unsigned copy_start = std::max(-dx, 0);
+  const unsigned copy_end = width - std::max(dx, 0);
+
+  /* walk in the direction which does not overwrite rows that are
+     still needed */
+  const int first = dy >= 0 ? 0 : height - 1;
+  const int step = dy >= 0 ? 1 : -1;
+
+  for (int i = 0, j = first; i < (int)height; ++i, j += step) {
+    TerrainHeight *row = data.begin() + j * width;
+    const double y = j * (double)grid.quantisation_pixels;
+
+    const int src_j = j + dy;
+    if (src_j < 0 || src_j >= (int)height) {
+      /* newly exposed row */
+      ScanRow(map, row, y, 0, width);
+      continue;
+    }
+
+    const TerrainHeight *src = data.begin() + src_j * width;
+    memmove(row + copy_start, src + copy_start + dx,
+            (copy_end - copy_start) * sizeof(*row));
+
+    /* newly exposed columns */
+    if (copy_start > 0)
+      ScanRow(map, row, y, 0, copy_start);
+    if (copy_end < width)
+      ScanRow(map, row, y, copy_end, width);
+  }
+}
+
 void
 HeightMatrix::Fill(const RasterMap &map, const WindowProjection &projection,
                    unsigned quantisation_pixels, bool interpolate)
@@ -84,6 +265,28 @@ HeightMatrix::Fill(const RasterMap &map, const WindowProjection &projection,
   const unsigned screen_width = projection.GetScreenWidth();
   const unsigned screen_height = projection.GetScreenHeight();
 
+  Grid new_grid;
+  new_grid.map = &map;
+  new_grid.serial = map.GetSerial();
+  new_grid.location = projection.GetGeoLocation();
+  new_grid.origin_x = projection.GetScreenOrigin().x;
+  new_grid.origin_y = projection.GetScreenOrigin().y;
+  new_grid.angle_per_pixel = projection.PixelsToAngle(1).Radians();
+  new_grid.screen_width = screen_width;
+  new_grid.screen_height = screen_height;
+  new_grid.quantisation_pixels = quantisation_pixels;
+  new_grid.interpolate = interpolate;
+  new_grid.rotated = projection.GetScreenAngle() != Angle::Zero();
+
+  int dx, dy;
+  if (GetTranslation(new_grid, dx, dy)) {
+    if (dx != 0 || dy != 0)
+      Shift(map, dx, dy);
+    return;
+  }
+
+  grid = new_grid;
+
   SetSize((screen_width + quantisation_pixels - 1) / quantisation_pixels,
           (screen_height + quantisation_pixels - 1) / quantisation_pixels);
 
@@ -26,6 +26,12 @@ Copyright_License {
 
 #include "Height.hpp"
 #include "Util/AllocatedArray.hxx"
+#include "Compiler.h"
+
+#ifndef ENABLE_OPENGL
+#include "Geo/GeoPoint.hpp"
+#include "Util/Serial.hpp"
+#endif
 
 class RasterMap;
 
@@ -39,6 +45,58 @@ class HeightMatrix {
   AllocatedArray<TerrainHeight> data;
   unsigned width, height;
 
+#ifndef ENABLE_OPENGL
+  /**
+   * Describes the geographic locations which were sampled by the
+   * last Fill() call.  It is used to detect whether the next call
+   * differs only by a translation, so the old samples can be reused.
+   */
+  struct Grid {
+    /**
+     * The #RasterMap which was sampled; nullptr if the grid is
+     * undefined.
+     */
+    const RasterMap *map = nullptr;
+
+    /**
+     * The #RasterMap serial at the time of sampling.
+     */
+    Serial serial;
+
+    /**
+     * The location at #origin_x, #origin_y.
+     */
+    GeoPoint location;
+
+    /**
+     * The screen position of #location; may be fractional after the
+     * matrix has been shifted.
+     */
+    double origin_x, origin_y;
+
+    /**
+     * The map scale in radians per pixel.
+     */
+    double angle_per_pixel;
+
+    unsigned screen_width, screen_height;
+    unsigned quantisation_pixels;
+    bool interpolate;
+
+    /**
+     * Was the screen rotated?  Shifting works only north-up.
+     */
+    bool rotated;
+
+    /**
+     * Convert a screen position to a geographic location, just like
+     * Projection::ScreenToGeo() does without rotation.
+     */
+    gcc_pure
+    GeoPoint ToGeo(double x, double y) const;
+  } grid;
+#endif
+
 public:
   HeightMatrix():width(0), height(0) {}
 
@@ -59,10 +117,38 @@ public:
             unsigned _width, unsigned _height, bool interpolate);
 #else
   /**
+   * If the projection differs from the previous call only by a
+   * translation (north-up, same scale), the existing samples are
+   * shifted and only the newly exposed rows and columns are sampled.
+   *
    * @param interpolate true enables interpolation of sub-pixel values
    */
   void Fill(const RasterMap &map, const WindowProjection &map_projection,
             unsigned quantisation_pixels, bool interpolate);
+
+private:
+  /**
+   * Check whether the new grid is the current one moved by a whole
+   * number of cells.
+   *
+   * @param dx_r the column offset of the new grid within the current
+   * one
+   * @param dy_r the row offset of the new grid within the current
+   * one
+   */
+  gcc_pure
+  bool GetTranslation(const Grid &new_grid, int &dx_r, int &dy_r) const;
+
+  /**
+   * Move the samples by the specified number of cells and sample the
+   * exposed rows and columns.
+   */
+  void Shift(const RasterMap &map, int dx, int dy);
+
+  void ScanRow(const RasterMap &map, TerrainHeight *row, double y,
+               unsigned start_column, unsigned end_column) const;
+
+public:
 #endif
 
   unsigned GetWidth() const {
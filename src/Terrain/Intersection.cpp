@@ -24,14 +24,100 @@ Copyright_License {
 #include "RasterTileCache.hpp"
 #include "Terrain/RasterLocation.hpp"
 
-#include <stdlib.h>
 #include <algorithm>
 
+#include <stdlib.h>
+#include <limits.h>
+
 //#define DEBUG_TILE
 #ifdef DEBUG_TILE
 #include <stdio.h>
 #endif
 
+/**
+ * Returns the number of steps of the line algorithm after which the
+ * line may have left the given rectangle (the upper bounds are
+ * exclusive).  This is a lower bound, because each step moves only
+ * one axis.
+ *
+ * @param sx the direction on the x axis; 0 if the line is vertical
+ * @param sy the direction on the y axis; 0 if the line is horizontal
+ */
+static constexpr unsigned
+StepsToLeave(unsigned x, unsigned y, int sx, int sy,
+             unsigned x0, unsigned y0, unsigned x1, unsigned y1)
+{
+  return std::min(sx > 0 ? x1 - x : (sx < 0 ? x - x0 + 1 : UINT_MAX),
+                  sy > 0 ? y1 - y : (sy < 0 ? y - y0 + 1 : UINT_MAX));
+}
+
+/**
+ * Advance the line algorithm by the given number of steps at once.
+ * The new location is on the ideal line, and each axis advances by
+ * no more than #n pixels.
+ */
+template<typename L>
+static void
+SkipSteps(L &location, int &err, int &total_steps, int n,
+          const SignedRasterLocation origin,
+          int dx, int dy, int sx, int sy)
+{
+  const int old_x = abs(int(location.x) - origin.x);
+
+  total_steps += n;
+
+  int nx = int((int64_t(total_steps) * dx + (dx + dy) / 2) / (dx + dy));
+  nx = std::max(old_x, std::min(nx, old_x + n));
+  const int ny = total_steps - nx;
+
+  location.x = origin.x + sx * nx;
+  location.y = origin.y + sy * ny;
+  err = dx - dy - nx * dy + ny * dx;
+}
+
+/**
+ * Determine how many steps of the line algorithm starting at the
+ * given pixel can be walked without sampling the terrain, because
+ * they stay inside one block of the tile's #MaxElevationIndex which
+ * is clear of the glide path.  The largest such block is used.
+ *
+ * @param max_steps the number of remaining steps
+ * @param is_clear a function which checks whether terrain up to the
+ * given elevation is clear of the glide path during the given number
+ * of steps
+ * @return the number of steps; 0 if no block is clear
+ */
+template<typename F>
+static unsigned
+CountClearSteps(const RasterTile &tile, unsigned x, unsigned y,
+                int sx, int sy, unsigned max_steps, F &&is_clear)
+{
+  const MaxElevationIndex &index = tile.GetMaxElevationIndex();
+
+  unsigned n = std::min(StepsToLeave(x, y, sx, sy,
+                                     tile.xstart, tile.ystart,
+                                     tile.xend, tile.yend),
+                        max_steps);
+  if (is_clear(index.GetMaximum(), n))
+    return n;
+
+  const unsigned rx = x - tile.xstart, ry = y - tile.ystart;
+
+  for (int level = MaxElevationIndex::LEVELS - 1; level >= 0; --level) {
+    const unsigned bits = MaxElevationIndex::GetBlockBits(level);
+    const unsigned x0 = tile.xstart + ((rx >> bits) << bits);
+    const unsigned y0 = tile.ystart + ((ry >> bits) << bits);
+    const unsigned x1 = std::min(x0 + (1u << bits), tile.xend);
+    const unsigned y1 = std::min(y0 + (1u << bits), tile.yend);
+
+    n = std::min(StepsToLeave(x, y, sx, sy, x0, y0, x1, y1), max_steps);
+    if (is_clear(index.GetMaximum(level, rx, ry), n))
+      return n;
+  }
+
+  return 0;
+}
+
 bool
 RasterTileCache::FirstIntersection(const SignedRasterLocation origin,
                                    const SignedRasterLocation destination,
@@ -184,6 +270,35 @@ RasterTileCache::FirstIntersection(const SignedRasterLocation origin,
         } else {
           last_clear_location = location;
           last_clear_h = h_int;
+
+          if (field_direct.second && total_steps < max_steps) {
+            /* skip blocks whose terrain is entirely below the glide
+               path, which does not descend */
+            const RasterTile &tile = tiles.Get(location.x / tile_width,
+                                               location.y / tile_height);
+            const unsigned n =
+              CountClearSteps(tile, location.x, location.y,
+                              dx > 0 ? sx : 0, dy > 0 ? sy : 0,
+                              max_steps - total_steps,
+                              [=](int h_max, unsigned steps){
+                                if (h_max + h_safety >= h_int)
+                                  return false;
+
+                                /* don't skip past the ceiling */
+                                int h_end = h_origin +
+                                  (((total_steps + int(steps)) * slope_fact)
+                                   >> RASTER_SLOPE_FACT);
+                                if (can_climb)
+                                  h_end = std::min(h_end, h_dest);
+                                return h_end <= h_ceiling;
+                              });
+            if (n > step_counter) {
+              SkipSteps(location, err, total_steps, n,
+                        origin, dx, dy, sx, sy);
+              step_counter = 0;
+              continue;
+            }
+          }
         }
       }
     }
@@ -331,6 +446,38 @@ RasterTileCache::Intersection(const SignedRasterLocation origin,
 
       last_clear_location = location;
       last_clear_h = h_int;
+
+      if (field_direct.second && total_steps < max_steps) {
+        /* skip blocks whose terrain is entirely below the glide path
+           at the end of the block */
+        const RasterTile &tile = tiles.Get(location.x / tile_width,
+                                           location.y / tile_height);
+        const unsigned n =
+          CountClearSteps(tile, location.x, location.y,
+                          dx > 0 ? sx : 0, dy > 0 ? sy : 0,
+                          max_steps - total_steps,
+                          [=](int h_max, unsigned steps){
+                            const int h_end = h_origin -
+                              (((total_steps + int(steps)) * slope_fact)
+                               >> RASTER_SLOPE_FACT);
+                            return h_end > 0 &&
+                              h_end > std::max(h_max, height_floor);
+                          });
+        if (n > step_counter) {
+          /* stop at the last step inside the block: it is known to
+             be clear, so a refinement after the next sample covers
+             only a short section (starting a refinement before the
+             block would not converge) */
+          SkipSteps(location, err, total_steps, n - 1,
+                    origin, dx, dy, sx, sy);
+          last_clear_location = location;
+          last_clear_h = h_origin -
+            ((total_steps * slope_fact) >> RASTER_SLOPE_FACT);
+
+          /* take one regular step to leave the block, then sample */
+          step_counter = 1;
+        }
+      }
     }
 
     if (total_steps > max_steps)
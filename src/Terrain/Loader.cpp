@@ -28,6 +28,7 @@ Copyright_License {
 #include "WorldFile.hpp"
 #include "Operation/Operation.hpp"
 #include "OS/ConvertPathName.hpp"
+#include "Thread/ThreadPool.hpp"
 
 extern "C" {
 #include "jasper/jp2/jp2_cod.h"
@@ -182,8 +183,32 @@ TerrainLoader::PutTileData(unsigned index,
   }
 }
 
+bool
+TerrainLoader::SubmitTile(void *dec, void *tile)
+{
+  if (decode_pool == nullptr)
+    return false;
+
+  decode_pool->Submit([this, dec, tile](){
+      if (jpc_dec_tiledecodefini((jpc_dec_t *)dec,
+                                 (jpc_dec_tile_t *)tile) != 0)
+        decode_failed = true;
+    });
+
+  return true;
+}
+
+bool
+TerrainLoader::WaitTiles()
+{
+  if (decode_pool != nullptr)
+    decode_pool->Wait();
+
+  return !decode_failed;
+}
+
 static bool
-LoadJPG2000(jas_stream_t *in, void *loader)
+LoadJPG2000(jas_stream_t *in, TerrainLoader &loader)
 {
   /* Get the first box.  This should be a JP box. */
   auto box = jp2_box_get(in);
@@ -230,9 +255,15 @@ LoadJPG2000(jas_stream_t *in, void *loader)
   if (dec == nullptr)
     return false;
 
-  dec->loader = loader;
+  dec->loader = &loader;
 
   bool success = jpc_dec_decode(dec) == 0;
+
+  /* the tiles must be decoded completely before the decoder can be
+     destroyed */
+  if (!loader.WaitTiles())
+    success = false;
+
   jpc_dec_destroy(dec);
   return success;
 }
@@ -246,11 +277,28 @@ TerrainLoader::LoadJPG2000(struct zzip_dir *dir, const char *path)
 
   env.SetProgressRange(jas_stream_length(in) / 65536);
 
-  bool success = ::LoadJPG2000(in, this);
+  decode_failed = false;
+
+  bool success = ::LoadJPG2000(in, *this);
   jas_stream_close(in);
   return success;
 }
 
+inline bool
+TerrainLoader::LoadJPG2000Parallel(struct zzip_dir *dir, const char *path)
+{
+  if (decode_pool != nullptr || ThreadPool::GetProcessorCount() < 2)
+    return LoadJPG2000(dir, path);
+
+  ThreadPool pool("TerrainDecode", 0, 0, true);
+
+  decode_pool = &pool;
+  bool success = LoadJPG2000(dir, path);
+  decode_pool = nullptr;
+
+  return success;
+}
+
 static bool
 LoadWorldFile(RasterTileCache &tile_cache,
               struct zzip_dir *dir, const char *path)
@@ -274,7 +322,7 @@ TerrainLoader::LoadOverview(struct zzip_dir *dir,
 
   raster_tile_cache.Reset();
 
-  bool success = LoadJPG2000(dir, path);
+  bool success = LoadJPG2000Parallel(dir, path);
 
   /* if we loaded the JPG2000 file successfully, but no bounds were
      obtained from there, try to load the world file "terrain.j2w" */
@@ -295,26 +343,47 @@ LoadTerrainOverview(struct zzip_dir *dir,
                     const char *path, const char *world_file,
                     RasterTileCache &raster_tile_cache,
                     bool all,
-                    OperationEnvironment &env)
+                    OperationEnvironment &env,
+                    ThreadPool *decode_pool)
 {
   /* fake a mutex - we don't need it for LoadTerrainOverview() */
   SharedMutex mutex;
 
-  TerrainLoader loader(mutex, raster_tile_cache, true, all, env);
+  TerrainLoader loader(mutex, raster_tile_cache, true, all, env,
+                       decode_pool);
   return loader.LoadOverview(dir, path, world_file);
 }
 
 inline bool
 TerrainLoader::UpdateTiles(struct zzip_dir *dir, const char *path,
-                           int x, int y, unsigned radius)
+                           int x, int y, unsigned radius,
+                           const RasterPrefetchPath *prefetch)
 {
   assert(!scan_overview);
 
-  if (!raster_tile_cache.PollTiles(x, y, radius))
+  const bool poll = prefetch != nullptr
+    ? raster_tile_cache.PollTiles(x, y, radius, *prefetch)
+    : raster_tile_cache.PollTiles(x, y, radius);
+  if (!poll)
     /* nothing to do */
     return true;
 
-  bool success = LoadJPG2000(dir, path);
+  bool need_decode;
+  {
+    const ScopeExclusiveLock lock(mutex);
+    need_decode = raster_tile_cache.LoadStoredTiles();
+  }
+
+  if (!need_decode) {
+    /* all requested tiles were found in the tile store */
+    raster_tile_cache.FinishTileUpdate();
+    return true;
+  }
+
+  const auto start_time = std::chrono::steady_clock::now();
+  bool success = LoadJPG2000Parallel(dir, path);
+  raster_tile_cache.AddDecodeTime(std::chrono::steady_clock::now() -
+                                  start_time);
   raster_tile_cache.FinishTileUpdate();
   return success;
 }
@@ -322,13 +391,15 @@ TerrainLoader::UpdateTiles(struct zzip_dir *dir, const char *path,
 bool
 UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
-                   int x, int y, unsigned radius)
+                   int x, int y, unsigned radius,
+                   ThreadPool *decode_pool)
 {
   if (!raster_tile_cache.IsValid())
     return false;
 
   NullOperationEnvironment env;
-  TerrainLoader loader(mutex, raster_tile_cache, false, true, env);
+  TerrainLoader loader(mutex, raster_tile_cache, false, true, env,
+                       decode_pool);
   return loader.UpdateTiles(dir, path, x, y, radius);
 }
 
@@ -336,11 +407,41 @@ bool
 UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
                    const RasterProjection &projection,
-                   const GeoPoint &location, double radius)
+                   const GeoPoint &location, double radius,
+                   ThreadPool *decode_pool)
 {
   const auto raster_location = projection.ProjectCoarse(location);
 
   return UpdateTerrainTiles(dir, path, raster_tile_cache, mutex,
                             raster_location.x, raster_location.y,
-                            projection.DistancePixelsCoarse(radius));
+                            projection.DistancePixelsCoarse(radius),
+                            decode_pool);
+}
+
+bool
+UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
+                   RasterTileCache &raster_tile_cache, SharedMutex &mutex,
+                   const RasterProjection &projection,
+                   const GeoPoint &location, double radius,
+                   const GeoPoint &prefetch_start,
+                   const GeoPoint &prefetch_end, double prefetch_radius,
+                   ThreadPool *decode_pool)
+{
+  if (!raster_tile_cache.IsValid())
+    return false;
+
+  const auto raster_location = projection.ProjectCoarse(location);
+
+  RasterPrefetchPath prefetch;
+  prefetch.start = projection.ProjectCoarse(prefetch_start);
+  prefetch.end = projection.ProjectCoarse(prefetch_end);
+  prefetch.radius = projection.DistancePixelsCoarse(prefetch_radius);
+
+  NullOperationEnvironment env;
+  TerrainLoader loader(mutex, raster_tile_cache, false, true, env,
+                       decode_pool);
+  return loader.UpdateTiles(dir, path,
+                            raster_location.x, raster_location.y,
+                            projection.DistancePixelsCoarse(radius),
+                            &prefetch);
 }
@@ -26,11 +26,15 @@ Copyright_License {
 
 #include "Thread/SharedMutex.hpp"
 
+#include <atomic>
+
 struct zzip_dir;
 struct GeoPoint;
+struct RasterPrefetchPath;
 class RasterTileCache;
 class RasterProjection;
 class OperationEnvironment;
+class ThreadPool;
 
 class TerrainLoader {
   SharedMutex &mutex;
@@ -46,19 +50,40 @@ class TerrainLoader {
    */
   mutable unsigned remaining_segments = 0;
 
+  /**
+   * If set, then tiles are decoded in these threads, see
+   * SubmitTile().
+   */
+  ThreadPool *decode_pool;
+
+  /**
+   * Has decoding a tile in the #decode_pool failed?
+   */
+  std::atomic_bool decode_failed{false};
+
 public:
+  /**
+   * @param _decode_pool a long-lived pool which decodes the tiles;
+   * if nullptr, a temporary pool is created for each file
+   */
   TerrainLoader(SharedMutex &_mutex, RasterTileCache &_rtc,
                 bool _scan_overview, bool _scan_all,
-                OperationEnvironment &_env)
+                OperationEnvironment &_env,
+                ThreadPool *_decode_pool=nullptr)
     :mutex(_mutex), raster_tile_cache(_rtc),
      scan_overview(_scan_overview),
      scan_tiles(!_scan_overview || _scan_all),
-     env(_env) {}
+     env(_env), decode_pool(_decode_pool) {}
 
   bool LoadOverview(struct zzip_dir *dir,
                     const char *path, const char *world_file);
+  /**
+   * @param prefetch an optional corridor along the predicted flight
+   * path whose tiles are loaded with a lower priority
+   */
   bool UpdateTiles(struct zzip_dir *dir, const char *path,
-                   int x, int y, unsigned radius);
+                   int x, int y, unsigned radius,
+                   const RasterPrefetchPath *prefetch=nullptr);
 
   /* callback methods for libjasper (via jas_rtc.cpp) */
 
@@ -78,8 +103,29 @@ public:
                    unsigned end_x, unsigned end_y,
                    const struct jas_matrix &m);
 
+  /**
+   * @param dec a jpc_dec_t pointer
+   * @param tile a jpc_dec_tile_t pointer
+   * @return true if the tile will be decoded by the #decode_pool
+   */
+  bool SubmitTile(void *dec, void *tile);
+
+  /**
+   * Wait until all tiles passed to SubmitTile() are decoded.
+   *
+   * @return false if decoding one of them has failed
+   */
+  bool WaitTiles();
+
 private:
   bool LoadJPG2000(struct zzip_dir *dir, const char *path);
+
+  /**
+   * Like LoadJPG2000(), but decode the tiles in parallel: in the
+   * #decode_pool if one was given, else in a temporary pool if there
+   * are several CPUs.
+   */
+  bool LoadJPG2000Parallel(struct zzip_dir *dir, const char *path);
   void ParseBounds(const char *data);
 };
 
@@ -87,51 +133,94 @@ private:
  * @param all load not only overview, but all tiles?  On large files,
  * this is a very expensive operation.  This option was designed for
  * small RASP files only.
+ * @param decode_pool an optional long-lived pool which decodes the
+ * tiles, see #TerrainLoader
  */
 bool
 LoadTerrainOverview(struct zzip_dir *dir,
                     const char *path, const char *world_file,
                     RasterTileCache &raster_tile_cache,
                     bool all,
-                    OperationEnvironment &env);
+                    OperationEnvironment &env,
+                    ThreadPool *decode_pool=nullptr);
 
 static inline bool
 LoadTerrainOverview(struct zzip_dir *dir,
                     RasterTileCache &tile_cache,
-                    OperationEnvironment &env)
+                    OperationEnvironment &env,
+                    ThreadPool *decode_pool=nullptr)
 {
   return LoadTerrainOverview(dir, "terrain.jp2", "terrain.j2w",
-                             tile_cache, false, env);
+                             tile_cache, false, env, decode_pool);
+}
+
+/**
+ * @param decode_pool an optional long-lived pool which decodes the
+ * tiles; callers which update repeatedly should pass one, to avoid
+ * starting new threads for each update
+ */
+bool
+UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
+                   RasterTileCache &raster_tile_cache, SharedMutex &mutex,
+                   int x, int y, unsigned radius,
+                   ThreadPool *decode_pool=nullptr);
+
+static inline bool
+UpdateTerrainTiles(struct zzip_dir *dir,
+                   RasterTileCache &tile_cache, SharedMutex &mutex,
+                   int x, int y, unsigned radius,
+                   ThreadPool *decode_pool=nullptr)
+{
+  return UpdateTerrainTiles(dir, "terrain.jp2", tile_cache, mutex,
+                            x, y, radius, decode_pool);
 }
 
 bool
 UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
-                   int x, int y, unsigned radius);
+                   const RasterProjection &projection,
+                   const GeoPoint &location, double radius,
+                   ThreadPool *decode_pool=nullptr);
 
 static inline bool
 UpdateTerrainTiles(struct zzip_dir *dir,
                    RasterTileCache &tile_cache, SharedMutex &mutex,
-                   int x, int y, unsigned radius)
+                   const RasterProjection &projection,
+                   const GeoPoint &location, double radius,
+                   ThreadPool *decode_pool=nullptr)
 {
   return UpdateTerrainTiles(dir, "terrain.jp2", tile_cache, mutex,
-                            x, y, radius);
+                            projection, location, radius, decode_pool);
 }
 
+/**
+ * Like UpdateTerrainTiles(), but additionally load (with a lower
+ * priority) all tiles within #prefetch_radius of the line from
+ * #prefetch_start to #prefetch_end, i.e. along the predicted flight
+ * path.
+ */
 bool
 UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
                    const RasterProjection &projection,
-                   const GeoPoint &location, double radius);
+                   const GeoPoint &location, double radius,
+                   const GeoPoint &prefetch_start,
+                   const GeoPoint &prefetch_end, double prefetch_radius,
+                   ThreadPool *decode_pool=nullptr);
 
 static inline bool
 UpdateTerrainTiles(struct zzip_dir *dir,
                    RasterTileCache &tile_cache, SharedMutex &mutex,
                    const RasterProjection &projection,
-                   const GeoPoint &location, double radius)
+                   const GeoPoint &location, double radius,
+                   const GeoPoint &prefetch_start,
+                   const GeoPoint &prefetch_end, double prefetch_radius,
+                   ThreadPool *decode_pool=nullptr)
 {
   return UpdateTerrainTiles(dir, "terrain.jp2", tile_cache, mutex,
-                            projection, location, radius);
+                            projection, location, radius,
+                            prefetch_start, prefetch_end, prefetch_radius,
+                            decode_pool);
 }
 
 #endif
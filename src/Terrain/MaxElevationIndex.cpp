@@ -0,0 +1,96 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "MaxElevationIndex.hpp"
+#include "RasterBuffer.hpp"
+
+#include <algorithm>
+
+static constexpr int16_t
+ToIndexValue(TerrainHeight h)
+{
+  return h.IsInvalid()
+    ? MaxElevationIndex::UNKNOWN
+    : h.GetValueOr0();
+}
+
+void
+MaxElevationIndex::Build(const RasterBuffer &buffer)
+{
+  assert(buffer.IsDefined());
+  assert(buffer.GetWidth() > 0 && buffer.GetHeight() > 0);
+
+  const unsigned width = buffer.GetWidth(), height = buffer.GetHeight();
+
+  /* level 0: scan all pixels */
+
+  constexpr unsigned bits = GetBlockBits(0);
+  Level &first = levels[0];
+  first.width = ((width - 1) >> bits) + 1;
+  unsigned rows = ((height - 1) >> bits) + 1;
+  first.data.ResizeDiscard(first.width * rows);
+  std::fill(first.data.begin(), first.data.end(), INT16_MIN);
+
+  const TerrainHeight *src = buffer.GetData();
+  for (unsigned y = 0; y < height; ++y) {
+    int16_t *row = &first.data[(y >> bits) * first.width];
+    for (unsigned x = 0; x < width; ++x, ++src) {
+      int16_t &m = row[x >> bits];
+      m = std::max(m, ToIndexValue(*src));
+    }
+  }
+
+  /* the coarser levels combine blocks of the previous one */
+
+  for (unsigned i = 1; i < LEVELS; ++i) {
+    const Level &previous = levels[i - 1];
+    Level &l = levels[i];
+
+    const unsigned previous_rows = rows;
+    l.width = ((previous.width - 1) >> LEVEL_BITS) + 1;
+    rows = ((previous_rows - 1) >> LEVEL_BITS) + 1;
+    l.data.ResizeDiscard(l.width * rows);
+    std::fill(l.data.begin(), l.data.end(), INT16_MIN);
+
+    for (unsigned y = 0; y < previous_rows; ++y) {
+      const int16_t *p = &previous.data[y * previous.width];
+      int16_t *row = &l.data[(y >> LEVEL_BITS) * l.width];
+      for (unsigned x = 0; x < previous.width; ++x) {
+        int16_t &m = row[x >> LEVEL_BITS];
+        m = std::max(m, p[x]);
+      }
+    }
+  }
+
+  const Level &last = levels[LEVELS - 1];
+  maximum = *std::max_element(last.data.begin(), last.data.end());
+}
+
+void
+MaxElevationIndex::Reset()
+{
+  for (auto &l : levels)
+    l.data.ResizeDiscard(0);
+
+  maximum = UNKNOWN;
+}
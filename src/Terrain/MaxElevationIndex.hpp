@@ -0,0 +1,102 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_MAX_ELEVATION_INDEX_HPP
+#define XCSOAR_TERRAIN_MAX_ELEVATION_INDEX_HPP
+
+#include "Util/AllocatedArray.hxx"
+#include "Compiler.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+class RasterBuffer;
+
+/**
+ * A hierarchy of maximum elevations of square blocks within a
+ * #RasterBuffer.  It allows line-of-sight searches to skip whole
+ * blocks whose terrain is lower than the glide path.
+ *
+ * Level 0 has blocks of 2^#MIN_BITS pixels; each further level
+ * combines 2^#LEVEL_BITS x 2^#LEVEL_BITS blocks of the previous one.
+ * Water counts as 0 m.
+ */
+class MaxElevationIndex {
+public:
+  static constexpr unsigned LEVELS = 3;
+  static constexpr unsigned MIN_BITS = 3;
+  static constexpr unsigned LEVEL_BITS = 2;
+
+  /**
+   * The value stored for blocks which contain invalid pixels.  It is
+   * higher than any real terrain, so these blocks are never skipped.
+   */
+  static constexpr int16_t UNKNOWN = INT16_MAX;
+
+private:
+  struct Level {
+    AllocatedArray<int16_t> data;
+    unsigned width;
+  };
+
+  Level levels[LEVELS];
+
+  int16_t maximum = UNKNOWN;
+
+public:
+  static constexpr unsigned GetBlockBits(unsigned level) {
+    return MIN_BITS + level * LEVEL_BITS;
+  }
+
+  /**
+   * Calculate the index of the given buffer.
+   */
+  void Build(const RasterBuffer &buffer);
+
+  /**
+   * Free all memory.
+   */
+  void Reset();
+
+  /**
+   * Returns the maximum elevation of the whole buffer.
+   */
+  int GetMaximum() const {
+    return maximum;
+  }
+
+  /**
+   * Returns the maximum elevation of the block of the given level
+   * containing the specified pixel.
+   */
+  gcc_pure
+  int GetMaximum(unsigned level, unsigned x, unsigned y) const {
+    assert(level < LEVELS);
+
+    const Level &l = levels[level];
+    const unsigned bits = GetBlockBits(level);
+    return l.data[(y >> bits) * l.width + (x >> bits)];
+  }
+};
+
+#endif
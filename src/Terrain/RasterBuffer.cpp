@@ -33,7 +33,23 @@ RasterBuffer::Resize(unsigned _width, unsigned _height)
 {
   assert(_width > 0 && _height > 0);
 
-  data.GrowDiscard(_width, _height);
+  allocation.GrowDiscard(_width * _height);
+  data = allocation.begin();
+  width = _width;
+  height = _height;
+}
+
+void
+RasterBuffer::SetShared(TerrainHeight *_data,
+                        unsigned _width, unsigned _height)
+{
+  assert(_data != nullptr);
+  assert(_width > 0 && _height > 0);
+
+  allocation.ResizeDiscard(0);
+  data = _data;
+  width = _width;
+  height = _height;
 }
 
 TerrainHeight
@@ -263,7 +279,7 @@ TerrainHeight
 RasterBuffer::GetMaximum() const
 {
   return IsDefined()
-    ? *std::max_element(data.begin(), data.end(),
+    ? *std::max_element(data, data + width * height,
                         [](TerrainHeight a, TerrainHeight b) {
                           return a.GetValue() < b.GetValue();
                         })
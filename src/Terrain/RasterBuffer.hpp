@@ -26,32 +26,54 @@ Copyright_License {
 
 #include "RasterTraits.hpp"
 #include "Height.hpp"
-#include "Util/AllocatedGrid.hxx"
+#include "Util/AllocatedArray.hxx"
 #include "Compiler.h"
 
+#include <assert.h>
 #include <stdint.h>
 
 class RasterBuffer {
-  AllocatedGrid<TerrainHeight> data;
+  /**
+   * The memory owned by this object.  It is empty if the buffer is
+   * undefined or if it refers to shared memory (see SetShared()).
+   */
+  AllocatedArray<TerrainHeight> allocation;
+
+  /**
+   * Pointer to the first pixel.  This points into #allocation or
+   * into memory owned by somebody else, e.g. a memory-mapped
+   * #TerrainTileStore.
+   */
+  TerrainHeight *data = nullptr;
+
+  unsigned width = 0, height = 0;
 
 public:
   RasterBuffer() = default;
   RasterBuffer(unsigned _width, unsigned _height)
-    :data(_width, _height) {}
+    :allocation(_width * _height), data(allocation.begin()),
+     width(_width), height(_height) {}
 
   RasterBuffer(const RasterBuffer &) = delete;
   RasterBuffer &operator=(const RasterBuffer &) = delete;
 
   bool IsDefined() const {
-    return data.IsDefined();
+    return data != nullptr;
+  }
+
+  /**
+   * Does this object refer to memory it does not own?
+   */
+  bool IsShared() const {
+    return data != nullptr && allocation.empty();
   }
 
   unsigned GetWidth() const {
-    return data.GetWidth();
+    return width;
   }
 
   unsigned GetHeight() const {
-    return data.GetHeight();
+    return height;
   }
 
   unsigned GetFineWidth() const {
@@ -63,23 +85,35 @@ public:
   }
 
   TerrainHeight *GetData() {
-    return data.begin();
+    return data;
   }
 
   const TerrainHeight *GetData() const {
-    return data.begin();
+    return data;
   }
 
   const TerrainHeight *GetDataAt(unsigned x, unsigned y) const {
-    return data.GetPointerAt(x, y);
+    assert(x < width);
+    assert(y < height);
+
+    return data + y * width + x;
   }
 
   void Reset() {
-    data.Reset();
+    allocation.ResizeDiscard(0);
+    data = nullptr;
+    width = height = 0;
   }
 
   void Resize(unsigned _width, unsigned _height);
 
+  /**
+   * Use the given memory instead of allocating a private buffer.
+   * The caller is responsible for keeping it valid until Reset() or
+   * Resize() is called.
+   */
+  void SetShared(TerrainHeight *_data, unsigned _width, unsigned _height);
+
   gcc_pure
   TerrainHeight GetInterpolated(unsigned lx, unsigned ly,
                                 unsigned ix, unsigned iy) const;
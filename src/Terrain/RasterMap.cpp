@@ -27,6 +27,7 @@ Copyright_License {
 
 #include <algorithm>
 #include <assert.h>
+#include <stdint.h>
 
 void
 RasterMap::UpdateProjection()
@@ -60,6 +61,82 @@ RasterMap::GetInterpolatedHeight(const GeoPoint &location) const
   return raster_tile_cache.GetInterpolatedHeight(pt.x, pt.y);
 }
 
+/**
+ * The number of points which are projected in one chunk by the batch
+ * lookup methods.
+ */
+static constexpr unsigned HEIGHT_BATCH_SIZE = 64;
+
+void
+RasterMap::GetHeights(const GeoPoint *locations, TerrainHeight *heights,
+                      unsigned n) const
+{
+  SignedRasterLocation points[HEIGHT_BATCH_SIZE];
+
+  while (n > 0) {
+    const unsigned chunk = std::min(n, HEIGHT_BATCH_SIZE);
+    projection.ProjectFine(locations, points, chunk);
+    for (unsigned i = 0; i < chunk; ++i)
+      points[i] = points[i] >> RasterTraits::SUBPIXEL_BITS;
+
+    raster_tile_cache.GetHeights(points, heights, chunk);
+
+    locations += chunk;
+    heights += chunk;
+    n -= chunk;
+  }
+}
+
+void
+RasterMap::GetInterpolatedHeights(const GeoPoint *locations,
+                                  TerrainHeight *heights, unsigned n) const
+{
+  SignedRasterLocation points[HEIGHT_BATCH_SIZE];
+
+  while (n > 0) {
+    const unsigned chunk = std::min(n, HEIGHT_BATCH_SIZE);
+    projection.ProjectFine(locations, points, chunk);
+    raster_tile_cache.GetInterpolatedHeights(points, heights, chunk);
+
+    locations += chunk;
+    heights += chunk;
+    n -= chunk;
+  }
+}
+
+void
+RasterMap::GetLineHeights(const GeoPoint &start, const GeoPoint &end,
+                          TerrainHeight *heights, unsigned n,
+                          bool interpolate) const
+{
+  assert(n > 0);
+
+  /* the projection is linear in latitude and longitude, so only the
+     two end points need to be projected */
+  const SignedRasterLocation a = projection.ProjectFine(start);
+  const SignedRasterLocation b = projection.ProjectFine(end);
+  const int64_t dx = b.x - a.x, dy = b.y - a.y;
+  const unsigned divisor = std::max(n - 1, 1u);
+
+  SignedRasterLocation points[HEIGHT_BATCH_SIZE];
+
+  for (unsigned offset = 0; offset < n; offset += HEIGHT_BATCH_SIZE) {
+    const unsigned chunk = std::min(n - offset, HEIGHT_BATCH_SIZE);
+    for (unsigned i = 0; i < chunk; ++i) {
+      const unsigned j = offset + i;
+      SignedRasterLocation p(a.x + int(dx * j / divisor),
+                             a.y + int(dy * j / divisor));
+      points[i] = interpolate ? p : p >> RasterTraits::SUBPIXEL_BITS;
+    }
+
+    if (interpolate)
+      raster_tile_cache.GetInterpolatedHeights(points, heights + offset,
+                                               chunk);
+    else
+      raster_tile_cache.GetHeights(points, heights + offset, chunk);
+  }
+}
+
 void
 RasterMap::ScanLine(const GeoPoint &start, const GeoPoint &end,
                     TerrainHeight *buffer, unsigned size,
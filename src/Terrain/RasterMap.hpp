@@ -45,6 +45,10 @@ public:
     return raster_tile_cache;
   }
 
+  const RasterTileCache &GetTileCache() const {
+    return raster_tile_cache;
+  }
+
   void UpdateProjection();
 
   bool SaveCache(FILE *file) const {
@@ -111,9 +115,38 @@ public:
   gcc_pure
   TerrainHeight GetInterpolatedHeight(const GeoPoint &location) const;
 
+  /**
+   * Determine the non-interpolated heights at many locations at
+   * once.  This is cheaper than calling GetHeight() for each one;
+   * see RasterTileCache::GetHeights().
+   */
+  gcc_nonnull_all
+  void GetHeights(const GeoPoint *locations, TerrainHeight *heights,
+                  unsigned n) const;
+
+  /**
+   * Determine the interpolated heights at many locations at once.
+   */
+  gcc_nonnull_all
+  void GetInterpolatedHeights(const GeoPoint *locations,
+                              TerrainHeight *heights, unsigned n) const;
+
+  /**
+   * Determine the heights at the specified number of points evenly
+   * spaced (linearly in latitude and longitude) from #start to #end,
+   * both inclusive.  Unlike ScanLine(), every sample is a point
+   * lookup, not a range scan.
+   */
+  gcc_nonnull_all
+  void GetLineHeights(const GeoPoint &start, const GeoPoint &end,
+                      TerrainHeight *heights, unsigned n,
+                      bool interpolate=false) const;
+
   /**
    * Scan a straight line and fill the buffer with the specified
-   * number of samples along the line.
+   * number of samples along the line.  This is meant for rendering;
+   * samples which are far apart are read from a reduced-resolution
+   * pyramid level, see RasterTileCache::ScanLine().
    */
   void ScanLine(const GeoPoint &start, const GeoPoint &end,
                 TerrainHeight *buffer, unsigned size, bool interpolate) const;
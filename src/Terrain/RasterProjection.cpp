@@ -39,6 +39,17 @@ RasterProjection::Set(const GeoBounds &bounds,
   top = AngleToHeight(bounds.GetNorth());
 }
 
+void
+RasterProjection::ProjectFine(const GeoPoint *gcc_restrict src,
+                              SignedRasterLocation *gcc_restrict dest,
+                              unsigned n) const
+{
+  for (unsigned i = 0; i < n; ++i) {
+    dest[i].x = AngleToWidth(src[i].longitude) - left;
+    dest[i].y = top - AngleToHeight(src[i].latitude);
+  }
+}
+
 double
 RasterProjection::FinePixelDistance(const GeoPoint &location,
                                     unsigned pixels) const
@@ -70,6 +70,15 @@ public:
                                 top - AngleToHeight(location.latitude));
   }
 
+  /**
+   * Project an array of locations.  This is cheaper than calling
+   * ProjectFine() for each one, because the loop can be vectorised.
+   */
+  gcc_nonnull_all
+  void ProjectFine(const GeoPoint *gcc_restrict src,
+                   SignedRasterLocation *gcc_restrict dest,
+                   unsigned n) const;
+
   constexpr GeoPoint UnprojectFine(SignedRasterLocation coords) const {
     return GeoPoint(WidthToAngle((int)coords.x + left),
                     HeightToAngle(top - (int)coords.y));
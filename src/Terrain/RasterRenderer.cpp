@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "Terrain/RasterRenderer.hpp"
 #include "Terrain/RasterMap.hpp"
+#include "Terrain/Shading/Optimised.hpp"
 #include "Math/FastMath.hpp"
 #include "Util/Clamp.hpp"
 #include "Screen/Ramp.hpp"
@@ -113,6 +114,9 @@ RasterRenderer::~RasterRenderer()
   delete[] color_table;
   delete image;
   delete[] contour_column_base;
+  delete[] index_row;
+  delete[] contour_row;
+  delete[] shade_row;
 }
 
 #ifdef ENABLE_OPENGL
@@ -215,6 +219,13 @@ RasterRenderer::GenerateImage(bool do_shading,
 
     delete[] contour_column_base;
     contour_column_base = new unsigned char[height_matrix.GetWidth()];
+
+    delete[] index_row;
+    index_row = new uint8_t[height_matrix.GetWidth()];
+    delete[] contour_row;
+    contour_row = new uint8_t[height_matrix.GetWidth()];
+    delete[] shade_row;
+    shade_row = new int8_t[height_matrix.GetWidth()];
   }
 
   if (quantisation_effective == 0) {
@@ -239,26 +250,26 @@ void
 RasterRenderer::GenerateUnshadedImage(unsigned height_scale,
                                       const unsigned contour_height_scale)
 {
+  const unsigned width = height_matrix.GetWidth();
   const auto *src = height_matrix.GetData();
   const RawColor *oColorBuf = color_table + 64 * 256;
   RawColor *dest = image->GetTopRow();
 
-  for (unsigned y = height_matrix.GetHeight(); y > 0; --y) {
+  for (unsigned y = height_matrix.GetHeight(); y > 0; --y, src += width) {
     RawColor *p = dest;
     dest = image->GetNextRow(dest);
 
-    unsigned contour_row_base = ContourInterval(*src, contour_height_scale);
-    unsigned char *contour_this_column_base = contour_column_base;
+    OptimisedTerrainShading::HeightRow(index_row, contour_row, src, width,
+                                       height_scale, contour_height_scale);
 
-    for (unsigned x = height_matrix.GetWidth(); x > 0; --x) {
-      const auto e = *src++;
-      if (gcc_likely(!e.IsSpecial())) {
-        unsigned h = std::max(0, (int)e.GetValue());
+    unsigned contour_row_base = contour_row[0];
+    unsigned char *contour_this_column_base = contour_column_base;
 
-        const unsigned contour_interval =
-          ContourInterval(h, contour_height_scale);
+    for (unsigned x = 0; x < width; ++x) {
+      const unsigned h = index_row[x];
+      if (gcc_likely(h != 255)) {
+        const unsigned contour_interval = contour_row[x];
 
-        h = std::min(254u, h >> height_scale);
         if (gcc_unlikely((contour_interval != contour_row_base)
                          || (contour_interval != *contour_this_column_base))) {
 
@@ -267,7 +278,7 @@ RasterRenderer::GenerateUnshadedImage(unsigned height_scale,
         } else {
           *p++ = oColorBuf[h];
         }
-      } else if (e.IsWater()) {
+      } else if (src[x].IsWater()) {
         // we're in the water, so look up the color for water
         *p++ = oColorBuf[255];
       } else {
@@ -280,26 +291,6 @@ RasterRenderer::GenerateUnshadedImage(unsigned height_scale,
   }
 }
 
-/**
- * Clip the difference between two adjacent terrain height values to
- * sane bounds.  This works around integer overflows in the
- * GenerateSlopeImage() formula when the map file is broken, avoiding
- * the sqrt() call with a negative argument.
- */
-gcc_const
-static int
-ClipHeightDelta(int d)
-{
-  return Clamp(d, -512, 512);
-}
-
-gcc_const
-static int
-ClipHeightDelta(TerrainHeight a, TerrainHeight b)
-{
-  return ClipHeightDelta(a.GetValue() - b.GetValue());
-}
-
 // JMW: if zoomed right in (e.g. one unit is larger than terrain
 // grid), then increase the step size to be equal to the terrain
 // grid for purposes of calculating slope, to avoid shading problems
@@ -313,19 +304,32 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
 {
   assert(quantisation_effective > 0);
 
+  const unsigned width = height_matrix.GetWidth();
+
   PixelRect border;
   border.left = quantisation_effective;
   border.top = quantisation_effective;
-  border.right = height_matrix.GetWidth() - quantisation_effective;
+  border.right = width - quantisation_effective;
   border.bottom = height_matrix.GetHeight() - quantisation_effective;
 
-  const unsigned height_slope_factor =
+  TerrainShadingParameters params;
+  params.sx = sx;
+  params.sy = sy;
+  params.sz = sz;
+  params.contrast = contrast;
+  params.height_slope_factor =
     Clamp((unsigned)pixel_size, 1u,
           /* this upper limit avoids integer overflows in the "mag"
              formula; it effectively limits "dd2" so calculating its
              square will not overflow */
           8192u / (quantisation_effective * quantisation_effective));
 
+  /* the columns which have both neighbours at the full distance
+     (quantisation_effective) are shaded in one vectorised pass per
+     row; only the border columns are calculated one by one */
+  const unsigned inner_start = quantisation_effective;
+  const unsigned inner_end = std::max((int)border.right, (int)inner_start);
+
   const auto *src = height_matrix.GetData();
   const RawColor *oColorBuf = color_table + 64 * 256;
 
@@ -335,29 +339,37 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
     const unsigned row_plus_index = y < (unsigned)border.bottom
       ? quantisation_effective
       : height_matrix.GetHeight() - 1 - y;
-    const unsigned row_plus_offset = height_matrix.GetWidth() * row_plus_index;
+    const unsigned row_plus_offset = width * row_plus_index;
 
     const unsigned row_minus_index = y >= quantisation_effective
       ? quantisation_effective : y;
-    const unsigned row_minus_offset = height_matrix.GetWidth() * row_minus_index;
+    const unsigned row_minus_offset = width * row_minus_index;
 
     const unsigned p31 = row_plus_index + row_minus_index;
 
     RawColor *p = dest;
     dest = image->GetNextRow(dest);
 
-    unsigned contour_row_base = ContourInterval(*src, contour_height_scale);
-    unsigned char *contour_this_column_base = contour_column_base;
+    OptimisedTerrainShading::HeightRow(index_row, contour_row, src, width,
+                                       height_scale, contour_height_scale);
 
-    for (unsigned x = 0; x < height_matrix.GetWidth(); ++x, ++src) {
-      const auto e = *src;
-      if (gcc_likely(!e.IsSpecial())) {
-        unsigned h = std::max(0, (int)e.GetValue());
+    params.p20 = 2 * quantisation_effective;
+    params.p31 = p31;
+    if (inner_end > inner_start)
+      OptimisedTerrainShading::SlopeRow(shade_row + inner_start,
+                                        src + inner_start - row_minus_offset,
+                                        src + inner_start + row_plus_offset,
+                                        src,
+                                        src + 2 * quantisation_effective,
+                                        inner_end - inner_start, params);
 
-        const unsigned contour_interval =
-          ContourInterval(h, contour_height_scale);
+    unsigned contour_row_base = contour_row[0];
+    unsigned char *contour_this_column_base = contour_column_base;
 
-        h = std::min(254u, h >> height_scale);
+    for (unsigned x = 0; x < width; ++x, ++src) {
+      const unsigned h = index_row[x];
+      if (gcc_likely(h != 255)) {
+        const unsigned contour_interval = contour_row[x];
 
         // no need to calculate slope if undefined height or sea level
 
@@ -371,7 +383,7 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
 
         const unsigned column_plus_index = x < (unsigned)border.right
           ? quantisation_effective
-          : height_matrix.GetWidth() - 1 - x;
+          : width - 1 - x;
         const unsigned column_minus_index = x >= (unsigned)border.left
           ? quantisation_effective : x;
 
@@ -404,26 +416,14 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
           continue;
         }
 
-        const int p32 = ClipHeightDelta(h_above, h_below);
-        const int p22 = ClipHeightDelta(h_right, h_left);
-
-        const unsigned p20 = column_plus_index + column_minus_index;
-
-        const int dd0 = p22 * int(p31);
-        const int dd1 = int(p20) * p32;
-        const unsigned dd2 = p20 * p31 * height_slope_factor;
-        const int num = (int(dd2) * sz + dd0 * sx + dd1 * sy);
-        const unsigned square_mag = dd0 * dd0 + dd1 * dd1 + dd2 * dd2;
-        const unsigned mag = (unsigned)sqrt(square_mag);
-        /* this is a workaround for a SIGFPE (division by zero)
-           observed by our users on some Android devices (e.g. Nexus
-           7), even though we did our best to make sure that the
-           integer arithmetics above can't overflow */
-        /* TODO: debug this problem and replace this workaround */
-        const int sval = num / int(mag|1);
-        const int sindex = (sval - sz) * contrast / 128;
-        *p++ = oColorBuf[int(h) + 256 * Clamp(sindex, -63, 63)];
-      } else if (e.IsWater()) {
+        const int sindex = x >= inner_start && x < inner_end
+          ? shade_row[x]
+          : PortableTerrainShading::SlopeIndex(PortableTerrainShading::ClipHeightDelta(h_right, h_left),
+                                               PortableTerrainShading::ClipHeightDelta(h_above, h_below),
+                                               column_plus_index + column_minus_index,
+                                               p31, params);
+        *p++ = oColorBuf[int(h) + 256 * sindex];
+      } else if (src->IsWater()) {
         // we're in the water, so look up the color for water
         *p++ = oColorBuf[255];
       } else {
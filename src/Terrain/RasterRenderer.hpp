@@ -26,6 +26,8 @@ Copyright_License {
 
 #include "Terrain/HeightMatrix.hpp"
 
+#include <stdint.h>
+
 #ifdef ENABLE_OPENGL
 #include "Geo/GeoBounds.hpp"
 #endif
@@ -76,6 +78,13 @@ class RasterRenderer {
 
   unsigned char *contour_column_base = nullptr;
 
+  /**
+   * Temporary buffers for one row of the height matrix, filled by
+   * #OptimisedTerrainShading.
+   */
+  uint8_t *index_row = nullptr, *contour_row = nullptr;
+  int8_t *shade_row = nullptr;
+
   double pixel_size;
 
   RawColor *color_table = nullptr;
@@ -27,10 +27,24 @@ Copyright_License {
 #include "IO/ZipArchive.hpp"
 #include "IO/FileCache.hpp"
 #include "OS/ConvertPathName.hpp"
+#include "OS/Memory.hpp"
 #include "Operation/Operation.hpp"
 #include "Util/ConvertString.hpp"
+#include "Thread/ThreadPool.hpp"
+
+#include <stdexcept>
 
 static const TCHAR *const terrain_cache_name = _T("terrain");
+static const TCHAR *const terrain_tiles_cache_name = _T("terrain_tiles");
+
+RasterTerrain::RasterTerrain(ZipArchive &&_archive)
+  :Guard<RasterMap>(map), archive(std::move(_archive))
+{
+  if (ThreadPool::GetProcessorCount() >= 2)
+    decode_pool.reset(new ThreadPool("TerrainDecode", 0, 0, true));
+}
+
+RasterTerrain::~RasterTerrain() = default;
 
 inline bool
 RasterTerrain::LoadCache(FileCache &cache, Path path)
@@ -63,20 +77,65 @@ RasterTerrain::SaveCache(FileCache &cache, Path path) const
   return success;
 }
 
+inline bool
+RasterTerrain::OpenTileStore(FileCache &cache, Path path)
+{
+  auto &tile_cache = map.GetTileCache();
+
+  FILE *file = cache.LoadWritable(terrain_tiles_cache_name, path);
+  if (file != nullptr) {
+    /* the mapping remains valid after the file has been closed */
+    bool success = tile_cache.OpenTileStore(file);
+    fclose(file);
+    if (success)
+      return true;
+
+    /* obsolete layout; discard it and create a new one */
+  }
+
+  file = cache.Save(terrain_tiles_cache_name, path);
+  if (file == nullptr)
+    return false;
+
+  if (!tile_cache.CreateTileStore(file)) {
+    cache.Cancel(terrain_tiles_cache_name, file);
+    return false;
+  }
+
+  if (!cache.Commit(terrain_tiles_cache_name, file))
+    return false;
+
+  file = cache.LoadWritable(terrain_tiles_cache_name, path);
+  if (file == nullptr)
+    return false;
+
+  bool success = tile_cache.OpenTileStore(file);
+  fclose(file);
+  if (!success)
+    cache.Flush(terrain_tiles_cache_name);
+
+  return success;
+}
+
 inline bool
 RasterTerrain::Load(Path path, FileCache *cache,
                     OperationEnvironment &operation)
 {
-  if (LoadCache(cache, path))
+  if (LoadCache(cache, path)) {
+    OpenTileStore(*cache, path);
     return true;
+  }
 
-  if (!LoadTerrainOverview(archive.get(), map.GetTileCache(), operation))
+  if (!LoadTerrainOverview(archive.get(), map.GetTileCache(), operation,
+                           decode_pool.get()))
     return false;
 
   map.UpdateProjection();
 
-  if (cache != nullptr)
+  if (cache != nullptr) {
     SaveCache(*cache, path);
+    OpenTileStore(*cache, path);
+  }
 
   return true;
 }
@@ -94,6 +153,8 @@ try {
     return nullptr;
   }
 
+  rt->SetTileCacheBudget(RasterTileCache::CalcBudget(GetPhysicalMemorySize()));
+
   return rt;
 } catch (const std::runtime_error &e) {
   operation.SetErrorMessage(UTF8ToWideConverter(e.what()));
@@ -108,6 +169,24 @@ RasterTerrain::UpdateTiles(const GeoPoint &location, double radius)
     return false;
 
   UpdateTerrainTiles(archive.get(), tile_cache, mutex,
-                     map.GetProjection(), location, radius);
+                     map.GetProjection(), location, radius,
+                     decode_pool.get());
+  return map.IsDirty();
+}
+
+bool
+RasterTerrain::UpdateTiles(const GeoPoint &location, double radius,
+                           const GeoPoint &prefetch_start,
+                           const GeoPoint &prefetch_end,
+                           double prefetch_radius)
+{
+  auto &tile_cache = map.GetTileCache();
+  if (!tile_cache.IsValid())
+    return false;
+
+  UpdateTerrainTiles(archive.get(), tile_cache, mutex,
+                     map.GetProjection(), location, radius,
+                     prefetch_start, prefetch_end, prefetch_radius,
+                     decode_pool.get());
   return map.IsDirty();
 }
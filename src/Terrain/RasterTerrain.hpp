@@ -31,7 +31,10 @@ Copyright_License {
 #include "IO/ZipArchive.hpp"
 #include "Compiler.h"
 
+#include <memory>
+
 class FileCache;
+class ThreadPool;
 class OperationEnvironment;
 
 /**
@@ -49,14 +52,22 @@ private:
 
   RasterMap map;
 
+  /**
+   * Decodes tiles for Load() and UpdateTiles().  It is kept for the
+   * lifetime of this object, so each update does not need to start
+   * new threads.  nullptr if there is only one CPU.
+   */
+  std::unique_ptr<ThreadPool> decode_pool;
+
 private:
   /**
    * Constructor.  Returns uninitialised object.
    */
-  explicit RasterTerrain(ZipArchive &&_archive)
-    :Guard<RasterMap>(map), archive(std::move(_archive)) {}
+  explicit RasterTerrain(ZipArchive &&_archive);
 
 public:
+  ~RasterTerrain();
+
   const Serial &GetSerial() const {
     return map.GetSerial();
   }
@@ -77,11 +88,39 @@ public:
     return map.GetMapCenter();
   }
 
+  /**
+   * Obtain a copy of the tile cache statistics.  This method is
+   * thread-safe and does not need a lease.
+   */
+  gcc_pure
+  RasterTileCacheStatistics GetTileCacheStatistics() const {
+    return map.GetTileCache().GetStatistics();
+  }
+
+  /**
+   * Change the maximum number of bytes occupied by loaded tiles.
+   * This method is thread-safe.
+   */
+  void SetTileCacheBudget(size_t budget) {
+    map.GetTileCache().SetBudget(budget);
+  }
+
   /**
    * @return true if the method shall be called again
    */
   bool UpdateTiles(const GeoPoint &location, double radius);
 
+  /**
+   * Like UpdateTiles(const GeoPoint &, double), but additionally
+   * prefetch tiles along the predicted flight path from
+   * #prefetch_start to #prefetch_end.
+   *
+   * @return true if the method shall be called again
+   */
+  bool UpdateTiles(const GeoPoint &location, double radius,
+                   const GeoPoint &prefetch_start,
+                   const GeoPoint &prefetch_end, double prefetch_radius);
+
 private:
   bool LoadCache(FileCache &cache, Path path);
 
@@ -91,6 +130,11 @@ private:
 
   bool SaveCache(FileCache &cache, Path path) const;
 
+  /**
+   * Open (or create) the #TerrainTileStore for the loaded map.
+   */
+  bool OpenTileStore(FileCache &cache, Path path);
+
   bool Load(Path path, FileCache *cache,
             OperationEnvironment &operation);
 };
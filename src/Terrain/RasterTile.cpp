@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "Terrain/RasterTile.hpp"
 
+#include "Util/Clamp.hpp"
 #include "jasper/jas_seq.h"
 
 #include <algorithm>
@@ -52,6 +53,19 @@ RasterTile::LoadCache(FILE *file)
   return true;
 }
 
+static void
+CopyMatrix(TerrainHeight *gcc_restrict dest, const struct jas_matrix &m)
+{
+  const unsigned width = m.numcols_, height = m.numrows_;
+
+  for (unsigned y = 0; y != height; ++y) {
+    const jas_seqent_t *gcc_restrict src = m.rows_[y];
+
+    for (unsigned i = 0; i < width; ++i)
+      *dest++ = TerrainHeight(src[i]);
+  }
+}
+
 void
 RasterTile::CopyFrom(const struct jas_matrix &m)
 {
@@ -63,14 +77,23 @@ RasterTile::CopyFrom(const struct jas_matrix &m)
   auto *gcc_restrict dest = buffer.GetData();
   assert(dest != nullptr);
 
-  const unsigned width = m.numcols_, height = m.numrows_;
+  CopyMatrix(dest, m);
+  max_index.Build(buffer);
+}
 
-  for (unsigned y = 0; y != height; ++y) {
-    const jas_seqent_t *gcc_restrict src = m.rows_[y];
+bool
+RasterTile::CopyFrom(const struct jas_matrix &m, TerrainHeight *shared)
+{
+  assert(shared != nullptr);
 
-    for (unsigned i = 0; i < width; ++i)
-      *dest++ = TerrainHeight(src[i]);
-  }
+  if (!IsDefined() ||
+      unsigned(m.numcols_) != width || unsigned(m.numrows_) != height)
+    return false;
+
+  CopyMatrix(shared, m);
+  buffer.SetShared(shared, width, height);
+  max_index.Build(buffer);
+  return true;
 }
 
 TerrainHeight
@@ -118,6 +141,24 @@ RasterTile::CalcDistanceTo(int x, int y) const
   return std::max(std::min(dx1, dx2), std::min(dy1, dy2));
 }
 
+unsigned
+RasterTile::CalcDistanceToSegment(int ax, int ay, int bx, int by) const
+{
+  /* find the point on the segment which is nearest to the tile
+     center */
+  const int cx = (xstart + xend) / 2, cy = (ystart + yend) / 2;
+  const double dx = bx - ax, dy = by - ay;
+  const double length_squared = dx * dx + dy * dy;
+
+  double t = 0;
+  if (length_squared > 0) {
+    t = ((cx - ax) * dx + (cy - ay) * dy) / length_squared;
+    t = Clamp(t, 0., 1.);
+  }
+
+  return CalcDistanceTo(ax + int(t * dx), ay + int(t * dy));
+}
+
 inline bool
 RasterTile::CheckTileVisibility(int view_x, int view_y, unsigned view_radius)
 {
@@ -127,7 +168,8 @@ RasterTile::CheckTileVisibility(int view_x, int view_y, unsigned view_radius)
   }
 
   distance = CalcDistanceTo(view_x, view_y);
-  return distance <= view_radius || IsEnabled();
+  in_range = distance <= view_radius;
+  return in_range || IsEnabled();
 }
 
 bool
@@ -136,3 +178,25 @@ RasterTile::VisibilityChanged(int view_x, int view_y, unsigned view_radius)
   request = false;
   return CheckTileVisibility(view_x, view_y, view_radius);
 }
+
+bool
+RasterTile::VisibilityChanged(int view_x, int view_y, unsigned view_radius,
+                              int ax, int ay, int bx, int by,
+                              unsigned path_radius)
+{
+  request = false;
+  if (CheckTileVisibility(view_x, view_y, view_radius) && in_range)
+    return true;
+
+  if (!IsDefined())
+    return false;
+
+  const unsigned path_distance = CalcDistanceToSegment(ax, ay, bx, by);
+  if (path_distance <= path_radius) {
+    /* prefetch: lower priority than all visible tiles */
+    distance = std::min(distance, view_radius + 1 + path_distance);
+    in_range = true;
+  }
+
+  return in_range || IsEnabled();
+}
@@ -26,7 +26,9 @@ Copyright_License {
 
 #include "RasterTraits.hpp"
 #include "RasterBuffer.hpp"
+#include "MaxElevationIndex.hpp"
 
+#include <assert.h>
 #include <stdio.h>
 
 struct jas_matrix;
@@ -46,10 +48,36 @@ public:
    */
   unsigned distance;
 
+  /**
+   * Was this tile within the requested range (or the prefetch
+   * corridor) in the last VisibilityChanged() call?
+   */
+  bool in_range;
+
   bool request;
 
+  /**
+   * Has this tile been counted as a miss in the
+   * #RasterTileCacheStatistics since it was last loaded?  This
+   * prevents counting a pending tile again on each poll.
+   */
+  bool miss_counted = false;
+
+  /**
+   * The RasterTileCache poll counter value when this tile was last in
+   * range.  This is used to evict the least recently used tiles
+   * first.
+   */
+  unsigned last_used = 0;
+
   RasterBuffer buffer;
 
+  /**
+   * The maximum elevations of the #buffer, built when the tile is
+   * loaded.
+   */
+  MaxElevationIndex max_index;
+
 public:
   RasterTile() = default;
 
@@ -78,10 +106,29 @@ public:
     return width > 0 && height > 0;
   }
 
+  /**
+   * Is the specified pixel location inside this tile?
+   */
+  bool Contains(unsigned x, unsigned y) const {
+    return x - xstart < width && y - ystart < height;
+  }
+
   int GetDistance() const {
     return distance;
   }
 
+  bool IsInRange() const {
+    return in_range;
+  }
+
+  /**
+   * Returns the number of bytes this tile occupies when it is
+   * loaded.
+   */
+  size_t GetMemorySize() const {
+    return size_t(width) * height * sizeof(TerrainHeight);
+  }
+
   bool IsRequested() const {
     return request;
   }
@@ -100,10 +147,18 @@ public:
   gcc_pure
   unsigned CalcDistanceTo(int x, int y) const;
 
+  /**
+   * Like CalcDistanceTo(), but measure the distance to the line
+   * segment between the two given points.
+   */
+  gcc_pure
+  unsigned CalcDistanceToSegment(int ax, int ay, int bx, int by) const;
+
   bool CheckTileVisibility(int view_x, int view_y, unsigned view_radius);
 
   void Disable() {
     buffer.Reset();
+    max_index.Reset();
   }
 
   bool IsEnabled() const {
@@ -115,6 +170,34 @@ public:
 
   void CopyFrom(const struct jas_matrix &m);
 
+  /**
+   * Copy the decoded pixels into the given (shared) memory, and use
+   * it as this tile's buffer.
+   *
+   * @return false if the matrix does not fit, and nothing was done
+   */
+  bool CopyFrom(const struct jas_matrix &m, TerrainHeight *shared);
+
+  /**
+   * Use pixels which were decoded earlier, see #TerrainTileStore.
+   */
+  void SetShared(TerrainHeight *shared) {
+    assert(IsDefined());
+
+    buffer.SetShared(shared, width, height);
+    max_index.Build(buffer);
+  }
+
+  /**
+   * Returns the #MaxElevationIndex of this (loaded) tile.  Its pixel
+   * coordinates are relative to the tile.
+   */
+  const MaxElevationIndex &GetMaxElevationIndex() const {
+    assert(IsEnabled());
+
+    return max_index;
+  }
+
   /**
    * Determine the non-interpolated height at the specified pixel
    * location.
@@ -140,6 +223,16 @@ public:
 
   bool VisibilityChanged(int view_x, int view_y, unsigned view_radius);
 
+  /**
+   * Like VisibilityChanged(), but additionally select tiles which
+   * are within #path_radius of the segment (ax,ay)-(bx,by), i.e. the
+   * predicted flight path.  Such tiles get a #distance larger than
+   * #view_radius, so they are sorted after all visible tiles.
+   */
+  bool VisibilityChanged(int view_x, int view_y, unsigned view_radius,
+                         int ax, int ay, int bx, int by,
+                         unsigned path_radius);
+
   void ScanLine(unsigned ax, unsigned ay, unsigned bx, unsigned by,
                 TerrainHeight *dest, unsigned size, bool interpolate) const {
     buffer.ScanLine(ax - (xstart << RasterTraits::SUBPIXEL_BITS),
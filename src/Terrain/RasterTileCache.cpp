@@ -24,6 +24,7 @@ Copyright_License {
 #include "RasterTileCache.hpp"
 #include "Math/Angle.hpp"
 #include "Math/FastMath.hpp"
+#include "Util/Clamp.hpp"
 
 extern "C" {
 #include "jasper/jas_seq.h"
@@ -40,38 +41,133 @@ CopyOverviewRow(TerrainHeight *gcc_restrict dest, const jas_seqent_t *gcc_restri
     *dest++ = TerrainHeight(*src);
 }
 
-void
-RasterTileCache::PutOverviewTile(unsigned index,
-                                 unsigned start_x, unsigned start_y,
-                                 unsigned end_x, unsigned end_y,
-                                 const struct jas_matrix &m)
+/**
+ * Store the maximum of each block of (1 << bits) pixels of the row
+ * in the reduced-resolution row, or combine it with the value which
+ * is already there.
+ */
+static void
+MaxLevelRow(TerrainHeight *gcc_restrict dest,
+            const jas_seqent_t *gcc_restrict src,
+            unsigned width, unsigned src_width, unsigned bits, bool first)
 {
-  tiles.GetLinear(index).Set(start_x, start_y, end_x, end_y);
+  const unsigned skip = 1 << bits;
+
+  for (unsigned x = 0; x < width; ++x, src += skip) {
+    const unsigned n = std::min(skip, src_width - (x << bits));
+    jas_seqent_t h = src[0];
+    for (unsigned i = 1; i < n; ++i)
+      h = std::max(h, src[i]);
+
+    if (first || h > dest[x].GetValue())
+      dest[x] = TerrainHeight(h);
+  }
+}
+
+/**
+ * Store the maximum of each square of (1 << bits) pixels of the tile
+ * in the reduced-resolution buffer, so peaks and ridges narrower than
+ * one pixel of the buffer are not lost.  Invalid and water pixels
+ * have the lowest values, thus any ground pixel wins.
+ */
+static void
+PutMaxLevelTile(RasterBuffer &level, unsigned bits,
+                unsigned start_x, unsigned start_y,
+                const struct jas_matrix &m)
+{
+  const unsigned dest_pitch = level.GetWidth();
+  const unsigned mask = (1u << bits) - 1;
+
+  start_x >>= bits;
+  start_y >>= bits;
+
+  if (start_x >= level.GetWidth() || start_y >= level.GetHeight())
+    return;
+
+  unsigned width = (m.numcols_ + mask) >> bits;
+  if (start_x + width > level.GetWidth())
+    width = level.GetWidth() - start_x;
+  unsigned height = (m.numrows_ + mask) >> bits;
+  if (start_y + height > level.GetHeight())
+    height = level.GetHeight() - start_y;
+
+  const unsigned skip = 1 << bits;
+  const unsigned src_width = m.numcols_, src_height = m.numrows_;
+
+  auto *gcc_restrict dest = level.GetData()
+    + start_y * dest_pitch + start_x;
+
+  for (unsigned i = 0; i < height; ++i, dest += dest_pitch) {
+    const unsigned start_row = i << bits;
+    const unsigned end_row = std::min(start_row + skip, src_height);
+    for (unsigned y = start_row; y < end_row; ++y)
+      MaxLevelRow(dest, m.rows_[y], width, src_width, bits, y == start_row);
+  }
+}
 
-  const unsigned dest_pitch = overview.GetWidth();
+/**
+ * Copy every (1 << bits)-th pixel of the tile into the
+ * reduced-resolution buffer.
+ */
+static void
+PutLevelTile(RasterBuffer &level, unsigned bits,
+             unsigned start_x, unsigned start_y,
+             const struct jas_matrix &m)
+{
+  const unsigned dest_pitch = level.GetWidth();
+  const unsigned mask = (1u << bits) - 1;
 
-  start_x = RasterTraits::ToOverview(start_x);
-  start_y = RasterTraits::ToOverview(start_y);
+  start_x >>= bits;
+  start_y >>= bits;
 
-  if (start_x >= overview.GetWidth() || start_y >= overview.GetHeight())
+  if (start_x >= level.GetWidth() || start_y >= level.GetHeight())
     return;
 
-  unsigned width = RasterTraits::ToOverviewCeil(m.numcols_);
-  if (start_x + width > overview.GetWidth())
-    width = overview.GetWidth() - start_x;
-  unsigned height = RasterTraits::ToOverviewCeil(m.numrows_);
-  if (start_y + height > overview.GetHeight())
-    height = overview.GetHeight() - start_y;
+  unsigned width = (m.numcols_ + mask) >> bits;
+  if (start_x + width > level.GetWidth())
+    width = level.GetWidth() - start_x;
+  unsigned height = (m.numrows_ + mask) >> bits;
+  if (start_y + height > level.GetHeight())
+    height = level.GetHeight() - start_y;
 
-  const unsigned skip = 1 << OVERVIEW_BITS;
+  const unsigned skip = 1 << bits;
 
-  auto *gcc_restrict dest = overview.GetData()
+  auto *gcc_restrict dest = level.GetData()
     + start_y * dest_pitch + start_x;
 
   for (unsigned i = 0, y = 0; i < height; ++i, y += skip, dest += dest_pitch)
     CopyOverviewRow(dest, m.rows_[y], width, skip);
 }
 
+void
+RasterTileCache::PutOverviewTile(unsigned index,
+                                 unsigned start_x, unsigned start_y,
+                                 unsigned end_x, unsigned end_y,
+                                 const struct jas_matrix &m)
+{
+  tiles.GetLinear(index).Set(start_x, start_y, end_x, end_y);
+
+  for (unsigned i = 0; i < PYRAMID_LEVELS; ++i)
+    PutMaxLevelTile(pyramid[i], PYRAMID_MIN_BITS + i, start_x, start_y, m);
+
+  PutLevelTile(overview, OVERVIEW_BITS, start_x, start_y, m);
+}
+
+const RasterBuffer &
+RasterTileCache::GetLevel(unsigned min_bits, unsigned &bits_r) const
+{
+  if (min_bits < PYRAMID_MIN_BITS)
+    min_bits = PYRAMID_MIN_BITS;
+
+  if (min_bits >= OVERVIEW_BITS) {
+    bits_r = OVERVIEW_BITS;
+    return overview;
+  }
+
+  bits_r = min_bits;
+  return pyramid[min_bits - PYRAMID_MIN_BITS];
+}
+
 void
 RasterTileCache::PutTileData(unsigned index,
                              const struct jas_matrix &m)
@@ -80,6 +176,14 @@ RasterTileCache::PutTileData(unsigned index,
   if (!tile.IsRequested())
     return;
 
+  if (tile_store.IsDefined()) {
+    TerrainHeight *slot = tile_store.GetSlot(index);
+    if (slot != nullptr && tile.CopyFrom(m, slot)) {
+      tile_store.CommitTile(index);
+      return;
+    }
+  }
+
   tile.CopyFrom(m);
 }
 
@@ -92,7 +196,15 @@ struct RTDistanceSort {
     const RasterTile &a = rtc.tiles.GetLinear(ai);
     const RasterTile &b = rtc.tiles.GetLinear(bi);
 
-    return a.GetDistance() < b.GetDistance();
+    /* tiles in range first, nearest first */
+    if (a.IsInRange() != b.IsInRange())
+      return a.IsInRange();
+
+    if (a.IsInRange())
+      return a.GetDistance() < b.GetDistance();
+
+    /* then the remaining loaded tiles, least recently used last */
+    return int(a.last_used - b.last_used) > 0;
   }
 };
 
@@ -105,14 +217,6 @@ RasterTileCache::PollTiles(int x, int y, unsigned radius)
      the screen will be loaded in advance */
   radius += 256;
 
-  /**
-   * Maximum number of tiles loaded at a time, to reduce system load
-   * peaks.
-   */
-  constexpr unsigned MAX_ACTIVATE = MAX_ACTIVE_TILES > 32
-    ? 16
-    : MAX_ACTIVE_TILES / 2;
-
   /* query all tiles; all tiles which are either in range or already
      loaded are added to RequestTiles */
 
@@ -121,43 +225,190 @@ RasterTileCache::PollTiles(int x, int y, unsigned radius)
     if (tiles.GetLinear(i).VisibilityChanged(x, y, radius))
       request_tiles.append(i);
 
-  /* reduce if there are too many */
+  return ActivateRequestTiles(false);
+}
+
+bool
+RasterTileCache::PollTiles(int x, int y, unsigned radius,
+                           const RasterPrefetchPath &path)
+{
+  /* see above */
+  radius += 256;
+
+  request_tiles.clear();
+  for (int i = tiles.GetSize() - 1; i >= 0 && !request_tiles.full(); --i)
+    if (tiles.GetLinear(i).VisibilityChanged(x, y, radius,
+                                              path.start.x, path.start.y,
+                                              path.end.x, path.end.y,
+                                              path.radius))
+      request_tiles.append(i);
+
+  /* always sort, so visible tiles are activated before the
+     prefetched ones */
+  return ActivateRequestTiles(true);
+}
+
+bool
+RasterTileCache::ActivateRequestTiles(bool force_sort)
+{
+  /**
+   * Maximum number of tiles loaded at a time, to reduce system load
+   * peaks.
+   */
+  constexpr unsigned MAX_ACTIVATE = 16;
+
+  const size_t max_size = GetTileBudget();
+
+  /* mark the tiles in range as used, and calculate how much memory
+     all requested tiles need */
+
+  ++poll_counter;
+
+  unsigned hits = 0;
+  size_t total_size = 0;
+  for (const unsigned i : request_tiles) {
+    RasterTile &tile = tiles.GetLinear(i);
+    if (tile.IsEnabled())
+      tile.miss_counted = false;
+
+    if (tile.IsInRange()) {
+      tile.last_used = poll_counter;
+      if (tile.IsEnabled())
+        ++hits;
+    }
+
+    total_size += tile.GetMemorySize();
+  }
 
-  if (request_tiles.size() > MAX_ACTIVE_TILES) {
-    /* sort by distance */
+  if (force_sort || total_size > max_size) {
+    /* sort by priority */
     const RTDistanceSort sort(*this);
     std::sort(request_tiles.begin(), request_tiles.end(), sort);
+  }
+
+  /* reduce if there are too many */
 
-    /* dispose all tiles which are out of range */
-    for (unsigned i = MAX_ACTIVE_TILES; i < request_tiles.size(); ++i) {
+  unsigned evictions = 0;
+  if (total_size > max_size) {
+    unsigned n = 0;
+    size_t size = 0;
+    for (; n < request_tiles.size(); ++n) {
+      size += tiles.GetLinear(request_tiles[n]).GetMemorySize();
+      if (size > max_size)
+        break;
+    }
+
+    /* dispose all tiles which do not fit */
+    for (unsigned i = n; i < request_tiles.size(); ++i) {
       RasterTile &tile = tiles.GetLinear(request_tiles[i]);
-      tile.Disable();
+      if (tile.IsEnabled()) {
+        tile.Disable();
+        ++evictions;
+      }
     }
 
-    request_tiles.shrink(MAX_ACTIVE_TILES);
+    request_tiles.shrink(n);
   }
 
   /* fill ActiveTiles and request new tiles */
 
   dirty = false;
 
-  unsigned num_activate = 0;
+  unsigned num_activate = 0, misses = 0;
   for (unsigned i = 0; i < request_tiles.size(); ++i) {
     RasterTile &tile = tiles.GetLinear(request_tiles[i]);
     if (tile.IsEnabled())
       continue;
 
-    if (++num_activate <= MAX_ACTIVATE)
+    if (++num_activate <= MAX_ACTIVATE) {
       /* request the tile in the current iteration */
       tile.SetRequest();
-    else
+
+      /* a tile may stay pending for several polls; count it once */
+      if (!tile.miss_counted) {
+        tile.miss_counted = true;
+        ++misses;
+      }
+    } else
       /* this tile will be loaded in the next iteration */
       dirty = true;
   }
 
+  {
+    const ScopeLock lock(statistics_mutex);
+    statistics.hits += hits;
+    statistics.misses += misses;
+    statistics.evictions += evictions;
+  }
+
+  UpdateResidentStatistics();
+
   return num_activate > 0;
 }
 
+void
+RasterTileCache::UpdateResidentStatistics()
+{
+  unsigned n = 0;
+  size_t size = 0;
+  for (const unsigned i : request_tiles) {
+    const RasterTile &tile = tiles.GetLinear(i);
+    if (tile.IsEnabled()) {
+      ++n;
+      size += tile.GetMemorySize();
+    }
+  }
+
+  const size_t pyramid_size = GetPyramidMemorySize();
+
+  const ScopeLock lock(statistics_mutex);
+  statistics.resident_tiles = n;
+  statistics.resident_bytes = size;
+  statistics.pyramid_bytes = pyramid_size;
+}
+
+size_t
+RasterTileCache::GetPyramidMemorySize() const
+{
+  size_t size = 0;
+  for (const auto &level : pyramid)
+    size += size_t(level.GetWidth()) * level.GetHeight() *
+      sizeof(TerrainHeight);
+  return size;
+}
+
+size_t
+RasterTileCache::GetTileBudget() const
+{
+  const size_t total = GetBudget();
+  const size_t pyramid_size = GetPyramidMemorySize();
+  return std::max(total > pyramid_size ? total - pyramid_size : 0,
+                  total / 4);
+}
+
+bool
+RasterTileCache::LoadStoredTiles()
+{
+  if (!tile_store.IsDefined())
+    return true;
+
+  bool remaining = false;
+  for (const unsigned i : request_tiles) {
+    RasterTile &tile = tiles.GetLinear(i);
+    if (!tile.IsRequested())
+      continue;
+
+    TerrainHeight *data = tile_store.GetTile(i);
+    if (data != nullptr) {
+      tile.SetShared(data);
+      tile.ClearRequest();
+    } else
+      remaining = true;
+  }
+
+  return remaining;
+}
+
 TerrainHeight
 RasterTileCache::GetHeight(unsigned px, unsigned py) const
 {
@@ -169,9 +420,11 @@ RasterTileCache::GetHeight(unsigned px, unsigned py) const
   if (tile.IsEnabled())
     return tile.GetHeight(px, py);
 
-  // still not found, so go to overview
-  return overview.GetInterpolated(px << (RasterTraits::SUBPIXEL_BITS - RasterTraits::OVERVIEW_BITS),
-                                  py << (RasterTraits::SUBPIXEL_BITS - RasterTraits::OVERVIEW_BITS));
+  // still not found, so go to the finest pyramid level
+  unsigned bits;
+  const RasterBuffer &level = GetFallbackLevel(bits);
+  return level.GetInterpolated(px << (RasterTraits::SUBPIXEL_BITS - bits),
+                               py << (RasterTraits::SUBPIXEL_BITS - bits));
 }
 
 TerrainHeight
@@ -189,9 +442,69 @@ RasterTileCache::GetInterpolatedHeight(unsigned int lx, unsigned int ly) const
   if (tile.IsEnabled())
     return tile.GetInterpolatedHeight(px, py, ix, iy);
 
-  // still not found, so go to overview
-  return overview.GetInterpolated(RasterTraits::ToOverview(lx),
-                                  RasterTraits::ToOverview(ly));
+  // still not found, so go to the finest pyramid level
+  unsigned bits;
+  const RasterBuffer &level = GetFallbackLevel(bits);
+  return level.GetInterpolated(lx >> bits, ly >> bits);
+}
+
+void
+RasterTileCache::GetHeights(const SignedRasterLocation *gcc_restrict points,
+                            TerrainHeight *gcc_restrict heights,
+                            unsigned n) const
+{
+  unsigned bits;
+  const RasterBuffer &level = GetFallbackLevel(bits);
+  const unsigned level_shift = RasterTraits::SUBPIXEL_BITS - bits;
+
+  const RasterTile *tile = nullptr;
+
+  for (unsigned i = 0; i < n; ++i) {
+    const unsigned px = points[i].x, py = points[i].y;
+    if (px >= width || py >= height) {
+      // outside overall bounds
+      heights[i] = TerrainHeight::Invalid();
+      continue;
+    }
+
+    if (tile == nullptr || !tile->Contains(px, py))
+      tile = &tiles.Get(px / tile_width, py / tile_height);
+
+    heights[i] = tile->IsEnabled()
+      ? tile->GetHeight(px, py)
+      : level.GetInterpolated(px << level_shift, py << level_shift);
+  }
+}
+
+void
+RasterTileCache::GetInterpolatedHeights(const SignedRasterLocation *gcc_restrict points,
+                                        TerrainHeight *gcc_restrict heights,
+                                        unsigned n) const
+{
+  unsigned bits;
+  const RasterBuffer &level = GetFallbackLevel(bits);
+
+  const RasterTile *tile = nullptr;
+
+  for (unsigned i = 0; i < n; ++i) {
+    const unsigned lx = points[i].x, ly = points[i].y;
+    if (lx >= overview_width_fine || ly >= overview_height_fine) {
+      // outside overall bounds
+      heights[i] = TerrainHeight::Invalid();
+      continue;
+    }
+
+    unsigned px = lx, py = ly;
+    const unsigned ix = CombinedDivAndMod(px);
+    const unsigned iy = CombinedDivAndMod(py);
+
+    if (tile == nullptr || !tile->Contains(px, py))
+      tile = &tiles.Get(px / tile_width, py / tile_height);
+
+    heights[i] = tile->IsEnabled()
+      ? tile->GetInterpolatedHeight(px, py, ix, iy)
+      : level.GetInterpolated(lx >> bits, ly >> bits);
+  }
 }
 
 void
@@ -204,6 +517,10 @@ RasterTileCache::SetSize(unsigned _width, unsigned _height,
   tile_width = _tile_width;
   tile_height = _tile_height;
 
+  for (unsigned i = 0; i < PYRAMID_LEVELS; ++i)
+    pyramid[i].Resize(width >> (PYRAMID_MIN_BITS + i),
+                      height >> (PYRAMID_MIN_BITS + i));
+
   overview.Resize(RasterTraits::ToOverview(width),
                   RasterTraits::ToOverview(height));
   overview_width_fine = width << RasterTraits::SUBPIXEL_BITS;
@@ -236,9 +553,29 @@ RasterTileCache::Reset()
   segments.clear();
 
   overview.Reset();
+  for (auto &level : pyramid)
+    level.Reset();
 
   for (auto it = tiles.begin(), end = tiles.end(); it != end; ++it)
     it->Disable();
+
+  /* close the store only after all tiles referring to it have been
+     disabled */
+  tile_store.Close();
+
+  const ScopeLock lock(statistics_mutex);
+  statistics.Clear();
+}
+
+size_t
+RasterTileCache::CalcBudget(uint64_t physical_memory)
+{
+  if (physical_memory == 0)
+    return DEFAULT_BUDGET;
+
+  /* use 1/16 of the physical memory */
+  return (size_t)Clamp(physical_memory / 16,
+                       uint64_t(MIN_BUDGET), uint64_t(MAX_BUDGET));
 }
 
 const RasterTileCache::MarkerSegmentInfo *
@@ -264,9 +601,32 @@ RasterTileCache::FinishTileUpdate()
       tile.Clear();
   }
 
+  /* this is called without holding the terrain lock, so the disk
+     I/O does not block the readers */
+  if (tile_store.IsDefined())
+    tile_store.Flush();
+
+  UpdateResidentStatistics();
+
   ++serial;
 }
 
+static bool
+SaveBuffer(const RasterBuffer &buffer, FILE *file)
+{
+  size_t size = buffer.GetWidth() * buffer.GetHeight();
+  return fwrite(buffer.GetData(), sizeof(*buffer.GetData()),
+                size, file) == size;
+}
+
+static bool
+LoadBuffer(RasterBuffer &buffer, FILE *file)
+{
+  size_t size = buffer.GetWidth() * buffer.GetHeight();
+  return fread(buffer.GetData(), sizeof(*buffer.GetData()),
+               size, file) == size;
+}
+
 bool
 RasterTileCache::SaveCache(FILE *file) const
 {
@@ -308,10 +668,12 @@ RasterTileCache::SaveCache(FILE *file) const
   if (fwrite(&i, sizeof(i), 1, file) != 1)
     return false;
 
-  /* save overview */
-  size_t overview_size = overview.GetWidth() * overview.GetHeight();
-  if (fwrite(overview.GetData(), sizeof(*overview.GetData()),
-             overview_size, file) != overview_size)
+  /* save pyramid levels and overview */
+  for (const auto &level : pyramid)
+    if (!SaveBuffer(level, file))
+      return false;
+
+  if (!SaveBuffer(overview, file))
     return false;
 
   /* done */
@@ -364,11 +726,61 @@ RasterTileCache::LoadCache(FILE *file)
       return false;
   }
 
-  /* load overview */
-  size_t overview_size = overview.GetWidth() * overview.GetHeight();
-  if (fread(overview.GetData(), sizeof(*overview.GetData()),
-            overview_size, file) != overview_size)
+  /* load pyramid levels and overview */
+  for (auto &level : pyramid)
+    if (!LoadBuffer(level, file))
+      return false;
+
+  if (!LoadBuffer(overview, file))
     return false;
 
   return true;
 }
+
+TerrainTileStore::Header
+RasterTileCache::MakeTileStoreHeader() const
+{
+  TerrainTileStore::Header header;
+  header.version = TerrainTileStore::Header::VERSION;
+  header.width = width;
+  header.height = height;
+  header.tile_width = tile_width;
+  header.tile_height = tile_height;
+  header.tile_columns = tiles.GetWidth();
+  header.tile_rows = tiles.GetHeight();
+  return header;
+}
+
+AllocatedArray<unsigned>
+RasterTileCache::GetTileSizes() const
+{
+  AllocatedArray<unsigned> sizes(tiles.GetSize());
+  for (unsigned i = 0; i < tiles.GetSize(); ++i) {
+    const RasterTile &tile = tiles.GetLinear(i);
+    sizes[i] = tile.IsDefined()
+      ? tile.width * tile.height
+      : 0;
+  }
+
+  return sizes;
+}
+
+bool
+RasterTileCache::CreateTileStore(FILE *file) const
+{
+  if (!IsValid())
+    return false;
+
+  return TerrainTileStore::Create(file, MakeTileStoreHeader(),
+                                  GetTileSizes().begin());
+}
+
+bool
+RasterTileCache::OpenTileStore(FILE *file)
+{
+  if (!IsValid())
+    return false;
+
+  return tile_store.Open(file, MakeTileStoreHeader(),
+                         GetTileSizes().begin());
+}
@@ -27,9 +27,14 @@ Copyright_License {
 #include "RasterTraits.hpp"
 #include "RasterTile.hpp"
 #include "RasterLocation.hpp"
+#include "TileStore.hpp"
 #include "Geo/GeoBounds.hpp"
+#include "Util/AllocatedGrid.hxx"
 #include "Util/StaticArray.hxx"
 #include "Util/Serial.hpp"
+#include "Thread/Mutex.hpp"
+
+#include <chrono>
 
 #include <assert.h>
 #include <stdio.h>
@@ -40,20 +45,83 @@ Copyright_License {
 struct jas_matrix;
 struct GridLocation;
 
+/**
+ * A corridor along the predicted flight path, in raster pixels.
+ * Tiles within this corridor are loaded after all visible tiles, see
+ * RasterTileCache::PollTiles().
+ */
+struct RasterPrefetchPath {
+  SignedRasterLocation start, end;
+  unsigned radius;
+};
+
+/**
+ * Counters describing the efficiency of the #RasterTileCache.  Hits
+ * are counted per tile and PollTiles() call: a hit is a tile in range
+ * which was already loaded.  A miss is a tile which had to be loaded
+ * (from the #TerrainTileStore or by decoding it); it is counted once,
+ * when the tile is requested for the first time since it was last
+ * loaded.
+ */
+struct RasterTileCacheStatistics {
+  unsigned hits, misses;
+
+  /**
+   * The number of loaded tiles which were disposed to stay within
+   * the budget.
+   */
+  unsigned evictions;
+
+  /**
+   * The total time spent decoding JPEG2000 tiles.
+   */
+  std::chrono::steady_clock::duration decode_time;
+
+  unsigned resident_tiles;
+  size_t resident_bytes;
+
+  /**
+   * The memory occupied by the pyramid levels.  It is charged to the
+   * budget, see RasterTileCache::GetTileBudget().
+   */
+  size_t pyramid_bytes;
+
+  /**
+   * The configured memory budget, see RasterTileCache::SetBudget().
+   */
+  size_t budget;
+
+  void Clear() {
+    hits = misses = evictions = 0;
+    decode_time = std::chrono::steady_clock::duration::zero();
+    resident_tiles = 0;
+    resident_bytes = 0;
+    pyramid_bytes = 0;
+  }
+};
+
 class RasterTileCache {
   static constexpr unsigned MAX_RTC_TILES = 4096;
 
+public:
   /**
-   * The maximum number of tiles which are loaded at a time.  This
-   * must be limited because the amount of memory is finite.
+   * The default maximum number of bytes occupied by loaded tiles.
+   * This must be limited because the amount of memory is finite.
+   * This equals 128 (Android) or 512 (desktop) tiles of 256x256
+   * pixels.
    */
 #if defined(ANDROID)
-  static constexpr unsigned MAX_ACTIVE_TILES = 128;
+  static constexpr size_t DEFAULT_BUDGET = 16 * 1024 * 1024;
 #else
   // desktop: use a lot of memory
-  static constexpr unsigned MAX_ACTIVE_TILES = 512;
+  static constexpr size_t DEFAULT_BUDGET = 64 * 1024 * 1024;
 #endif
 
+  static constexpr size_t MIN_BUDGET = 8 * 1024 * 1024;
+  static constexpr size_t MAX_BUDGET = 256 * 1024 * 1024;
+
+private:
+
   /**
    * The width and height of the terrain bitmap is shifted by this
    * number of bits to determine the overview size.
@@ -62,6 +130,32 @@ class RasterTileCache {
 
   static constexpr unsigned OVERVIEW_MASK = (~0u) << OVERVIEW_BITS;
 
+  /**
+   * The finest pyramid level is the terrain bitmap shifted by this
+   * number of bits.  There is one level for each bit up to (but
+   * excluding) #OVERVIEW_BITS; the overview is the coarsest level.
+   * Half resolution is omitted, because it would cost a quarter of
+   * the whole map in RAM, while the (loaded) tiles cover that range
+   * well enough.
+   *
+   * The levels cost about 1/16+1/64 (desktop) or 1/64 (Android and
+   * Kobo) of the full-resolution map, in RAM and in the cache file.
+   * This is charged to the tile #budget, i.e. fewer tiles are kept
+   * loaded.
+   *
+   * The levels are scanned by the renderer at mid and far zoom (see
+   * ScanLine()), and are the fallback where no tile is loaded.  Each
+   * pixel of a pyramid level is the maximum of the map pixels it
+   * covers, so the levels never hide terrain from clearance checks.
+   */
+#if defined(ANDROID) || defined(KOBO)
+  static constexpr unsigned PYRAMID_MIN_BITS = 3;
+#else
+  static constexpr unsigned PYRAMID_MIN_BITS = 2;
+#endif
+
+  static constexpr unsigned PYRAMID_LEVELS = OVERVIEW_BITS - PYRAMID_MIN_BITS;
+
   /**
    * Target number of steps in intersection searches; total distance
    * is shifted by this number of bits
@@ -101,7 +195,7 @@ protected:
   };
 
   struct CacheHeader {
-    static constexpr unsigned VERSION = 0xb;
+    static constexpr unsigned VERSION = 0xd;
 
     unsigned version;
     unsigned width, height;
@@ -123,6 +217,15 @@ protected:
   unsigned short tile_width, tile_height;
 
   RasterBuffer overview;
+
+  /**
+   * Reduced-resolution copies of the whole map between the tiles and
+   * the #overview, each half the size of the previous one.  Element
+   * i is the map shifted by #PYRAMID_MIN_BITS+i bits.  They are built
+   * together with the #overview and saved in the cache file.
+   */
+  RasterBuffer pyramid[PYRAMID_LEVELS];
+
   unsigned int width, height;
   unsigned int overview_width_fine, overview_height_fine;
 
@@ -130,6 +233,12 @@ protected:
 
   StaticArray<MarkerSegmentInfo, 8192> segments;
 
+  /**
+   * Optional persistent storage for decoded tiles.  See
+   * OpenTileStore().
+   */
+  TerrainTileStore tile_store;
+
   /**
    * An array that is used to sort the requested tiles by distance.
    * This is only used by PollTiles() internally, but is stored in the
@@ -137,6 +246,28 @@ protected:
    */
   StaticArray<uint16_t, MAX_RTC_TILES> request_tiles;
 
+  /**
+   * Incremented by each PollTiles() call.  See
+   * RasterTile::last_used.
+   */
+  unsigned poll_counter = 0;
+
+  /**
+   * Protects #budget and #statistics, which may be accessed by other
+   * threads while the terrain thread loads tiles.
+   */
+  mutable Mutex statistics_mutex;
+
+  /**
+   * The maximum number of bytes occupied by loaded tiles and by the
+   * #pyramid levels.  When it is exceeded, tiles which are out of
+   * range are disposed (least recently used first), then the most
+   * distant ones.
+   */
+  size_t budget = DEFAULT_BUDGET;
+
+  RasterTileCacheStatistics statistics;
+
 public:
   RasterTileCache() {
     Reset();
@@ -156,6 +287,24 @@ protected:
                     TerrainHeight *buffer, unsigned size,
                     bool interpolate) const;
 
+  /**
+   * Returns the finest reduced-resolution buffer (pyramid level or
+   * overview) whose pixels are not smaller than 2^min_bits map
+   * pixels.
+   *
+   * @param bits_r receives the number of bits the map is shifted by
+   * in the returned buffer
+   */
+  const RasterBuffer &GetLevel(unsigned min_bits, unsigned &bits_r) const;
+
+  /**
+   * Returns the finest reduced-resolution buffer, to be used where
+   * no tile is loaded.
+   */
+  const RasterBuffer &GetFallbackLevel(unsigned &bits_r) const {
+    return GetLevel(0, bits_r);
+  }
+
 public:
   /**
    * Determine the non-interpolated height at the specified pixel
@@ -178,9 +327,36 @@ public:
   TerrainHeight GetInterpolatedHeight(unsigned lx,
                                       unsigned ly) const;
 
+  /**
+   * Determine the non-interpolated heights at many pixel locations.
+   * This is cheaper than calling GetHeight() for each one, because
+   * the tile is only looked up again when a point leaves the
+   * previous point's tile; therefore, the points should be spatially
+   * ordered (e.g. along a line or around a fan).
+   *
+   * @param points pixel locations; may be out of range
+   */
+  gcc_nonnull_all
+  void GetHeights(const SignedRasterLocation *gcc_restrict points,
+                  TerrainHeight *gcc_restrict heights, unsigned n) const;
+
+  /**
+   * Like GetHeights(), but interpolated.
+   *
+   * @param points sub-pixel locations; may be out of range
+   */
+  gcc_nonnull_all
+  void GetInterpolatedHeights(const SignedRasterLocation *gcc_restrict points,
+                              TerrainHeight *gcc_restrict heights,
+                              unsigned n) const;
+
   /**
    * Scan a straight line and fill the buffer with the specified
-   * number of samples along the line.
+   * number of samples along the line.  This is meant for rendering:
+   * if the samples are spread several pixels apart, the pyramid
+   * level matching that distance is scanned instead of the tiles.
+   * Calculations use GetHeight() and the intersection methods, which
+   * always prefer the full-resolution tiles.
    *
    * @param start the sub-pixel start location
    * @param end the sub-pixel end location
@@ -217,10 +393,33 @@ private:
   gcc_pure
   std::pair<TerrainHeight, bool> GetFieldDirect(unsigned px, unsigned py) const;
 
+  gcc_pure
+  TerrainTileStore::Header MakeTileStoreHeader() const;
+
+  gcc_pure
+  AllocatedArray<unsigned> GetTileSizes() const;
+
 public:
   bool SaveCache(FILE *file) const;
   bool LoadCache(FILE *file);
 
+  /**
+   * Initialise a new #TerrainTileStore file for this map.  This
+   * object must be valid, i.e. the overview must be loaded.
+   */
+  bool CreateTileStore(FILE *file) const;
+
+  /**
+   * Map a #TerrainTileStore file (created by CreateTileStore()) into
+   * memory.  From now on, decoded tiles are written to this file, and
+   * tiles which are already in the file are not decoded again.
+   */
+  bool OpenTileStore(FILE *file);
+
+  bool HasTileStore() const {
+    return tile_store.IsDefined();
+  }
+
   /**
    * Determines if there are still tiles scheduled to be loaded.  Call
    * this after UpdateTiles() to determine if UpdateTiles() should be
@@ -240,6 +439,39 @@ public:
 
   void Reset();
 
+  /**
+   * Calculate a suitable budget for a device with the given amount of
+   * physical memory (0 if unknown).
+   */
+  gcc_const
+  static size_t CalcBudget(uint64_t physical_memory);
+
+  size_t GetBudget() const {
+    const ScopeLock lock(statistics_mutex);
+    return budget;
+  }
+
+  /**
+   * Change the maximum number of bytes occupied by loaded tiles.  It
+   * is applied by the next PollTiles() call.  This method is
+   * thread-safe.
+   */
+  void SetBudget(size_t _budget) {
+    const ScopeLock lock(statistics_mutex);
+    budget = _budget;
+  }
+
+  /**
+   * Obtain a copy of the statistics.  This method is thread-safe.
+   */
+  gcc_pure
+  RasterTileCacheStatistics GetStatistics() const {
+    const ScopeLock lock(statistics_mutex);
+    RasterTileCacheStatistics result = statistics;
+    result.budget = budget;
+    return result;
+  }
+
   const GeoBounds &GetBounds() const {
     assert(bounds.IsValid());
 
@@ -269,6 +501,10 @@ public:
   void SetLatLonBounds(double lon_min, double lon_max,
                        double lat_min, double lat_max);
 
+  /**
+   * Copy a decoded tile into the #overview and into all #pyramid
+   * levels.
+   */
   void PutOverviewTile(unsigned index,
                        unsigned start_x, unsigned start_y,
                        unsigned end_x, unsigned end_y,
@@ -276,6 +512,25 @@ public:
 
   bool PollTiles(int x, int y, unsigned radius);
 
+  /**
+   * Like PollTiles(int, int, unsigned), but additionally request
+   * tiles along the given #RasterPrefetchPath.  These have a lower
+   * priority than tiles in the visible range: they are only
+   * activated after all of those, and they are the first tiles in
+   * range to be disposed when the #budget is exceeded.
+   */
+  bool PollTiles(int x, int y, unsigned radius,
+                 const RasterPrefetchPath &path);
+
+  /**
+   * Enable all requested tiles which are available in the
+   * #TerrainTileStore.  Call this after PollTiles().
+   *
+   * @return true if there are still requested tiles which need to be
+   * decoded
+   */
+  bool LoadStoredTiles();
+
   void PutTileData(unsigned index, const struct jas_matrix &m);
 
   void FinishTileUpdate();
@@ -304,6 +559,42 @@ public:
   }
 
 private:
+  /**
+   * Second half of PollTiles(): sort #request_tiles by priority if
+   * necessary, dispose tiles exceeding GetTileBudget() and request up to
+   * #MAX_ACTIVATE new ones.
+   *
+   * @param force_sort sort even if there are no surplus tiles, to ensure
+   * that tiles are activated in the order of their priority
+   */
+  bool ActivateRequestTiles(bool force_sort);
+
+  /**
+   * Returns the number of bytes occupied by the #pyramid levels.
+   */
+  gcc_pure
+  size_t GetPyramidMemorySize() const;
+
+  /**
+   * Returns the maximum number of bytes which may be occupied by
+   * loaded tiles: the #budget minus the #pyramid levels.  A quarter
+   * of the #budget is always left for the tiles, because the pyramid
+   * of a very large map would otherwise leave no room for them.
+   */
+  gcc_pure
+  size_t GetTileBudget() const;
+
+  /**
+   * Update #resident_tiles, #resident_bytes and #pyramid_bytes in
+   * #statistics.
+   */
+  void UpdateResidentStatistics();
+
+  void AddDecodeTime(std::chrono::steady_clock::duration t) {
+    const ScopeLock lock(statistics_mutex);
+    statistics.decode_time += t;
+  }
+
   unsigned GetFineTileWidth() const {
     return tile_width << RasterTraits::SUBPIXEL_BITS;
   }
@@ -24,6 +24,8 @@ Copyright_License {
 #include "Terrain/RasterTileCache.hpp"
 #include "Terrain/RasterLocation.hpp"
 
+#include <algorithm>
+
 #include <stdlib.h>
 
 struct GridLocation : public RasterLocation {
@@ -301,15 +303,38 @@ RasterTileCache::ScanTileLine(GridLocation start, GridLocation end,
     tile.ScanLine(start.x, start.y, end.x, end.y,
                   buffer + start.index, end.index - start.index,
                   interpolate);
-  else
-    /* need range checking in the overview buffer because its size may
+  else {
+    /* need range checking in the reduced buffer because its size may
        be rounded down, and then the "fine" location may exceed its
        bounds */
-    overview.ScanLineChecked(start.x >> OVERVIEW_BITS,
-                             start.y >> OVERVIEW_BITS,
-                             end.x >> OVERVIEW_BITS, end.y >> OVERVIEW_BITS,
-                             buffer + start.index, end.index - start.index,
-                             interpolate);
+    unsigned bits;
+    const RasterBuffer &level = GetFallbackLevel(bits);
+    level.ScanLineChecked(start.x >> bits, start.y >> bits,
+                          end.x >> bits, end.y >> bits,
+                          buffer + start.index, end.index - start.index,
+                          interpolate);
+  }
+}
+
+/**
+ * Determine how many bits the pixel distance between two adjacent
+ * samples has, i.e. log2 of the number of map pixels per sample,
+ * rounded down.
+ */
+gcc_const
+static unsigned
+SampleDistanceBits(RasterLocation start, RasterLocation end, unsigned size)
+{
+  const unsigned dx = abs((int)end.x - (int)start.x);
+  const unsigned dy = abs((int)end.y - (int)start.y);
+  const unsigned step = (std::max(dx, dy) / (size - 1))
+    >> RasterTraits::SUBPIXEL_BITS;
+
+  unsigned bits = 0;
+  while ((step >> bits) > 1)
+    ++bits;
+
+  return bits;
 }
 
 void
@@ -324,6 +349,20 @@ RasterTileCache::ScanLine(const RasterLocation _start,
   assert(_end.y < GetFineHeight());
   assert(size >= 2);
 
+  const unsigned min_bits = SampleDistanceBits(_start, _end, size);
+  if (min_bits >= PYRAMID_MIN_BITS) {
+    /* the samples (i.e. the renderer's quantisation) are too far
+       apart to benefit from the tiles' full resolution; scan the
+       matching pyramid level, which is always available and needs no
+       tile boundary handling */
+    unsigned bits;
+    const RasterBuffer &level = GetLevel(min_bits, bits);
+    level.ScanLineChecked(_start.x >> bits, _start.y >> bits,
+                          _end.x >> bits, _end.y >> bits,
+                          buffer, size, interpolate);
+    return;
+  }
+
   const GridRay ray(GetFineTileWidth(), GetFineTileHeight(),
                     _start, _end, size);
   assert(ray.size == size);
@@ -0,0 +1,238 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_SHADING_NEON_HPP
+#define XCSOAR_TERRAIN_SHADING_NEON_HPP
+
+#include "Portable.hpp"
+
+#ifndef __ARM_NEON__
+#error ARM NEON required
+#endif
+
+#include <arm_neon.h>
+
+/**
+ * Implementation of the #PortableTerrainShading kernels using ARM
+ * NEON instructions.  Each call processes a multiple of 8
+ * (SlopeRow()) or 16 (HeightRow()) pixels.
+ *
+ * NEON has neither a square root nor a division instruction, and
+ * only single precision floating point.  The square root and the
+ * quotient are estimated with Newton-Raphson iterations and then
+ * corrected with integer arithmetics, to yield exactly the same
+ * results as the portable implementation.
+ */
+class NEONTerrainShading {
+  struct SlopeConstants {
+    int32x4_t num_base;
+    uint32x4_t dd2_squared;
+    int16_t sx, sy;
+    int32x4_t sz;
+    int32_t contrast;
+  };
+
+  /**
+   * Calculate floor(sqrt(x)) for values below 2^32.
+   */
+  gcc_always_inline
+  static uint32x4_t SquareRoot(uint32x4_t x) {
+    const uint32x4_t one = vdupq_n_u32(1);
+
+    const float32x4_t f = vcvtq_f32_u32(x);
+    float32x4_t e = vrsqrteq_f32(f);
+    e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(f, e), e));
+    e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(f, e), e));
+
+    /* the estimate is off by at most one */
+    uint32x4_t r = vcvtq_u32_f32(vmulq_f32(f, e));
+    r = vsubq_u32(r, vandq_u32(vcgtq_u32(vmulq_u32(r, r), x), one));
+
+    const uint32x4_t r1 = vaddq_u32(r, one);
+    r = vaddq_u32(r, vandq_u32(vcleq_u32(vmulq_u32(r1, r1), x), one));
+    return r;
+  }
+
+  /**
+   * Calculate a / b, truncating towards zero like the C division
+   * operator.  The quotient must be small (i.e. far below 2^24).
+   */
+  gcc_always_inline
+  static int32x4_t Divide(int32x4_t a, uint32x4_t b) {
+    const uint32x4_t one = vdupq_n_u32(1);
+
+    const uint32x4_t abs_a = vreinterpretq_u32_s32(vabsq_s32(a));
+
+    const float32x4_t fb = vcvtq_f32_u32(b);
+    float32x4_t r = vrecpeq_f32(fb);
+    r = vmulq_f32(r, vrecpsq_f32(fb, r));
+    r = vmulq_f32(r, vrecpsq_f32(fb, r));
+
+    /* the estimate is off by at most one; check the remainder */
+    uint32x4_t q = vcvtq_u32_f32(vmulq_f32(vcvtq_f32_u32(abs_a), r));
+    const int32x4_t remainder =
+      vsubq_s32(vreinterpretq_s32_u32(abs_a),
+                vreinterpretq_s32_u32(vmulq_u32(q, b)));
+    q = vsubq_u32(q, vandq_u32(vcltq_s32(remainder, vdupq_n_s32(0)), one));
+    q = vaddq_u32(q, vandq_u32(vcgeq_s32(remainder,
+                                         vreinterpretq_s32_u32(b)), one));
+
+    const int32x4_t s = vreinterpretq_s32_u32(q);
+    return vbslq_s32(vcltq_s32(a, vdupq_n_s32(0)), vnegq_s32(s), s);
+  }
+
+  /**
+   * Calculate the illumination index for 4 pixels.
+   *
+   * @return the illumination index (int32, not clipped)
+   */
+  gcc_always_inline
+  static int32x4_t Slope4(int16x4_t dd0, int16x4_t dd1,
+                          const SlopeConstants &c) {
+    const int32x4_t num = vmlal_n_s16(vmlal_n_s16(c.num_base, dd0, c.sx),
+                                      dd1, c.sy);
+
+    /* dd0*dd0+dd1*dd1 fits in int32, but adding dd2*dd2 may not */
+    const uint32x4_t square_mag =
+      vaddq_u32(vreinterpretq_u32_s32(vmlal_s16(vmull_s16(dd0, dd0),
+                                                dd1, dd1)),
+                c.dd2_squared);
+
+    const uint32x4_t mag = vorrq_u32(SquareRoot(square_mag),
+                                     vdupq_n_u32(1));
+    const int32x4_t sval = Divide(num, mag);
+
+    /* sindex = (sval - sz) * contrast / 128 */
+    int32x4_t t = vmulq_n_s32(vsubq_s32(sval, c.sz), c.contrast);
+    t = vaddq_s32(t, vandq_s32(vshrq_n_s32(t, 31), vdupq_n_s32(127)));
+    return vshrq_n_s32(t, 7);
+  }
+
+  /**
+   * Calculate the difference of two height vectors and clip it to
+   * -512..512.  The saturating subtraction cannot change the
+   * result, because it saturates far outside of the clip range.
+   */
+  gcc_always_inline
+  static int16x8_t ClipHeightDelta(int16x8_t a, int16x8_t b) {
+    const int16x8_t d = vqsubq_s16(a, b);
+    return vminq_s16(vmaxq_s16(d, vdupq_n_s16(-512)), vdupq_n_s16(512));
+  }
+
+  gcc_always_inline
+  static int16x8_t Load8(const TerrainHeight *p) {
+    return vld1q_s16((const int16_t *)p);
+  }
+
+public:
+  gcc_flatten gcc_nonnull_all
+  static void SlopeRow(int8_t *gcc_restrict dest,
+                       const TerrainHeight *above,
+                       const TerrainHeight *below,
+                       const TerrainHeight *left,
+                       const TerrainHeight *right,
+                       unsigned n,
+                       const TerrainShadingParameters &params) {
+    const unsigned dd2 = params.p20 * params.p31 * params.height_slope_factor;
+
+    const SlopeConstants c = {
+      vdupq_n_s32(int(dd2) * params.sz),
+      vdupq_n_u32(dd2 * dd2),
+      int16_t(params.sx), int16_t(params.sy),
+      vdupq_n_s32(params.sz),
+      params.contrast,
+    };
+
+    const int16_t p31 = params.p31;
+    const int16_t p20 = params.p20;
+
+    const int16x8_t max_index = vdupq_n_s16(63);
+    const int16x8_t min_index = vdupq_n_s16(-63);
+
+    for (unsigned i = 0; i < n; i += 8) {
+      const int16x8_t p32 = ClipHeightDelta(Load8(above + i),
+                                            Load8(below + i));
+      const int16x8_t p22 = ClipHeightDelta(Load8(right + i),
+                                            Load8(left + i));
+
+      /* these fit in 16 bit: 512 * 50 */
+      const int16x8_t dd0 = vmulq_n_s16(p22, p31);
+      const int16x8_t dd1 = vmulq_n_s16(p32, p20);
+
+      const int32x4_t index_low = Slope4(vget_low_s16(dd0),
+                                         vget_low_s16(dd1), c);
+      const int32x4_t index_high = Slope4(vget_high_s16(dd0),
+                                          vget_high_s16(dd1), c);
+
+      int16x8_t index = vcombine_s16(vqmovn_s32(index_low),
+                                     vqmovn_s32(index_high));
+      index = vminq_s16(vmaxq_s16(index, min_index), max_index);
+
+      vst1_s8(dest + i, vqmovn_s16(index));
+    }
+  }
+
+  gcc_flatten gcc_nonnull_all
+  static void HeightRow(uint8_t *gcc_restrict index,
+                        uint8_t *gcc_restrict contour,
+                        const TerrainHeight *gcc_restrict src, unsigned n,
+                        unsigned height_scale,
+                        unsigned contour_height_scale) {
+    const int16x8_t zero = vdupq_n_s16(0);
+    const int16x8_t special_threshold = vdupq_n_s16(-30000);
+    const uint16x8_t max_value = vdupq_n_u16(254);
+    const uint16x8_t special_index = vdupq_n_u16(255);
+
+    /* a negative shift count shifts to the right */
+    const int16x8_t shift = vdupq_n_s16(-int16_t(height_scale));
+    const int16x8_t contour_shift =
+      vdupq_n_s16(-int16_t(contour_height_scale));
+
+    for (unsigned i = 0; i < n; i += 16) {
+      const int16x8_t e0 = Load8(src + i);
+      const int16x8_t e1 = Load8(src + i + 8);
+
+      const uint16x8_t special0 = vcleq_s16(e0, special_threshold);
+      const uint16x8_t special1 = vcleq_s16(e1, special_threshold);
+
+      /* "special" values are negative and become 0 here */
+      const uint16x8_t h0 = vreinterpretq_u16_s16(vmaxq_s16(e0, zero));
+      const uint16x8_t h1 = vreinterpretq_u16_s16(vmaxq_s16(e1, zero));
+
+      uint16x8_t i0 = vminq_u16(vshlq_u16(h0, shift), max_value);
+      uint16x8_t i1 = vminq_u16(vshlq_u16(h1, shift), max_value);
+      i0 = vorrq_u16(i0, vandq_u16(special0, special_index));
+      i1 = vorrq_u16(i1, vandq_u16(special1, special_index));
+
+      const uint16x8_t c0 = vminq_u16(vshlq_u16(h0, contour_shift),
+                                      max_value);
+      const uint16x8_t c1 = vminq_u16(vshlq_u16(h1, contour_shift),
+                                      max_value);
+
+      vst1q_u8(index + i, vcombine_u8(vmovn_u16(i0), vmovn_u16(i1)));
+      vst1q_u8(contour + i, vcombine_u8(vmovn_u16(c0), vmovn_u16(c1)));
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,94 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_SHADING_OPTIMISED_HPP
+#define XCSOAR_TERRAIN_SHADING_OPTIMISED_HPP
+
+#include "Portable.hpp"
+
+#ifdef __ARM_NEON__
+#include "NEON.hpp"
+#elif defined(__SSE2__)
+#include "SSE2.hpp"
+#endif
+
+/**
+ * This class hosts two implementations: one that is optimised (e.g.
+ * via SIMD) and one that is portable (but slow).  The optimised one
+ * will be used as much as possible, and for the odd remainder, we
+ * use the portable version.
+ */
+template<typename Optimised, unsigned SLOPE_N, unsigned HEIGHT_N,
+         typename Portable>
+class SelectOptimisedTerrainShading : public Portable {
+  static constexpr unsigned SLOPE_MASK = ~(SLOPE_N - 1);
+  static constexpr unsigned HEIGHT_MASK = ~(HEIGHT_N - 1);
+
+public:
+  gcc_flatten gcc_nonnull_all
+  static void SlopeRow(int8_t *gcc_restrict dest,
+                       const TerrainHeight *above,
+                       const TerrainHeight *below,
+                       const TerrainHeight *left,
+                       const TerrainHeight *right,
+                       unsigned n,
+                       const TerrainShadingParameters &params) {
+    const unsigned no = n & SLOPE_MASK;
+
+    Optimised::SlopeRow(dest, above, below, left, right, no, params);
+    Portable::SlopeRow(dest + no, above + no, below + no,
+                       left + no, right + no, n - no, params);
+  }
+
+  gcc_flatten gcc_nonnull_all
+  static void HeightRow(uint8_t *gcc_restrict index,
+                        uint8_t *gcc_restrict contour,
+                        const TerrainHeight *gcc_restrict src, unsigned n,
+                        unsigned height_scale,
+                        unsigned contour_height_scale) {
+    const unsigned no = n & HEIGHT_MASK;
+
+    Optimised::HeightRow(index, contour, src, no,
+                         height_scale, contour_height_scale);
+    Portable::HeightRow(index + no, contour + no, src + no, n - no,
+                        height_scale, contour_height_scale);
+  }
+};
+
+#ifdef __ARM_NEON__
+
+typedef SelectOptimisedTerrainShading<NEONTerrainShading, 8, 16,
+                                      PortableTerrainShading> OptimisedTerrainShading;
+
+#elif defined(__SSE2__)
+
+typedef SelectOptimisedTerrainShading<SSE2TerrainShading, 8, 16,
+                                      PortableTerrainShading> OptimisedTerrainShading;
+
+#else
+
+typedef PortableTerrainShading OptimisedTerrainShading;
+
+#endif
+
+#endif
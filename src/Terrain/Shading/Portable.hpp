@@ -0,0 +1,152 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_SHADING_PORTABLE_HPP
+#define XCSOAR_TERRAIN_SHADING_PORTABLE_HPP
+
+#include "Terrain/Height.hpp"
+#include "Util/Clamp.hpp"
+#include "Compiler.h"
+
+#include <algorithm>
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * Parameters for the slope shading formula which are constant within
+ * one row of the height matrix.
+ */
+struct TerrainShadingParameters {
+  /**
+   * The light source vector, scaled to 255.
+   */
+  int sx, sy, sz;
+
+  int contrast;
+
+  /**
+   * The horizontal and vertical distance (in height matrix cells)
+   * of the neighbours used to calculate the slope.  Must not exceed
+   * 50.
+   */
+  unsigned p20, p31;
+
+  /**
+   * The product p20*p31*height_slope_factor must not exceed 32768,
+   * or the formula may overflow.
+   */
+  unsigned height_slope_factor;
+};
+
+/**
+ * Portable (and slow) implementation of the per-pixel kernels used by
+ * #RasterRenderer.  This is the reference for the optimised
+ * implementations, which must produce exactly the same results.
+ */
+class PortableTerrainShading {
+public:
+  /**
+   * Clip the difference between two adjacent terrain height values
+   * to sane bounds.  This works around integer overflows in the
+   * SlopeIndex() formula when the map file is broken, avoiding the
+   * sqrt() call with a negative argument.
+   */
+  gcc_const
+  static int ClipHeightDelta(TerrainHeight a, TerrainHeight b) {
+    return Clamp(a.GetValue() - b.GetValue(), -512, 512);
+  }
+
+  /**
+   * Calculate the illumination index (-63..63) of one pixel.
+   *
+   * @param p22 the clipped height difference between the right and
+   * the left neighbour
+   * @param p32 the clipped height difference between the upper and
+   * the lower neighbour
+   */
+  gcc_pure
+  static int SlopeIndex(int p22, int p32, unsigned p20, unsigned p31,
+                        const TerrainShadingParameters &params) {
+    const int dd0 = p22 * int(p31);
+    const int dd1 = int(p20) * p32;
+    const unsigned dd2 = p20 * p31 * params.height_slope_factor;
+    const int num = (int(dd2) * params.sz + dd0 * params.sx +
+                     dd1 * params.sy);
+    const unsigned square_mag = dd0 * dd0 + dd1 * dd1 + dd2 * dd2;
+    const unsigned mag = (unsigned)sqrt(square_mag);
+    /* this is a workaround for a SIGFPE (division by zero)
+       observed by our users on some Android devices (e.g. Nexus
+       7), even though we did our best to make sure that the
+       integer arithmetics above can't overflow */
+    /* TODO: debug this problem and replace this workaround */
+    const int sval = num / int(mag|1);
+    const int sindex = (sval - params.sz) * params.contrast / 128;
+    return Clamp(sindex, -63, 63);
+  }
+
+  /**
+   * Calculate the illumination index of #n pixels in a row, using
+   * the neighbours at #params.p20 / #params.p31.  The four pointers
+   * refer to the neighbours of the first pixel.
+   */
+  gcc_nonnull_all
+  static void SlopeRow(int8_t *gcc_restrict dest,
+                       const TerrainHeight *above,
+                       const TerrainHeight *below,
+                       const TerrainHeight *left,
+                       const TerrainHeight *right,
+                       unsigned n,
+                       const TerrainShadingParameters &params) {
+    for (unsigned i = 0; i < n; ++i)
+      dest[i] = SlopeIndex(ClipHeightDelta(right[i], left[i]),
+                           ClipHeightDelta(above[i], below[i]),
+                           params.p20, params.p31, params);
+  }
+
+  /**
+   * Convert #n terrain heights to colour table columns (0..254, or
+   * 255 for "special" values) and contour intervals (0 for "special"
+   * values).
+   */
+  gcc_nonnull_all
+  static void HeightRow(uint8_t *gcc_restrict index,
+                        uint8_t *gcc_restrict contour,
+                        const TerrainHeight *gcc_restrict src, unsigned n,
+                        unsigned height_scale,
+                        unsigned contour_height_scale) {
+    for (unsigned i = 0; i < n; ++i) {
+      const TerrainHeight e = src[i];
+      if (gcc_likely(!e.IsSpecial())) {
+        const unsigned h = std::max(0, (int)e.GetValue());
+        index[i] = std::min(254u, h >> height_scale);
+        contour[i] = std::min(254u, h >> contour_height_scale);
+      } else {
+        index[i] = 255;
+        contour[i] = 0;
+      }
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,205 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_SHADING_SSE2_HPP
+#define XCSOAR_TERRAIN_SHADING_SSE2_HPP
+
+#include "Portable.hpp"
+
+#ifndef __SSE2__
+#error SSE2 required
+#endif
+
+#include <emmintrin.h>
+
+/**
+ * Implementation of the #PortableTerrainShading kernels using SSE2
+ * instructions.  Each call processes a multiple of 8 (SlopeRow()) or
+ * 16 (HeightRow()) pixels.
+ *
+ * The slope formula uses double precision for the square root and
+ * the divisions; all intermediate values are integers well below
+ * 2^53, therefore truncating the double result yields exactly what
+ * the integer arithmetics of the portable implementation yield.
+ */
+class SSE2TerrainShading {
+  struct SlopeConstants {
+    __m128d dd2_squared, sz, contrast;
+  };
+
+  /**
+   * Finish the slope formula for 4 pixels.
+   *
+   * @param num the numerator (int32)
+   * @param square_mag dd0*dd0+dd1*dd1 (int32, without dd2*dd2)
+   * @return the illumination index (int32, not clipped)
+   */
+  gcc_always_inline
+  static __m128i Slope4(__m128i num, __m128i square_mag,
+                        const SlopeConstants &c) {
+    const __m128i one = _mm_set1_epi32(1);
+
+    const __m128i num_high = _mm_shuffle_epi32(num, _MM_SHUFFLE(1, 0, 3, 2));
+    const __m128i square_mag_high =
+      _mm_shuffle_epi32(square_mag, _MM_SHUFFLE(1, 0, 3, 2));
+
+    /* mag = (unsigned)sqrt(square_mag) */
+    const __m128d sq0 = _mm_add_pd(_mm_cvtepi32_pd(square_mag),
+                                   c.dd2_squared);
+    const __m128d sq1 = _mm_add_pd(_mm_cvtepi32_pd(square_mag_high),
+                                   c.dd2_squared);
+    __m128i mag = _mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_sqrt_pd(sq0)),
+                                     _mm_cvttpd_epi32(_mm_sqrt_pd(sq1)));
+    mag = _mm_or_si128(mag, one);
+    const __m128i mag_high = _mm_shuffle_epi32(mag, _MM_SHUFFLE(1, 0, 3, 2));
+
+    /* sval = num / int(mag|1) */
+    const __m128i sval0 =
+      _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(num),
+                                  _mm_cvtepi32_pd(mag)));
+    const __m128i sval1 =
+      _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(num_high),
+                                  _mm_cvtepi32_pd(mag_high)));
+
+    /* sindex = (sval - sz) * contrast / 128 */
+    const __m128d t0 = _mm_mul_pd(_mm_sub_pd(_mm_cvtepi32_pd(sval0), c.sz),
+                                  c.contrast);
+    const __m128d t1 = _mm_mul_pd(_mm_sub_pd(_mm_cvtepi32_pd(sval1), c.sz),
+                                  c.contrast);
+
+    return _mm_unpacklo_epi64(_mm_cvttpd_epi32(t0), _mm_cvttpd_epi32(t1));
+  }
+
+  /**
+   * Calculate the difference of two height vectors and clip it to
+   * -512..512.  The saturating subtraction cannot change the
+   * result, because it saturates far outside of the clip range.
+   */
+  gcc_always_inline
+  static __m128i ClipHeightDelta(__m128i a, __m128i b) {
+    const __m128i d = _mm_subs_epi16(a, b);
+    return _mm_min_epi16(_mm_max_epi16(d, _mm_set1_epi16(-512)),
+                         _mm_set1_epi16(512));
+  }
+
+  gcc_always_inline
+  static __m128i Load8(const TerrainHeight *p) {
+    return _mm_loadu_si128((const __m128i *)p);
+  }
+
+public:
+  gcc_flatten gcc_nonnull_all
+  static void SlopeRow(int8_t *gcc_restrict dest,
+                       const TerrainHeight *above,
+                       const TerrainHeight *below,
+                       const TerrainHeight *left,
+                       const TerrainHeight *right,
+                       unsigned n,
+                       const TerrainShadingParameters &params) {
+    const unsigned dd2 = params.p20 * params.p31 * params.height_slope_factor;
+
+    const SlopeConstants c = {
+      _mm_set1_pd(double(dd2) * double(dd2)),
+      _mm_set1_pd(params.sz),
+      _mm_set1_pd(params.contrast / 128.),
+    };
+
+    const __m128i p31 = _mm_set1_epi16(params.p31);
+    const __m128i p20 = _mm_set1_epi16(params.p20);
+
+    /* (sx, sy) pairs for _mm_madd_epi16() */
+    const __m128i sxy = _mm_set1_epi32((unsigned(params.sy) << 16) |
+                                       (params.sx & 0xffff));
+    const __m128i num_base = _mm_set1_epi32(int(dd2) * params.sz);
+
+    const __m128i max_index = _mm_set1_epi16(63);
+    const __m128i min_index = _mm_set1_epi16(-63);
+
+    for (unsigned i = 0; i < n; i += 8) {
+      const __m128i p32 = ClipHeightDelta(Load8(above + i),
+                                          Load8(below + i));
+      const __m128i p22 = ClipHeightDelta(Load8(right + i),
+                                          Load8(left + i));
+
+      /* these fit in 16 bit: 512 * 50 */
+      const __m128i dd0 = _mm_mullo_epi16(p22, p31);
+      const __m128i dd1 = _mm_mullo_epi16(p32, p20);
+
+      const __m128i low = _mm_unpacklo_epi16(dd0, dd1);
+      const __m128i high = _mm_unpackhi_epi16(dd0, dd1);
+
+      const __m128i index_low =
+        Slope4(_mm_add_epi32(_mm_madd_epi16(low, sxy), num_base),
+               _mm_madd_epi16(low, low), c);
+      const __m128i index_high =
+        Slope4(_mm_add_epi32(_mm_madd_epi16(high, sxy), num_base),
+               _mm_madd_epi16(high, high), c);
+
+      __m128i index = _mm_packs_epi32(index_low, index_high);
+      index = _mm_min_epi16(_mm_max_epi16(index, min_index), max_index);
+
+      _mm_storel_epi64((__m128i *)(dest + i), _mm_packs_epi16(index, index));
+    }
+  }
+
+  gcc_flatten gcc_nonnull_all
+  static void HeightRow(uint8_t *gcc_restrict index,
+                        uint8_t *gcc_restrict contour,
+                        const TerrainHeight *gcc_restrict src, unsigned n,
+                        unsigned height_scale,
+                        unsigned contour_height_scale) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i special_threshold = _mm_set1_epi16(-30000 + 1);
+    const __m128i max_value = _mm_set1_epi16(254);
+    const __m128i special_index = _mm_set1_epi16(255);
+    const __m128i shift = _mm_cvtsi32_si128(height_scale);
+    const __m128i contour_shift = _mm_cvtsi32_si128(contour_height_scale);
+
+    for (unsigned i = 0; i < n; i += 16) {
+      const __m128i e0 = Load8(src + i);
+      const __m128i e1 = Load8(src + i + 8);
+
+      const __m128i special0 = _mm_cmplt_epi16(e0, special_threshold);
+      const __m128i special1 = _mm_cmplt_epi16(e1, special_threshold);
+
+      /* "special" values are negative and become 0 here */
+      const __m128i h0 = _mm_max_epi16(e0, zero);
+      const __m128i h1 = _mm_max_epi16(e1, zero);
+
+      __m128i i0 = _mm_min_epi16(_mm_srl_epi16(h0, shift), max_value);
+      __m128i i1 = _mm_min_epi16(_mm_srl_epi16(h1, shift), max_value);
+      i0 = _mm_or_si128(i0, _mm_and_si128(special0, special_index));
+      i1 = _mm_or_si128(i1, _mm_and_si128(special1, special_index));
+
+      const __m128i c0 = _mm_min_epi16(_mm_srl_epi16(h0, contour_shift),
+                                       max_value);
+      const __m128i c1 = _mm_min_epi16(_mm_srl_epi16(h1, contour_shift),
+                                       max_value);
+
+      _mm_storeu_si128((__m128i *)(index + i), _mm_packus_epi16(i0, i1));
+      _mm_storeu_si128((__m128i *)(contour + i), _mm_packus_epi16(c0, c1));
+    }
+  }
+};
+
+#endif
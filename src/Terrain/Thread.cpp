@@ -24,31 +24,81 @@ Copyright_License {
 #include "Thread.hpp"
 #include "RasterTerrain.hpp"
 #include "Projection/WindowProjection.hpp"
+#include "Geo/GeoVector.hpp"
 #include "Thread/Util.hpp"
 
+#include <algorithm>
+
 TerrainThread::TerrainThread(RasterTerrain &_terrain,
                              std::function<void()> &&_callback)
   :StandbyThread("Terrain"), terrain(_terrain),
    callback(std::move(_callback)) {}
 
-void
-TerrainThread::Trigger(const WindowProjection &projection)
-{
-  assert(projection.IsValid());
+/**
+ * Tiles are prefetched along the path the aircraft will fly within
+ * this number of seconds.
+ */
+static constexpr double PREFETCH_TIME = 600;
 
-  const ScopeLock protect(mutex);
+/**
+ * The maximum length of the prefetched flight path [m].
+ */
+static constexpr double MAX_PREFETCH_DISTANCE = 50000;
+
+/**
+ * The half width of the prefetched corridor [m].
+ */
+static constexpr double PREFETCH_RADIUS = 5000;
 
-  GeoPoint center = projection.GetGeoScreenCenter();
-  auto radius = projection.GetScreenWidthMeters() / 2;
+void
+TerrainThread::Trigger(const GeoPoint &center, double radius,
+                       const GeoPoint &prefetch_start,
+                       const GeoPoint &prefetch_end)
+{
   if (last_center.IsValid() && last_radius >= radius &&
-      last_center.DistanceS(center) < 1000)
+      last_center.DistanceS(center) < 1000 &&
+      (!prefetch_end.IsValid() ||
+       (last_prefetch_end.IsValid() &&
+        last_prefetch_end.DistanceS(prefetch_end) < 1000)))
     return;
 
   next_center = center;
   next_radius = radius;
+  next_prefetch_start = prefetch_start;
+  next_prefetch_end = prefetch_end;
   StandbyThread::Trigger();
 }
 
+void
+TerrainThread::Trigger(const WindowProjection &projection)
+{
+  assert(projection.IsValid());
+
+  const ScopeLock protect(mutex);
+
+  Trigger(projection.GetGeoScreenCenter(),
+          projection.GetScreenWidthMeters() / 2,
+          GeoPoint::Invalid(), GeoPoint::Invalid());
+}
+
+void
+TerrainThread::Trigger(const WindowProjection &projection,
+                       const GeoPoint &location, Angle track,
+                       double ground_speed)
+{
+  assert(projection.IsValid());
+  assert(location.IsValid());
+
+  const double distance = std::min(ground_speed * PREFETCH_TIME,
+                                   MAX_PREFETCH_DISTANCE);
+
+  const ScopeLock protect(mutex);
+
+  Trigger(projection.GetGeoScreenCenter(),
+          projection.GetScreenWidthMeters() / 2,
+          location, GeoVector(distance, track).EndPoint(location));
+}
+
 void
 TerrainThread::Tick()
 {
@@ -58,14 +108,21 @@ TerrainThread::Tick()
   while (next_center.IsValid() && again && !IsStopped()) {
     const GeoPoint center = next_center;
     const auto radius = next_radius;
+    const GeoPoint prefetch_start = next_prefetch_start;
+    const GeoPoint prefetch_end = next_prefetch_end;
 
     {
       const ScopeUnlock unlock(mutex);
-      again = terrain.UpdateTiles(center, radius);
+      again = prefetch_end.IsValid()
+        ? terrain.UpdateTiles(center, radius,
+                              prefetch_start, prefetch_end,
+                              PREFETCH_RADIUS)
+        : terrain.UpdateTiles(center, radius);
     }
 
     last_center = center;
     last_radius = radius;
+    last_prefetch_end = prefetch_end;
   }
 
   /* notify the client */
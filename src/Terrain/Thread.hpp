@@ -26,6 +26,7 @@ Copyright_License {
 
 #include "Thread/StandbyThread.hpp"
 #include "Geo/GeoPoint.hpp"
+#include "Math/Angle.hpp"
 
 #include <functional>
 
@@ -46,6 +47,18 @@ class TerrainThread final : private StandbyThread {
   GeoPoint next_center;
   double next_radius;
 
+  /**
+   * The end of the predicted flight path whose tiles were loaded
+   * last, or GeoPoint::Invalid() if there was no prefetch.
+   */
+  GeoPoint last_prefetch_end = GeoPoint::Invalid();
+
+  /**
+   * The predicted flight path to be prefetched in the next Tick().
+   * #next_prefetch_end is invalid if there is nothing to prefetch.
+   */
+  GeoPoint next_prefetch_start, next_prefetch_end = GeoPoint::Invalid();
+
 public:
   TerrainThread(RasterTerrain &_terrain, std::function<void()> &&_callback);
 
@@ -53,7 +66,23 @@ public:
 
   void Trigger(const WindowProjection &projection);
 
+  /**
+   * Like Trigger(const WindowProjection &), but additionally
+   * prefetch tiles along the predicted flight path, which is
+   * extrapolated from the given ground speed and track.  These tiles
+   * are loaded with a lower priority than the visible ones.
+   *
+   * @param location the aircraft location
+   * @param ground_speed the ground speed [m/s]
+   */
+  void Trigger(const WindowProjection &projection,
+               const GeoPoint &location, Angle track, double ground_speed);
+
 private:
+  void Trigger(const GeoPoint &center, double radius,
+               const GeoPoint &prefetch_start,
+               const GeoPoint &prefetch_end);
+
   /* virtual methods from class StandbyThread*/
   void Tick() override;
 };
@@ -0,0 +1,178 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "TileStore.hpp"
+
+#include <string.h>
+
+#ifdef HAVE_POSIX
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/**
+ * Tile slots are aligned to this boundary, to make sure that each
+ * page belongs to exactly one tile.
+ */
+static constexpr uint64_t SLOT_ALIGNMENT = 4096;
+
+static constexpr uint64_t
+AlignSlot(uint64_t offset)
+{
+  return (offset + SLOT_ALIGNMENT - 1) & ~(SLOT_ALIGNMENT - 1);
+}
+
+uint64_t
+TerrainTileStore::Layout(uint64_t start, const Header &header,
+                         const unsigned *tile_sizes,
+                         uint64_t &flags_offset, uint64_t *offsets)
+{
+  const unsigned n = header.tile_columns * header.tile_rows;
+
+  flags_offset = start + sizeof(header);
+
+  uint64_t position = AlignSlot(flags_offset + n);
+  for (unsigned i = 0; i < n; ++i) {
+    if (tile_sizes[i] == 0) {
+      offsets[i] = 0;
+      continue;
+    }
+
+    offsets[i] = position;
+    position = AlignSlot(position + tile_sizes[i] * sizeof(TerrainHeight));
+  }
+
+  return position;
+}
+
+bool
+TerrainTileStore::Create(FILE *file, const Header &header,
+                         const unsigned *tile_sizes)
+{
+#ifdef HAVE_POSIX
+  const long start = ftell(file);
+  if (start < 0)
+    return false;
+
+  const unsigned n = header.tile_columns * header.tile_rows;
+  AllocatedArray<uint64_t> offsets(n);
+  uint64_t flags_offset;
+  const uint64_t size = Layout(start, header, tile_sizes,
+                               flags_offset, offsets.begin());
+  if (size > MAX_SIZE)
+    return false;
+
+  /* the flags and the slots are zero-filled (and sparse) after
+     ftruncate() */
+  return fwrite(&header, sizeof(header), 1, file) == 1 &&
+    fflush(file) == 0 &&
+    ftruncate(fileno(file), size) == 0;
+#else
+  return false;
+#endif
+}
+
+bool
+TerrainTileStore::Open(FILE *file, const Header &header,
+                       const unsigned *tile_sizes)
+{
+  Close();
+
+#ifdef HAVE_POSIX
+  const long start = ftell(file);
+  if (start < 0)
+    return false;
+
+  Header old_header;
+  if (fread(&old_header, sizeof(old_header), 1, file) != 1 ||
+      memcmp(&old_header, &header, sizeof(header)) != 0)
+    return false;
+
+  const unsigned n = header.tile_columns * header.tile_rows;
+  offsets.ResizeDiscard(n);
+  uint64_t flags_offset;
+  const uint64_t size = Layout(start, header, tile_sizes,
+                               flags_offset, offsets.begin());
+
+  const int fd = fileno(file);
+  struct stat st;
+  if (size > MAX_SIZE || fstat(fd, &st) < 0 || uint64_t(st.st_size) != size) {
+    offsets.ResizeDiscard(0);
+    return false;
+  }
+
+  void *p = mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) {
+    offsets.ResizeDiscard(0);
+    return false;
+  }
+
+  mapping = (uint8_t *)p;
+  mapping_size = size;
+  flags = mapping + flags_offset;
+  return true;
+#else
+  return false;
+#endif
+}
+
+void
+TerrainTileStore::Close()
+{
+  if (mapping == nullptr)
+    return;
+
+#ifdef HAVE_POSIX
+  munmap(mapping, mapping_size);
+#endif
+
+  mapping = nullptr;
+  offsets.ResizeDiscard(0);
+  pending.clear();
+}
+
+void
+TerrainTileStore::Flush()
+{
+  if (pending.empty())
+    return;
+
+  assert(IsDefined());
+
+#ifdef HAVE_POSIX
+  /* write the tile data before setting the flags; the kernel may
+     write back pages of a shared mapping in any order.  Only dirty
+     pages are written, so one call for the whole mapping is
+     cheaper than one per tile. */
+  if (msync(mapping, mapping_size, MS_SYNC) < 0) {
+    pending.clear();
+    return;
+  }
+#endif
+
+  for (const unsigned index : pending)
+    flags[index] = 1;
+
+  pending.clear();
+}
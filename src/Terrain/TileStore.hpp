@@ -0,0 +1,189 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_TILE_STORE_HPP
+#define XCSOAR_TERRAIN_TILE_STORE_HPP
+
+#include "Height.hpp"
+#include "Util/AllocatedArray.hxx"
+#include "Compiler.h"
+
+#include <vector>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * A cache file which contains decoded terrain tiles.  It is mapped
+ * into memory, and #RasterTile objects point directly into the
+ * mapping, so tiles which have been decoded once (in this session or
+ * an earlier one) need not be decoded by libjasper again.
+ *
+ * The file consists of a #Header, one flag byte per tile and one
+ * page-aligned slot per tile.  The file is created sparse, so slots
+ * of tiles which were never decoded do not occupy disk space.
+ *
+ * This is only implemented on POSIX systems; elsewhere, Open() and
+ * Create() always fail.
+ */
+class TerrainTileStore {
+public:
+  struct Header {
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t version;
+    uint32_t width, height;
+    uint32_t tile_width, tile_height;
+    uint32_t tile_columns, tile_rows;
+  };
+
+private:
+  /**
+   * The file is not mapped if it would be larger than this.
+   */
+  static constexpr uint64_t MAX_SIZE = sizeof(void *) > 4
+    ? uint64_t(4) << 30
+    : uint64_t(512) << 20;
+
+  uint8_t *mapping = nullptr;
+  size_t mapping_size;
+
+  /**
+   * One byte per tile; non-zero means the slot contains valid data.
+   */
+  uint8_t *flags;
+
+  /**
+   * The offset of each tile's slot within the mapping.  0 means the
+   * tile is empty and has no slot.
+   */
+  AllocatedArray<uint64_t> offsets;
+
+  /**
+   * Tiles which have been written, but whose flag will only be set
+   * by Flush().
+   */
+  std::vector<unsigned> pending;
+
+public:
+  TerrainTileStore() = default;
+
+  ~TerrainTileStore() {
+    Close();
+  }
+
+  TerrainTileStore(const TerrainTileStore &) = delete;
+  TerrainTileStore &operator=(const TerrainTileStore &) = delete;
+
+  bool IsDefined() const {
+    return mapping != nullptr;
+  }
+
+  /**
+   * Initialise a new (empty) file.  Afterwards, the file must be
+   * closed and reopened with Open().
+   *
+   * @param file a file returned by FileCache::Save()
+   * @param tile_sizes the number of pixels of each tile
+   */
+  static bool Create(FILE *file, const Header &header,
+                     const unsigned *tile_sizes);
+
+  /**
+   * Map an existing file into memory.  Fails if the file was created
+   * for a different layout.
+   *
+   * @param file a file returned by FileCache::LoadWritable()
+   * @param tile_sizes the number of pixels of each tile
+   */
+  bool Open(FILE *file, const Header &header, const unsigned *tile_sizes);
+
+  void Close();
+
+  /**
+   * Returns the slot of the specified tile, or nullptr if the tile
+   * is not available in this store.
+   */
+  gcc_pure
+  TerrainHeight *GetTile(unsigned index) const {
+    assert(IsDefined());
+    assert(index < offsets.size());
+
+    return flags[index] != 0
+      ? GetSlot(index)
+      : nullptr;
+  }
+
+  /**
+   * Returns the slot where a newly decoded tile shall be written to,
+   * or nullptr if the tile has no slot.  Call CommitTile() after all
+   * pixels have been written.
+   */
+  gcc_pure
+  TerrainHeight *GetSlot(unsigned index) const {
+    assert(IsDefined());
+    assert(index < offsets.size());
+
+    return offsets[index] != 0
+      ? (TerrainHeight *)(mapping + offsets[index])
+      : nullptr;
+  }
+
+  /**
+   * Remember that all pixels of the tile have been written.  It will
+   * be marked as present by the next Flush() call.  This method does
+   * no I/O.
+   */
+  void CommitTile(unsigned index) {
+    assert(IsDefined());
+    assert(offsets[index] != 0);
+
+    pending.push_back(index);
+  }
+
+  /**
+   * Write all tiles passed to CommitTile() to disk, and then mark
+   * them as present, so after a crash, a flag never refers to
+   * incomplete data.  If writing fails, the tiles remain absent and
+   * will be decoded again.
+   *
+   * This blocks on disk I/O; do not call it while holding a lock
+   * which readers of the terrain need.
+   */
+  void Flush();
+
+private:
+  /**
+   * Calculate the location of the flags and of all tile slots.
+   *
+   * @param start the file position where the #Header begins
+   * @return the total file size
+   */
+  static uint64_t Layout(uint64_t start, const Header &header,
+                         const unsigned *tile_sizes,
+                         uint64_t &flags_offset, uint64_t *offsets);
+};
+
+#endif
@@ -682,10 +682,17 @@ static int jpc_dec_process_sod(jpc_dec_t *dec, jpc_ms_t *ms)
 	}
 
 	if (tile->numparts > 0 && tile->partno == tile->numparts - 1) {
-		if (jpc_dec_tiledecode(dec, tile)) {
-			return -1;
+		// XCSoar: all data of this tile has been read; let the
+		// loader decode it in a worker thread if it wants to.  The
+		// tile is marked "done" right now, because the main thread
+		// must not look at it anymore.
+		tile->state = JPC_TILE_DONE;
+		if (!jas_rtc_SubmitTile(dec->loader, dec, tile)) {
+			if (jpc_dec_tiledecode(dec, tile)) {
+				return -1;
+			}
+			jpc_dec_tilefini(dec, tile);
 		}
-		jpc_dec_tilefini(dec, tile);
 	}
 
 	dec->curtile = 0;
@@ -1075,11 +1082,23 @@ if (!prc->cblks) {
 	}
 #endif /* ENABLE_JASPER_PPM */
 
-	tile->state = JPC_TILE_DONE;
+	if (tile->state != JPC_TILE_DONE) {
+		/* (check first, because tiles decoded in a worker thread
+		   have been marked "done" already, and the main thread may
+		   be reading this attribute) */
+		tile->state = JPC_TILE_DONE;
+	}
 
 	return 0;
 }
 
+int jpc_dec_tiledecodefini(jpc_dec_t *dec, jpc_dec_tile_t *tile)
+{
+	int ret = jpc_dec_tiledecode(dec, tile);
+	jpc_dec_tilefini(dec, tile);
+	return ret;
+}
+
 static int jpc_dec_tiledecode(jpc_dec_t *dec, jpc_dec_tile_t *tile)
 {
 	int i;
@@ -1221,6 +1240,11 @@ static int jpc_dec_process_eoc(jpc_dec_t *dec, jpc_ms_t *ms)
 	/* Eliminate compiler warnings about unused variables. */
 	ms = 0;
 
+	// XCSoar: wait for tiles submitted by jas_rtc_SubmitTile()
+	if (!jas_rtc_WaitTiles(dec->loader)) {
+		return -1;
+	}
+
 	for (tileno = 0, tile = dec->tiles; tileno < dec->numtiles; ++tileno,
 	  ++tile) {
 		if (tile->state == JPC_TILE_ACTIVE) {
@@ -702,6 +702,11 @@ void jpc_dec_destroy(jpc_dec_t *dec);
 
 int jpc_dec_decode(jpc_dec_t *dec);
 
+/* XCSoar: Decode a tile which was passed to jas_rtc_SubmitTile(), and
+  free its resources.  This may be called from any thread, but only
+  once per tile. */
+int jpc_dec_tiledecodefini(jpc_dec_t *dec, jpc_dec_tile_t *tile);
+
 /* Create a decoder segment object. */
 gcc_malloc
 jpc_dec_seg_t *jpc_seg_alloc(void);
@@ -33,6 +33,16 @@ extern "C" {
                                      *data);
   }
 
+  int jas_rtc_SubmitTile(void *_loader, void *dec, void *tile) {
+    auto &loader = *(TerrainLoader *)_loader;
+    return loader.SubmitTile(dec, tile);
+  }
+
+  int jas_rtc_WaitTiles(void *_loader) {
+    auto &loader = *(TerrainLoader *)_loader;
+    return loader.WaitTiles();
+  }
+
   void jas_rtc_SetSize(void *_loader,
                        unsigned width, unsigned height,
                        unsigned tile_width, unsigned tile_height,
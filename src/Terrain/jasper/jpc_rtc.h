@@ -21,6 +21,26 @@ extern "C" {
 			   unsigned end_x, unsigned end_y,
 			   const struct jas_matrix *data);
 
+  /**
+   * All data of the tile has been read.  The loader may decode it
+   * asynchronously by calling jpc_dec_tiledecodefini() from another
+   * thread.
+   *
+   * @param dec a jpc_dec_t pointer
+   * @param tile a jpc_dec_tile_t pointer
+   * @return non-zero if the loader has taken over the tile, zero if
+   * the decoder shall decode it right away
+   */
+  int jas_rtc_SubmitTile(void *loader, void *dec, void *tile);
+
+  /**
+   * Wait until all tiles submitted by jas_rtc_SubmitTile() have been
+   * decoded.
+   *
+   * @return zero if decoding one of these tiles has failed
+   */
+  int jas_rtc_WaitTiles(void *loader);
+
   void jas_rtc_SetSize(void *loader,
 		       unsigned width, unsigned height,
 		       unsigned tile_width, unsigned tile_height,
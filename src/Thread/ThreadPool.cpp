@@ -0,0 +1,154 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+#ifdef HAVE_POSIX
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+unsigned
+ThreadPool::GetProcessorCount()
+{
+#ifdef HAVE_POSIX
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? unsigned(n) : 1u;
+#else
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0
+    ? unsigned(info.dwNumberOfProcessors)
+    : 1u;
+#endif
+}
+
+ThreadPool::ThreadPool(const char *name, unsigned n_threads,
+                       unsigned _max_queued, bool _idle_priority)
+  :max_queued(_max_queued > 0
+              ? _max_queued
+              : 2 * (n_threads > 0 ? n_threads : GetProcessorCount())),
+   idle_priority(_idle_priority)
+{
+  if (n_threads == 0)
+    n_threads = GetProcessorCount();
+
+  for (unsigned i = 0; i < n_threads; ++i) {
+    workers.emplace_back(name, *this);
+    if (!workers.back().Start()) {
+      workers.pop_back();
+      break;
+    }
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  mutex.Lock();
+  stop = true;
+  work_cond.broadcast();
+  mutex.Unlock();
+
+  for (auto &worker : workers)
+    worker.Join();
+}
+
+void
+ThreadPool::Submit(Job &&job)
+{
+  if (workers.empty()) {
+    job();
+    return;
+  }
+
+  const ScopeLock protect(mutex);
+
+  while (queue.size() >= max_queued)
+    done_cond.wait(mutex);
+
+  queue.emplace_back(std::move(job));
+  work_cond.signal();
+}
+
+void
+ThreadPool::Wait()
+{
+  const ScopeLock protect(mutex);
+
+  while (!queue.empty() || busy > 0)
+    done_cond.wait(mutex);
+}
+
+void
+ThreadPool::ForEach(unsigned n, const std::function<void(unsigned)> &f)
+{
+  std::atomic<unsigned> next(0);
+
+  const auto loop = [n, &f, &next](){
+    unsigned i;
+    while ((i = next++) < n)
+      f(i);
+  };
+
+  const unsigned n_jobs = std::min<unsigned>(GetSize(), n);
+  for (unsigned j = 0; j < n_jobs; ++j)
+    Submit(loop);
+
+  loop();
+  Wait();
+}
+
+void
+ThreadPool::Run()
+{
+  const ScopeLock protect(mutex);
+
+  while (true) {
+    if (queue.empty()) {
+      if (stop)
+        break;
+
+      work_cond.wait(mutex);
+      continue;
+    }
+
+    Job job = std::move(queue.front());
+    queue.pop_front();
+    ++busy;
+
+    /* wake up Submit() which may be waiting for a free queue slot */
+    done_cond.broadcast();
+
+    {
+      const ScopeUnlock unlock(mutex);
+      job();
+    }
+
+    --busy;
+    done_cond.broadcast();
+  }
+}
@@ -0,0 +1,144 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_THREAD_POOL_HPP
+#define XCSOAR_THREAD_POOL_HPP
+
+#include "Thread/Thread.hpp"
+#include "Thread/Mutex.hpp"
+#include "Cond.hxx"
+#include "Compiler.h"
+
+#include <functional>
+#include <list>
+#include <deque>
+
+/**
+ * A fixed number of threads which run jobs on behalf of one client
+ * thread.  Jobs run in no particular order; Wait() blocks until all
+ * submitted jobs have finished.
+ *
+ * If no thread could be started, Submit() runs the job in the
+ * calling thread.
+ */
+class ThreadPool {
+  class Worker final : public Thread {
+    ThreadPool &pool;
+
+  public:
+    Worker(const char *_name, ThreadPool &_pool)
+      :Thread(_name), pool(_pool) {}
+
+  protected:
+    /* virtual methods from class Thread */
+    void Run() override {
+      if (pool.idle_priority)
+        SetIdlePriority();
+
+      pool.Run();
+    }
+  };
+
+  typedef std::function<void()> Job;
+
+  Mutex mutex;
+
+  /**
+   * Signalled when a job was submitted or when the pool is being
+   * stopped.
+   */
+  Cond work_cond;
+
+  /**
+   * Signalled when a job has finished.
+   */
+  Cond done_cond;
+
+  std::deque<Job> queue;
+
+  std::list<Worker> workers;
+
+  /**
+   * Submit() blocks while this number of jobs is waiting in the
+   * queue.
+   */
+  const unsigned max_queued;
+
+  const bool idle_priority;
+
+  /**
+   * The number of jobs which are currently being executed.
+   */
+  unsigned busy = 0;
+
+  bool stop = false;
+
+public:
+  /**
+   * @param n_threads the number of threads; 0 means one per CPU
+   * @param max_queued the maximum number of jobs waiting in the
+   * queue; 0 means twice the number of threads
+   * @param idle_priority run the threads with "idle" priority?
+   */
+  ThreadPool(const char *name, unsigned n_threads=0,
+             unsigned max_queued=0, bool idle_priority=false);
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * Returns the number of online CPUs (at least 1).
+   */
+  gcc_pure
+  static unsigned GetProcessorCount();
+
+  unsigned GetSize() const {
+    return workers.size();
+  }
+
+  /**
+   * Enqueue a job.  Blocks while the queue is full.
+   */
+  void Submit(Job &&job);
+
+  /**
+   * Wait until all submitted jobs have finished.
+   */
+  void Wait();
+
+  /**
+   * Invoke f(i) for each i in [0, n) on all threads of this pool and
+   * on the calling thread.  Threads which are done fetch the next
+   * index, so the load is balanced even if the cost per index varies.
+   * Returns after all invocations (and all other submitted jobs) have
+   * finished.
+   */
+  void ForEach(unsigned n, const std::function<void(unsigned)> &f);
+
+private:
+  void Run();
+};
+
+#endif
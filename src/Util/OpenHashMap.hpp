@@ -0,0 +1,258 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_OPEN_HASH_MAP_HPP
+#define XCSOAR_OPEN_HASH_MAP_HPP
+
+#include "Compiler.h"
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+#include <assert.h>
+#include <stdint.h>
+
+/**
+ * A hash map with open addressing (linear probing).  All items are
+ * stored in one array in insertion order, and the hash table contains
+ * only indices into this array; this means that indices remain valid
+ * until Clear() is called, even when the table grows.  Items cannot
+ * be removed individually.
+ *
+ * Clear() keeps the allocated memory, so an object which is reused
+ * for similar amounts of data does not allocate anything after the
+ * first use.
+ */
+template<typename Key, typename Value,
+         typename Hash=std::hash<Key>,
+         typename KeyEqual=std::equal_to<Key>>
+class OpenHashMap {
+public:
+  struct Item {
+    Key key;
+    Value value;
+
+    Item(const Key &_key, const Value &_value)
+      :key(_key), value(_value) {}
+  };
+
+  typedef unsigned size_type;
+
+  static constexpr size_type NOT_FOUND = size_type(-1);
+
+private:
+  static constexpr size_type MIN_TABLE_SIZE = 64;
+
+  std::vector<Item> items;
+
+  /**
+   * The hash table; each element is an index into #items or
+   * #NOT_FOUND.  Its size is a power of two, and it is always at
+   * most half full.
+   */
+  std::vector<size_type> table;
+
+  /**
+   * The number of bits to shift the scrambled hash value to obtain a
+   * slot number; see GetSlot().
+   */
+  unsigned shift;
+
+  Hash hash;
+  KeyEqual key_equal;
+
+public:
+  explicit OpenHashMap(size_type reserve=0):shift(64) {
+    Reserve(reserve);
+  }
+
+  gcc_pure
+  bool IsEmpty() const {
+    return items.empty();
+  }
+
+  gcc_pure
+  size_type GetSize() const {
+    return items.size();
+  }
+
+  /**
+   * Allocate memory for the specified number of items.
+   */
+  void Reserve(size_type n) {
+    items.reserve(n);
+
+    size_type table_size = MIN_TABLE_SIZE;
+    while (table_size < 2 * n)
+      table_size <<= 1;
+
+    if (table_size > table.size())
+      Rehash(table_size);
+  }
+
+  /**
+   * Remove all items, but keep the allocated memory.
+   */
+  void Clear() {
+    items.clear();
+    std::fill(table.begin(), table.end(), NOT_FOUND);
+  }
+
+  Item &operator[](size_type i) {
+    assert(i < items.size());
+    return items[i];
+  }
+
+  const Item &operator[](size_type i) const {
+    assert(i < items.size());
+    return items[i];
+  }
+
+  /**
+   * @return the index of the item or #NOT_FOUND
+   */
+  gcc_pure
+  size_type Find(const Key &key) const {
+    if (table.empty())
+      return NOT_FOUND;
+
+    const size_type mask = table.size() - 1;
+    for (size_type slot = GetSlot(key);; slot = (slot + 1) & mask) {
+      const size_type i = table[slot];
+      if (i == NOT_FOUND || key_equal(items[i].key, key))
+        return i;
+    }
+  }
+
+  /**
+   * Insert a new item if the key does not exist yet.
+   *
+   * @return the index of the item and true if it was inserted
+   */
+  std::pair<size_type, bool> Insert(const Key &key, const Value &value) {
+    if (2 * (items.size() + 1) > table.size())
+      Rehash(std::max(MIN_TABLE_SIZE, size_type(2 * table.size())));
+
+    const size_type mask = table.size() - 1;
+    size_type slot = GetSlot(key);
+    for (;; slot = (slot + 1) & mask) {
+      const size_type i = table[slot];
+      if (i == NOT_FOUND)
+        break;
+
+      if (key_equal(items[i].key, key))
+        return std::make_pair(i, false);
+    }
+
+    const size_type i = items.size();
+    items.emplace_back(key, value);
+    table[slot] = i;
+    return std::make_pair(i, true);
+  }
+
+private:
+  /**
+   * Determine the first slot for the specified key.  The hash value
+   * is scrambled (Fibonacci hashing), because the hash functions
+   * used for coordinates tend to leave the low bits correlated.
+   */
+  gcc_pure
+  size_type GetSlot(const Key &key) const {
+    return size_type((uint64_t(hash(key)) * UINT64_C(0x9e3779b97f4a7c15))
+                     >> shift);
+  }
+
+  void Rehash(size_type new_size) {
+    assert((new_size & (new_size - 1)) == 0);
+
+    table.assign(new_size, NOT_FOUND);
+
+    shift = 64;
+    for (size_type n = new_size; n > 1; n >>= 1)
+      --shift;
+
+    const size_type mask = new_size - 1;
+    for (size_type i = 0, n = items.size(); i < n; ++i) {
+      size_type slot = GetSlot(items[i].key);
+      while (table[slot] != NOT_FOUND)
+        slot = (slot + 1) & mask;
+      table[slot] = i;
+    }
+  }
+};
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+constexpr typename OpenHashMap<Key, Value, Hash, KeyEqual>::size_type
+OpenHashMap<Key, Value, Hash, KeyEqual>::NOT_FOUND;
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual>
+constexpr typename OpenHashMap<Key, Value, Hash, KeyEqual>::size_type
+OpenHashMap<Key, Value, Hash, KeyEqual>::MIN_TABLE_SIZE;
+
+/**
+ * A set based on #OpenHashMap.
+ */
+template<typename Key,
+         typename Hash=std::hash<Key>,
+         typename KeyEqual=std::equal_to<Key>>
+class OpenHashSet {
+  struct Empty {};
+
+  typedef OpenHashMap<Key, Empty, Hash, KeyEqual> Map;
+
+  Map map;
+
+public:
+  typedef typename Map::size_type size_type;
+
+  explicit OpenHashSet(size_type reserve=0):map(reserve) {}
+
+  gcc_pure
+  size_type GetSize() const {
+    return map.GetSize();
+  }
+
+  void Reserve(size_type n) {
+    map.Reserve(n);
+  }
+
+  void Clear() {
+    map.Clear();
+  }
+
+  gcc_pure
+  bool Contains(const Key &key) const {
+    return map.Find(key) != Map::NOT_FOUND;
+  }
+
+  /**
+   * @return true if the key was inserted, false if it existed
+   * already
+   */
+  bool Insert(const Key &key) {
+    return map.Insert(key, Empty()).second;
+  }
+};
+
+#endif
@@ -0,0 +1,205 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * This program benchmarks AirspaceWarningManager::Update() with
+ * thousands of overlapping generated airspaces, like a dense TMA/CTR
+ * cluster.  Each result is printed on its own line as "NAME VALUE
+ * UNIT", to allow comparing the output of different versions with a
+ * script.
+ */
+
+#include "SyntheticAirspaces.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceWarningManager.hpp"
+#include "Engine/Airspace/AirspaceWarningConfig.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Engine/GlideSolvers/GlideSettings.hpp"
+#include "Engine/GlideSolvers/GlideState.hpp"
+#include "Engine/GlideSolvers/MacCready.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "Engine/Task/Stats/TaskStats.hpp"
+#include "Geo/GeoVector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * The numbers of airspaces to generate.
+ */
+static constexpr unsigned N_AIRSPACES[] = { 500, 2000, 8000 };
+
+/**
+ * The half width of the square where airspaces are generated [m].
+ */
+static constexpr double RADIUS = 30000;
+
+/**
+ * The number of Update() calls, one per simulated second.
+ */
+static constexpr unsigned N_STEPS = 1200;
+
+static constexpr unsigned N_LOOKUPS = 1 << 18;
+
+static double
+ToMicroseconds(Clock::duration d)
+{
+  return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(d).count();
+}
+
+static void
+Report(const char *name, unsigned n, double value, const char *unit)
+{
+  printf("%s_%u %.3f %s\n", name, n, value, unit);
+}
+
+/**
+ * Fly straight through the cluster, slowly descending, and measure
+ * each AirspaceWarningManager::Update() call.
+ *
+ * @param with_task follow a task leg to the far side of the cluster,
+ * which adds a task prediction to each update
+ * @return the duration of each call, sorted [us]
+ */
+static std::vector<double>
+Fly(AirspaceWarningManager &warnings, const GeoPoint &center,
+    bool with_task, unsigned &max_warnings)
+{
+  const GlidePolar glide_polar(1);
+  TaskStats task_stats = TaskStats();
+  task_stats.task_valid = false;
+
+  GlideSettings glide_settings;
+  glide_settings.SetDefaults();
+
+  const GeoPoint turn_point =
+    GeoVector(2 * RADIUS, Angle::Degrees(90)).EndPoint(center);
+
+  AircraftState state;
+  state.Reset();
+  state.location = GeoVector(RADIUS, Angle::Degrees(270)).EndPoint(center);
+  state.track = Angle::Degrees(90);
+  state.ground_speed = state.true_airspeed = 2 * RADIUS / N_STEPS;
+  state.altitude = 2000;
+  state.vario = state.netto_vario = -0.5;
+  state.time = 0;
+  state.flying = true;
+
+  warnings.Reset(state);
+
+  std::vector<double> times;
+  times.reserve(N_STEPS);
+  max_warnings = 0;
+
+  for (unsigned i = 0; i < N_STEPS; ++i) {
+    state = state.GetPredictedState(1);
+    state.time += 1;
+
+    if (with_task) {
+      ElementStat &leg = task_stats.current_leg;
+      leg.location_remaining = turn_point;
+      leg.solution_remaining =
+        MacCready::Solve(glide_settings, glide_polar,
+                         GlideState(GeoVector(state.location, turn_point),
+                                    0, state.altitude, SpeedVector::Zero()));
+      task_stats.task_valid = leg.solution_remaining.IsOk();
+    }
+
+    const auto start = Clock::now();
+    warnings.Update(state, glide_polar, task_stats, false, 1);
+    times.push_back(ToMicroseconds(Clock::now() - start));
+
+    max_warnings = std::max(max_warnings, unsigned(warnings.size()));
+  }
+
+  std::sort(times.begin(), times.end());
+  return times;
+}
+
+static double
+Mean(const std::vector<double> &times)
+{
+  double sum = 0;
+  for (const double t : times)
+    sum += t;
+
+  return sum / times.size();
+}
+
+static void
+Benchmark(unsigned n)
+{
+  const GeoPoint center(Angle::Degrees(7.7), Angle::Degrees(51.4));
+
+  Airspaces airspaces;
+  const auto list = GenerateSyntheticAirspaces(airspaces, center, n, RADIUS);
+  airspaces.Optimise();
+
+  AirspaceWarningConfig config;
+  config.SetDefaults();
+  AirspaceWarningManager warnings(config, airspaces);
+
+  unsigned max_warnings;
+  auto times = Fly(warnings, center, false, max_warnings);
+
+  Report("update_mean", n, Mean(times), "us");
+  Report("update_p99", n, times[times.size() * 99 / 100], "us");
+  Report("update_max", n, times.back(), "us");
+  Report("max_warnings", n, max_warnings, "warnings");
+
+  /* look up random airspaces, most of which have no warning; this
+     is what the warning visitors and the map renderer do */
+  unsigned n_found = 0;
+  const auto start = Clock::now();
+  for (unsigned i = 0; i < N_LOOKUPS; ++i)
+    if (warnings.GetWarningPtr(*list[i % list.size()]) != nullptr)
+      ++n_found;
+
+  Report("lookup", n, ToMicroseconds(Clock::now() - start) * 1000 / N_LOOKUPS,
+         "ns");
+
+  if (n_found == 42)
+    printf("\n");
+
+  /* the same flight along a task leg, with all three predictions */
+  AirspaceWarningManager task_warnings(config, airspaces);
+  times = Fly(task_warnings, center, true, max_warnings);
+
+  Report("update_task_mean", n, Mean(times), "us");
+  Report("update_task_p99", n, times[times.size() * 99 / 100], "us");
+  Report("max_task_warnings", n, max_warnings, "warnings");
+}
+
+int main(int argc, char **argv)
+{
+  for (const unsigned n : N_AIRSPACES)
+    Benchmark(n);
+
+  return EXIT_SUCCESS;
+}
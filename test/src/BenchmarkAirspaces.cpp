@@ -0,0 +1,139 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * This program benchmarks the spatial queries of the #Airspaces
+ * database with generated airspaces, spread over an area like a
+ * country-wide airspace file.  Each result is printed on its own line
+ * as "NAME VALUE UNIT", to allow comparing the output of different
+ * versions with a script.
+ */
+
+#include "SyntheticAirspaces.hpp"
+#include "DeterministicRandom.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceIntersectionVisitor.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "Geo/GeoVector.hpp"
+
+#include <chrono>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * The numbers of airspaces to generate.
+ */
+static constexpr unsigned N_AIRSPACES[] = { 1000, 5000, 20000 };
+
+/**
+ * The radius of the area where airspaces are generated [m].
+ */
+static constexpr double RADIUS = 500000;
+
+static constexpr unsigned N_QUERIES = 1 << 16;
+
+static double
+ToSeconds(Clock::duration d)
+{
+  return std::chrono::duration_cast<std::chrono::duration<double>>(d).count();
+}
+
+static double
+SecondsSince(Clock::time_point start)
+{
+  return ToSeconds(Clock::now() - start);
+}
+
+static void
+Report(const char *name, unsigned n, double value, const char *unit)
+{
+  printf("%s_%u %.3f %s\n", name, n, value, unit);
+}
+
+class CountingVisitor final : public AirspaceIntersectionVisitor {
+public:
+  unsigned n = 0;
+
+  void Visit(const AbstractAirspace &as) override {
+    ++n;
+  }
+};
+
+static void
+Benchmark(unsigned n)
+{
+  const GeoPoint center(Angle::Degrees(10), Angle::Degrees(50));
+
+  Airspaces airspaces;
+  GenerateSyntheticAirspaces(airspaces, center, n, RADIUS, 30000);
+
+  auto start = Clock::now();
+  airspaces.Optimise();
+  Report("optimise", n, SecondsSince(start) * 1000, "ms");
+
+  std::vector<GeoPoint> locations(N_QUERIES);
+  for (auto &i : locations)
+    i = RandomLocation(center, RADIUS);
+
+  /* prevent gcc from optimizing the loops away */
+  unsigned n_found = 0;
+
+  start = Clock::now();
+  for (const auto &location : locations)
+    for (const auto &i : airspaces.QueryWithinRange(location, 20000))
+      n_found += i.GetAirspace().IsActive();
+  Report("query_within_range", n,
+         N_QUERIES / SecondsSince(start) / 1e3, "k/s");
+
+  start = Clock::now();
+  for (const auto &location : locations)
+    for (const auto &i : airspaces.QueryInside(location))
+      n_found += i.GetAirspace().IsActive();
+  Report("query_inside", n, N_QUERIES / SecondsSince(start) / 1e3, "k/s");
+
+  /* 10 km legs, like the glide prediction of the airspace warnings */
+  CountingVisitor visitor;
+  start = Clock::now();
+  for (const auto &location : locations) {
+    const GeoPoint end =
+      GeoVector(10000, Angle::FullCircle() * Random()).EndPoint(location);
+    airspaces.VisitIntersecting(location, end, visitor);
+  }
+  Report("visit_intersecting", n,
+         N_QUERIES / SecondsSince(start) / 1e3, "k/s");
+
+  if (n_found + visitor.n == 42)
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+  for (const unsigned n : N_AIRSPACES)
+    Benchmark(n);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,290 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * This program benchmarks the route planner and the reach
+ * calculation on generated terrain, so it needs no map file and the
+ * results of different machines and versions can be compared.
+ * Solves are repeated over a grid of start heights and distances,
+ * and the latency percentiles and the search effort are printed as
+ * "NAME VALUE UNIT" lines.
+ */
+
+#include "SyntheticTerrain.hpp"
+#include "DeterministicRandom.hpp"
+#include "Route/TerrainRoute.hpp"
+#include "Route/ReachResult.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "GlideSolvers/GlideSettings.hpp"
+#include "GlideSolvers/GlidePolar.hpp"
+#include "Geo/SpeedVector.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Geo/GeoBounds.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * Start heights above the terrain [m].
+ */
+static constexpr int HEIGHTS[] = { 300, 800, 1500 };
+
+/**
+ * Distances between start and destination [m].
+ */
+static constexpr double DISTANCES[] = { 10000, 25000, 50000 };
+
+/**
+ * The number of directions flown from each start location.
+ */
+static constexpr unsigned N_BEARINGS = 8;
+
+/**
+ * The number of start locations for each start height.
+ */
+static constexpr unsigned N_ORIGINS = 32;
+
+/**
+ * The number of destinations looked up in each reach solution.
+ */
+static constexpr unsigned N_ARRIVALS = 256;
+
+static void
+Report(const char *name, double value, const char *unit)
+{
+  printf("%s %.3f %s\n", name, value, unit);
+}
+
+static double
+ToMicroseconds(Clock::duration d)
+{
+  return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(d).count();
+}
+
+/**
+ * Print the 50th, 90th and 99th percentile and the maximum of the
+ * given latencies.
+ */
+static void
+ReportLatencies(const char *name, std::vector<double> &latencies)
+{
+  if (latencies.empty())
+    return;
+
+  std::sort(latencies.begin(), latencies.end());
+
+  static constexpr unsigned percentiles[] = { 50, 90, 99 };
+
+  char buffer[64];
+  for (const unsigned p : percentiles) {
+    const unsigned i = (latencies.size() - 1) * p / 100;
+    snprintf(buffer, sizeof(buffer), "%s_p%u", name, p);
+    Report(buffer, latencies[i], "us");
+  }
+
+  snprintf(buffer, sizeof(buffer), "%s_max", name);
+  Report(buffer, latencies.back(), "us");
+}
+
+static AGeoPoint
+AboveTerrain(const RasterMap &map, const GeoPoint &location, int height)
+{
+  return AGeoPoint(location, map.GetHeight(location).GetValueOr0() + height);
+}
+
+/**
+ * Counts the fans and vertices of a reach solution.
+ */
+class FanCounter final : public FlatTriangleFanVisitor {
+public:
+  unsigned long n_fans = 0, n_vertices = 0;
+
+  void VisitFan(FlatGeoPoint origin,
+                ConstBuffer<FlatGeoPoint> fan) override {
+    ++n_fans;
+    n_vertices += fan.size;
+  }
+};
+
+static void
+BenchmarkSolve(const RasterMap &map, TerrainRoute &route,
+               const RoutePlannerConfig &config)
+{
+  const GeoPoint center = map.GetMapCenter();
+
+  for (const int height : HEIGHTS) {
+    for (const double distance : DISTANCES) {
+      std::vector<double> latencies;
+      unsigned long n_nodes = 0, n_links = 0, n_unique_links = 0;
+      unsigned long n_terrain_checks = 0;
+
+      SeedRandom();
+      for (unsigned i = 0; i < N_ORIGINS; ++i) {
+        const AGeoPoint origin =
+          AboveTerrain(map, RandomLocation(center, 20000), height);
+
+        for (unsigned j = 0; j < N_BEARINGS; ++j) {
+          const Angle bearing = Angle::FullCircle() * j / N_BEARINGS;
+          const AGeoPoint destination =
+            AboveTerrain(map,
+                         GeoVector(distance, bearing).EndPoint(origin), 100);
+
+          /* discard the previous solution, or Solve() would return
+             early */
+          route.Reset();
+
+          const auto start = Clock::now();
+          route.Solve(destination, origin, config);
+          latencies.push_back(ToMicroseconds(Clock::now() - start));
+
+          const auto statistics = route.GetStatistics();
+          n_nodes += statistics.nodes;
+          n_links += statistics.links;
+          n_unique_links += statistics.unique_links;
+          n_terrain_checks += statistics.terrain_checks;
+        }
+      }
+
+      const double n_solves = latencies.size();
+
+      char name[64];
+      snprintf(name, sizeof(name), "solve_h%d_d%u",
+               height, unsigned(distance / 1000));
+      ReportLatencies(name, latencies);
+
+      char buffer[96];
+      snprintf(buffer, sizeof(buffer), "%s_nodes", name);
+      Report(buffer, n_nodes / n_solves, "/solve");
+      snprintf(buffer, sizeof(buffer), "%s_links", name);
+      Report(buffer, n_links / n_solves, "/solve");
+      snprintf(buffer, sizeof(buffer), "%s_unique_links", name);
+      Report(buffer, n_unique_links / n_solves, "/solve");
+      snprintf(buffer, sizeof(buffer), "%s_terrain_checks", name);
+      Report(buffer, n_terrain_checks / n_solves, "/solve");
+    }
+  }
+}
+
+static void
+BenchmarkReach(const RasterMap &map, TerrainRoute &route,
+               const RoutePlannerConfig &config)
+{
+  const GeoPoint center = map.GetMapCenter();
+
+  std::vector<AGeoPoint> destinations(N_ARRIVALS);
+  std::vector<ReachResult> results(N_ARRIVALS);
+
+  for (const int height : HEIGHTS) {
+    std::vector<double> solve_latencies, arrival_latencies;
+    std::vector<double> batch_latencies;
+    unsigned long n_fans = 0, n_vertices = 0, n_reachable = 0;
+
+    SeedRandom();
+    for (unsigned i = 0; i < N_ORIGINS; ++i) {
+      const AGeoPoint origin =
+        AboveTerrain(map, RandomLocation(center, 20000), height);
+
+      route.ClearReach();
+
+      auto start = Clock::now();
+      route.SolveReachTerrain(origin, config, INT_MAX);
+      solve_latencies.push_back(ToMicroseconds(Clock::now() - start));
+
+      FanCounter counter;
+      route.AcceptInRange(map.GetBounds(), counter, false);
+      n_fans += counter.n_fans;
+      n_vertices += counter.n_vertices;
+
+      for (auto &destination : destinations)
+        destination = AboveTerrain(map, RandomLocation(origin, 60000), 0);
+
+      for (const auto &destination : destinations) {
+        ReachResult result;
+        start = Clock::now();
+        route.FindPositiveArrival(destination, result);
+        arrival_latencies.push_back(ToMicroseconds(Clock::now() - start));
+
+        if (result.IsReachableTerrain())
+          ++n_reachable;
+      }
+
+      start = Clock::now();
+      route.FindPositiveArrivals(destinations.data(), results.data(),
+                                 N_ARRIVALS);
+      batch_latencies.push_back(ToMicroseconds(Clock::now() - start)
+                                / N_ARRIVALS);
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "reach_h%d", height);
+    ReportLatencies(name, solve_latencies);
+
+    char buffer[96];
+    snprintf(buffer, sizeof(buffer), "%s_fans", name);
+    Report(buffer, double(n_fans) / N_ORIGINS, "/solve");
+    snprintf(buffer, sizeof(buffer), "%s_vertices", name);
+    Report(buffer, double(n_vertices) / N_ORIGINS, "/solve");
+
+    snprintf(name, sizeof(name), "arrival_h%d", height);
+    ReportLatencies(name, arrival_latencies);
+
+    snprintf(buffer, sizeof(buffer), "%s_reachable", name);
+    Report(buffer, 100. * n_reachable / (N_ORIGINS * N_ARRIVALS), "%");
+
+    snprintf(name, sizeof(name), "arrival_batch_h%d", height);
+    ReportLatencies(name, batch_latencies);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  RasterMap map;
+  GenerateSyntheticTerrain(map, GeoPoint(Angle::Degrees(7.7),
+                                         Angle::Degrees(51.4)));
+
+  GlideSettings settings;
+  settings.SetDefaults();
+  RoutePlannerConfig config;
+  config.SetDefaults();
+  config.mode = RoutePlannerConfig::Mode::TERRAIN;
+  config.reach_calc_mode = RoutePlannerConfig::ReachMode::TURNING;
+
+  const GlidePolar polar(1);
+  const SpeedVector wind(Angle::Degrees(240), 5);
+
+  TerrainRoute route;
+  route.UpdatePolar(settings, config, polar, polar, wind);
+  route.SetTerrain(&map);
+
+  BenchmarkSolve(map, route, config);
+  BenchmarkReach(map, route, config);
+
+  return EXIT_SUCCESS;
+}
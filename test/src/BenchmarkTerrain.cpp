@@ -0,0 +1,334 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * This program benchmarks the terrain library with the given map
+ * file.  Each result is printed on its own line as "NAME VALUE UNIT",
+ * to allow comparing the output of different versions with a
+ * script.
+ */
+
+#include "DeterministicRandom.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/HeightMatrix.hpp"
+#include "Terrain/Loader.hpp"
+#include "Terrain/Shading/Optimised.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Screen/Layout.hpp"
+#include "OS/Args.hpp"
+#include "IO/ZipArchive.hpp"
+#include "Operation/Operation.hpp"
+#include "Thread/ThreadPool.hpp"
+#include "Util/PrintException.hxx"
+
+#include <chrono>
+#include <vector>
+
+#include <stdio.h>
+#include <math.h>
+
+unsigned Layout::scale_1024 = 1024;
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * The radius around the map center where tiles are loaded and
+ * queries are made [m].
+ */
+static constexpr double RADIUS = 50000;
+
+static constexpr unsigned N_HEIGHT_QUERIES = 1 << 20;
+static constexpr unsigned N_INTERSECTION_QUERIES = 1 << 16;
+
+static double
+ToSeconds(Clock::duration d)
+{
+  return std::chrono::duration_cast<std::chrono::duration<double>>(d).count();
+}
+
+static double
+SecondsSince(Clock::time_point start)
+{
+  return ToSeconds(Clock::now() - start);
+}
+
+static void
+Report(const char *name, double value, const char *unit)
+{
+  printf("%s %.3f %s\n", name, value, unit);
+}
+
+static void
+BenchmarkHeights(const RasterMap &map)
+{
+  const GeoPoint center = map.GetMapCenter();
+
+  std::vector<GeoPoint> random_points(N_HEIGHT_QUERIES);
+  for (auto &p : random_points)
+    p = RandomLocation(center, RADIUS);
+
+  /* rows of adjacent points, like a map renderer or a cross section
+     would query */
+  std::vector<GeoPoint> sequential_points(N_HEIGHT_QUERIES);
+  constexpr unsigned N_COLUMNS = 1024;
+  const GeoPoint origin = RandomLocation(center, RADIUS);
+  const Angle step = Angle::Degrees(0.001);
+  for (unsigned i = 0; i < N_HEIGHT_QUERIES; ++i)
+    sequential_points[i] =
+      GeoPoint(origin.longitude + step * double(i % N_COLUMNS),
+               origin.latitude - step * double(i / N_COLUMNS));
+
+  std::vector<TerrainHeight> heights(N_HEIGHT_QUERIES);
+
+  /* prevent gcc from optimizing the loops away */
+  long sum = 0;
+
+  auto start = Clock::now();
+  for (const auto &p : random_points)
+    sum += map.GetHeight(p).GetValue();
+  Report("get_height_random",
+         N_HEIGHT_QUERIES / SecondsSince(start) / 1e6, "M/s");
+
+  start = Clock::now();
+  for (const auto &p : sequential_points)
+    sum += map.GetHeight(p).GetValue();
+  Report("get_height_sequential",
+         N_HEIGHT_QUERIES / SecondsSince(start) / 1e6, "M/s");
+
+  start = Clock::now();
+  for (const auto &p : random_points)
+    sum += map.GetInterpolatedHeight(p).GetValue();
+  Report("get_interpolated_height_random",
+         N_HEIGHT_QUERIES / SecondsSince(start) / 1e6, "M/s");
+
+  start = Clock::now();
+  map.GetHeights(random_points.data(), heights.data(), N_HEIGHT_QUERIES);
+  Report("get_heights_random",
+         N_HEIGHT_QUERIES / SecondsSince(start) / 1e6, "M/s");
+
+  start = Clock::now();
+  map.GetHeights(sequential_points.data(), heights.data(),
+                 N_HEIGHT_QUERIES);
+  Report("get_heights_sequential",
+         N_HEIGHT_QUERIES / SecondsSince(start) / 1e6, "M/s");
+
+  for (const auto h : heights)
+    sum += h.GetValue();
+
+  if (sum == 42)
+    printf("\n");
+}
+
+static void
+BenchmarkIntersections(const RasterMap &map)
+{
+  const GeoPoint center = map.GetMapCenter();
+
+  struct Query {
+    GeoPoint origin, destination;
+    int h_origin;
+  };
+
+  std::vector<Query> queries(N_INTERSECTION_QUERIES);
+  for (auto &q : queries) {
+    q.origin = RandomLocation(center, RADIUS);
+    q.destination = RandomLocation(center, RADIUS);
+    q.h_origin = map.GetHeight(q.origin).GetValueOr0() +
+      int(200 + 1500 * Random());
+  }
+
+  unsigned n_found = 0;
+
+  auto start = Clock::now();
+  for (const auto &q : queries) {
+    /* glide ratio 1:40 towards the destination */
+    const int h_destination =
+      q.h_origin - int(q.origin.DistanceS(q.destination) / 40);
+
+    GeoPoint intersection;
+    int h;
+    if (map.FirstIntersection(q.origin, q.h_origin,
+                              q.destination, h_destination,
+                              q.h_origin, q.h_origin + 1000, 100,
+                              intersection, h))
+      ++n_found;
+  }
+  Report("first_intersection",
+         N_INTERSECTION_QUERIES / SecondsSince(start) / 1e3, "k/s");
+
+  start = Clock::now();
+  for (const auto &q : queries) {
+    const GeoPoint intersection =
+      map.Intersection(q.origin, q.h_origin, q.h_origin,
+                       q.destination, 0);
+    if (intersection.IsValid())
+      ++n_found;
+  }
+  Report("intersection",
+         N_INTERSECTION_QUERIES / SecondsSince(start) / 1e3, "k/s");
+
+  if (n_found == 42)
+    printf("\n");
+}
+
+/**
+ * Apply the terrain shading kernels to the whole matrix, like
+ * RasterRenderer::GenerateSlopeImage() does.
+ */
+static void
+Shade(const HeightMatrix &matrix)
+{
+  const unsigned width = matrix.GetWidth(), height = matrix.GetHeight();
+  if (width < 3 || height < 3)
+    return;
+
+  std::vector<uint8_t> index_row(width), contour_row(width);
+  std::vector<int8_t> shade_row(width);
+
+  TerrainShadingParameters params;
+  params.sx = 128;
+  params.sy = -128;
+  params.sz = 181;
+  params.contrast = 160;
+  params.height_slope_factor = 64;
+  params.p20 = 2;
+  params.p31 = 2;
+
+  const TerrainHeight *src = matrix.GetData();
+  for (unsigned y = 1; y < height - 1; ++y) {
+    const TerrainHeight *row = src + y * width;
+
+    OptimisedTerrainShading::HeightRow(index_row.data(),
+                                       contour_row.data(),
+                                       row, width, 64, 4);
+    OptimisedTerrainShading::SlopeRow(shade_row.data() + 1,
+                                      row + 1 - width, row + 1 + width,
+                                      row, row + 2,
+                                      width - 2, params);
+  }
+}
+
+static void
+BenchmarkHeightMatrix(const RasterMap &map, double radius)
+{
+  constexpr unsigned ITERATIONS = 8;
+
+  WindowProjection projection;
+  projection.SetScreenSize({640, 480});
+  projection.SetScaleFromRadius(radius);
+  projection.SetGeoLocation(map.GetMapCenter());
+  projection.SetScreenOrigin(320, 240);
+  projection.UpdateScreenBounds();
+
+  Clock::duration fill_time = Clock::duration::zero();
+  Clock::duration shade_time = Clock::duration::zero();
+
+  for (unsigned i = 0; i < ITERATIONS; ++i) {
+    /* a new object each time, to measure a full fill */
+    HeightMatrix matrix;
+
+    auto start = Clock::now();
+#ifdef ENABLE_OPENGL
+    matrix.Fill(map, projection.GetScreenBounds(),
+                projection.GetScreenWidth() / 2,
+                projection.GetScreenHeight() / 2,
+                false);
+#else
+    matrix.Fill(map, projection, 2, false);
+#endif
+    fill_time += Clock::now() - start;
+
+    start = Clock::now();
+    Shade(matrix);
+    shade_time += Clock::now() - start;
+  }
+
+  char name[64];
+  snprintf(name, sizeof(name), "height_matrix_fill_%ukm",
+           unsigned(radius / 1000));
+  Report(name, ToSeconds(fill_time) * 1000 / ITERATIONS, "ms");
+
+  snprintf(name, sizeof(name), "shading_%ukm", unsigned(radius / 1000));
+  Report(name, ToSeconds(shade_time) * 1000 / ITERATIONS, "ms");
+}
+
+int main(int argc, char **argv)
+try {
+  Args args(argc, argv, "PATH");
+  const auto map_path = args.ExpectNextPath();
+  args.ExpectEnd();
+
+  ZipArchive archive(map_path);
+
+  RasterMap map;
+  RasterTileCache &tile_cache = map.GetTileCache();
+
+  NullOperationEnvironment operation;
+
+  /* one pool for all updates, like RasterTerrain */
+  ThreadPool decode_pool("TerrainDecode", 0, 0, true);
+
+  auto start = Clock::now();
+  if (!LoadTerrainOverview(archive.get(), tile_cache, operation,
+                           &decode_pool)) {
+    fprintf(stderr, "failed to load map\n");
+    return EXIT_FAILURE;
+  }
+
+  Report("load_overview", SecondsSince(start), "s");
+
+  map.UpdateProjection();
+
+  SharedMutex mutex;
+  start = Clock::now();
+  do {
+    UpdateTerrainTiles(archive.get(), tile_cache, mutex,
+                       map.GetProjection(),
+                       map.GetMapCenter(), RADIUS, &decode_pool);
+  } while (map.IsDirty());
+
+  Report("load_tiles", SecondsSince(start), "s");
+
+  const auto stats = tile_cache.GetStatistics();
+  Report("tiles", stats.resident_tiles, "tiles");
+  Report("tile_bytes", stats.resident_bytes / 1e6, "MB");
+  Report("pyramid_bytes", stats.pyramid_bytes / 1e6, "MB");
+
+  const double decode_time = ToSeconds(stats.decode_time);
+  if (decode_time > 0)
+    Report("decode_throughput",
+           stats.resident_bytes / sizeof(TerrainHeight) / decode_time / 1e6,
+           "Mpixel/s");
+
+  BenchmarkHeights(map);
+  BenchmarkIntersections(map);
+
+  static constexpr double radii[] = { 5000, 20000, 50000, 150000 };
+  for (const double radius : radii)
+    BenchmarkHeightMatrix(map, radius);
+
+  return EXIT_SUCCESS;
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
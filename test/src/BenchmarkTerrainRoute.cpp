@@ -0,0 +1,181 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * This program benchmarks the terrain route solver with the given map
+ * file, with the same routes as test_troute.  It reports the time
+ * and the number of heap allocations per solve as "NAME VALUE UNIT"
+ * lines, to allow comparing different versions of the route engine.
+ */
+
+#include "Route/TerrainRoute.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/Loader.hpp"
+#include "GlideSolvers/GlideSettings.hpp"
+#include "GlideSolvers/GlidePolar.hpp"
+#include "Geo/SpeedVector.hpp"
+#include "Geo/GeoVector.hpp"
+#include "OS/Args.hpp"
+#include "IO/ZipArchive.hpp"
+#include "Operation/Operation.hpp"
+#include "Util/PrintException.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <new>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+typedef std::chrono::steady_clock Clock;
+
+static unsigned long n_allocations, n_allocated_bytes;
+
+void *
+operator new(std::size_t size)
+{
+  ++n_allocations;
+  n_allocated_bytes += size;
+
+  void *p = malloc(size);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+
+void
+operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void
+operator delete(void *p, std::size_t) noexcept
+{
+  free(p);
+}
+
+static constexpr unsigned ITERATIONS = 20;
+
+static void
+Report(const char *name, double value, const char *unit)
+{
+  printf("%s %.3f %s\n", name, value, unit);
+}
+
+static void
+BenchmarkRoute(const RasterMap &map, const char *name,
+               double wind_speed, double mc)
+{
+  GlideSettings settings;
+  settings.SetDefaults();
+  RoutePlannerConfig config;
+  config.SetDefaults();
+  config.mode = RoutePlannerConfig::Mode::BOTH;
+
+  const GlidePolar polar(mc);
+  const SpeedVector wind(Angle::Degrees(0), wind_speed);
+  TerrainRoute route;
+  route.UpdatePolar(settings, config, polar, polar, wind);
+  route.SetTerrain(&map);
+
+  const GeoPoint origin = map.GetMapCenter();
+  const AGeoPoint start(origin, map.GetHeight(origin).GetValueOr0() + 100);
+
+  Clock::duration time = Clock::duration::zero();
+  unsigned n_solves = 0;
+  const unsigned long allocations_before = n_allocations;
+  const unsigned long bytes_before = n_allocated_bytes;
+
+  for (unsigned i = 0; i < ITERATIONS; ++i) {
+    for (double angle = 0; angle < M_2PI; angle += M_PI / 8) {
+      const GeoPoint destination =
+        GeoVector(40000, Angle::Radians(angle)).EndPoint(origin);
+      const int h_destination =
+        map.GetHeight(destination).GetValueOr0() + 100;
+      const AGeoPoint adestination(destination,
+                                   mc > 0
+                                   ? h_destination
+                                   : std::max(h_destination, 3200));
+
+      /* discard the previous solution, or Solve() would return
+         early */
+      route.Reset();
+
+      const auto start_time = Clock::now();
+      route.Solve(start, adestination, config, 10000);
+      time += Clock::now() - start_time;
+      ++n_solves;
+    }
+  }
+
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "solve_%s", name);
+  Report(buffer,
+         std::chrono::duration_cast<std::chrono::duration<double>>(time).count()
+         * 1000 / n_solves, "ms");
+
+  snprintf(buffer, sizeof(buffer), "allocations_%s", name);
+  Report(buffer, double(n_allocations - allocations_before) / n_solves,
+         "/solve");
+
+  snprintf(buffer, sizeof(buffer), "allocated_bytes_%s", name);
+  Report(buffer, double(n_allocated_bytes - bytes_before) / n_solves / 1024,
+         "kB/solve");
+}
+
+int main(int argc, char **argv)
+try {
+  Args args(argc, argv, "PATH");
+  const auto map_path = args.ExpectNextPath();
+  args.ExpectEnd();
+
+  ZipArchive archive(map_path);
+
+  RasterMap map;
+
+  NullOperationEnvironment operation;
+  if (!LoadTerrainOverview(archive.get(), map.GetTileCache(), operation)) {
+    fprintf(stderr, "failed to load map\n");
+    return EXIT_FAILURE;
+  }
+
+  map.UpdateProjection();
+
+  SharedMutex mutex;
+  do {
+    UpdateTerrainTiles(archive.get(), map.GetTileCache(), mutex,
+                       map.GetProjection(),
+                       map.GetMapCenter(), 100000);
+  } while (map.IsDirty());
+
+  BenchmarkRoute(map, "mc0.1", 0, 0.1);
+  BenchmarkRoute(map, "mc0", 0, 0);
+  BenchmarkRoute(map, "wind5_mc1", 5, 1);
+
+  return EXIT_SUCCESS;
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
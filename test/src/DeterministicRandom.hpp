@@ -0,0 +1,64 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TEST_DETERMINISTIC_RANDOM_HPP
+#define XCSOAR_TEST_DETERMINISTIC_RANDOM_HPP
+
+struct GeoPoint;
+
+/**
+ * A simple deterministic pseudo random number generator, so all runs
+ * of a test or benchmark see the same data.  There is one state for
+ * the whole program.
+ *
+ * All tests and benchmarks which need reproducible random data use
+ * this generator; don't add another private copy.
+ */
+
+/**
+ * Restart the sequence, e.g. to repeat the same locations with
+ * different parameters.
+ */
+void
+SeedRandom(unsigned seed=1);
+
+/**
+ * Returns a random number in the range [0, n).
+ */
+unsigned
+RandomInt(unsigned n);
+
+/**
+ * Returns a random number in the range [0, 1).
+ */
+double
+Random();
+
+/**
+ * Returns a random location within the given distance [m] of the
+ * center.
+ */
+GeoPoint
+RandomLocation(const GeoPoint &center, double radius);
+
+#endif
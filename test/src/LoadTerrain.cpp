@@ -66,6 +66,15 @@ try {
                        rtc.GetWidth() / 2, rtc.GetHeight() / 2, 1000);
   } while (rtc.IsDirty());
 
+  const auto stats = rtc.GetStatistics();
+  printf("tiles: %u resident, %zu + %zu (pyramid) of %zu bytes\n",
+         stats.resident_tiles, stats.resident_bytes, stats.pyramid_bytes,
+         stats.budget);
+  printf("hits: %u, misses: %u, evictions: %u\n",
+         stats.hits, stats.misses, stats.evictions);
+  printf("decode time: %.3f s\n",
+         std::chrono::duration_cast<std::chrono::duration<double>>(stats.decode_time).count());
+
   return EXIT_SUCCESS;
 } catch (const std::runtime_error &e) {
   PrintException(e);
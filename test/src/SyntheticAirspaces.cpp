@@ -0,0 +1,83 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "SyntheticAirspaces.hpp"
+#include "DeterministicRandom.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Util/Macros.hpp"
+
+/**
+ * The minimum radius of each airspace [m].
+ */
+static constexpr double MIN_SIZE = 2000;
+
+static AirspaceAltitude
+MakeAltitude(double altitude)
+{
+  AirspaceAltitude result;
+  result.altitude = altitude;
+  result.reference = AltitudeReference::MSL;
+  return result;
+}
+
+std::vector<const AbstractAirspace *>
+GenerateSyntheticAirspaces(Airspaces &airspaces, const GeoPoint &center,
+                           unsigned n, double radius, double max_size)
+{
+  static constexpr AirspaceClass classes[] = {
+    CLASSC, CLASSD, CTR, RESTRICT, DANGER, TMZ,
+  };
+
+  std::vector<const AbstractAirspace *> result;
+  result.reserve(n);
+
+  for (unsigned i = 0; i < n; ++i) {
+    const GeoPoint location = RandomLocation(center, radius);
+    const double size = MIN_SIZE + (max_size - MIN_SIZE) * Random();
+
+    AbstractAirspace *airspace;
+    if (i % 3 != 0) {
+      airspace = new AirspaceCircle(location, size);
+    } else {
+      std::vector<GeoPoint> points;
+      const unsigned n_points = 8 + RandomInt(24);
+      for (unsigned j = 0; j < n_points; ++j)
+        points.push_back(GeoVector(size * (0.5 + 0.5 * Random()),
+                                   Angle::FullCircle() * j / n_points)
+                         .EndPoint(location));
+      airspace = new AirspacePolygon(points);
+    }
+
+    const double base = 2500 * Random();
+    airspace->SetProperties(_T("synthetic"), classes[i % ARRAY_SIZE(classes)],
+                            MakeAltitude(base),
+                            MakeAltitude(base + 500 + 2500 * Random()));
+    airspaces.Add(airspace);
+    result.push_back(airspace);
+  }
+
+  return result;
+}
@@ -0,0 +1,50 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TEST_SYNTHETIC_AIRSPACES_HPP
+#define XCSOAR_TEST_SYNTHETIC_AIRSPACES_HPP
+
+#include <vector>
+
+class Airspaces;
+class AbstractAirspace;
+struct GeoPoint;
+
+/**
+ * Generate overlapping circles and star-shaped polygons with random
+ * sizes and altitudes, and add them to the #Airspaces object, to
+ * allow testing and benchmarking airspace code without an airspace
+ * file.  Optimise() is not called.  The result is deterministic, see
+ * SeedRandom().
+ *
+ * @param radius the maximum distance of each airspace's center from
+ * #center [m]
+ * @param max_size the maximum radius of each airspace [m]
+ * @return all new airspaces, in insertion order
+ */
+std::vector<const AbstractAirspace *>
+GenerateSyntheticAirspaces(Airspaces &airspaces, const GeoPoint &center,
+                           unsigned n, double radius,
+                           double max_size=10000);
+
+#endif
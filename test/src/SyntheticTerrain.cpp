@@ -0,0 +1,128 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "SyntheticTerrain.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Geo/GeoPoint.hpp"
+
+extern "C" {
+#include "jasper/jas_seq.h"
+}
+
+#include <vector>
+#include <algorithm>
+
+#include <math.h>
+
+static constexpr unsigned TILE_SIZE = 256;
+
+/**
+ * The size of one pixel [degrees].
+ */
+static constexpr double PIXEL_SIZE = 1. / 1200;
+
+/**
+ * The height of the flat valley floors [m].
+ */
+static constexpr int VALLEY_HEIGHT = 300;
+
+/**
+ * The height of the plateaus [m].  The highest ridges are cut off
+ * here.
+ */
+static constexpr int PLATEAU_HEIGHT = 2400;
+
+/**
+ * Returns the terrain height at the specified pixel: overlapping
+ * ridges of different wave lengths, with flat valleys and plateaus.
+ */
+static int
+SyntheticHeight(unsigned x, unsigned y)
+{
+  const double h = 1200
+    + 900 * sin(x / 37.) * sin(y / 53.)
+    + 500 * sin((x + 2. * y) / 91.)
+    + 200 * cos(x / 13. - y / 17.);
+  if (h < VALLEY_HEIGHT)
+    return VALLEY_HEIGHT;
+  if (h > PLATEAU_HEIGHT)
+    return PLATEAU_HEIGHT;
+  return int(h);
+}
+
+static jas_matrix_t *
+CreateTile(unsigned start_x, unsigned start_y,
+           unsigned width, unsigned height)
+{
+  jas_matrix_t *m = jas_matrix_create(height, width);
+  for (unsigned y = 0; y < height; ++y)
+    for (unsigned x = 0; x < width; ++x)
+      jas_matrix_set(m, y, x, SyntheticHeight(start_x + x, start_y + y));
+  return m;
+}
+
+void
+GenerateSyntheticTerrain(RasterMap &map, const GeoPoint &center,
+                         unsigned size)
+{
+  RasterTileCache &cache = map.GetTileCache();
+  cache.Reset();
+
+  const unsigned n_tiles = (size + TILE_SIZE - 1) / TILE_SIZE;
+  cache.SetSize(size, size, TILE_SIZE, TILE_SIZE, n_tiles, n_tiles);
+
+  const double half = size * PIXEL_SIZE / 2;
+  cache.SetLatLonBounds(center.longitude.Degrees() - half,
+                        center.longitude.Degrees() + half,
+                        center.latitude.Degrees() + half,
+                        center.latitude.Degrees() - half);
+
+  std::vector<jas_matrix_t *> tiles;
+  for (unsigned row = 0; row < n_tiles; ++row) {
+    for (unsigned column = 0; column < n_tiles; ++column) {
+      const unsigned start_x = column * TILE_SIZE;
+      const unsigned start_y = row * TILE_SIZE;
+      const unsigned end_x = std::min(start_x + TILE_SIZE, size);
+      const unsigned end_y = std::min(start_y + TILE_SIZE, size);
+
+      jas_matrix_t *m = CreateTile(start_x, start_y,
+                                   end_x - start_x, end_y - start_y);
+      cache.PutOverviewTile(tiles.size(), start_x, start_y, end_x, end_y,
+                            *m);
+      tiles.push_back(m);
+    }
+  }
+
+  map.UpdateProjection();
+
+  /* load all tiles, like TerrainLoader::UpdateTiles() does */
+  while (cache.PollTiles(size / 2, size / 2, size)) {
+    for (unsigned i = 0; i < tiles.size(); ++i)
+      cache.PutTileData(i, *tiles[i]);
+
+    cache.FinishTileUpdate();
+  }
+
+  for (auto *m : tiles)
+    jas_matrix_destroy(m);
+}
@@ -0,0 +1,44 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TEST_SYNTHETIC_TERRAIN_HPP
+#define XCSOAR_TEST_SYNTHETIC_TERRAIN_HPP
+
+class RasterMap;
+struct GeoPoint;
+
+/**
+ * Fill the #RasterMap with generated mountainous terrain (ridges,
+ * flat valleys and plateaus), to allow testing and benchmarking
+ * terrain code without a map file.  The result is deterministic, and
+ * all tiles are loaded.
+ *
+ * @param center the center of the map
+ * @param size the width and height of the map [pixels]; the pixels
+ * are 3 arc seconds wide, like in the XCSoar map files
+ */
+void
+GenerateSyntheticTerrain(RasterMap &map, const GeoPoint &center,
+                         unsigned size=2048);
+
+#endif
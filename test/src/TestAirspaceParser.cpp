@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Engine/Airspace/AbstractAirspace.hpp"
 #include "Engine/Airspace/AirspaceCircle.hpp"
 #include "Engine/Airspace/AirspacePolygon.hpp"
@@ -34,7 +35,10 @@ Copyright_License {
 #include "Operation/Operation.hpp"
 #include "TestUtil.hpp"
 
+#include <vector>
+
 #include <tchar.h>
+#include <stdio.h>
 
 struct AirspaceClassTestCouple
 {
@@ -273,12 +277,97 @@ TestTNP()
   }
 }
 
+static bool
+Equals(const AirspaceAltitude &a, const AirspaceAltitude &b)
+{
+  return a.reference == b.reference && a.altitude == b.altitude &&
+    a.flight_level == b.flight_level &&
+    a.altitude_above_terrain == b.altitude_above_terrain;
+}
+
+static bool
+Equals(const AbstractAirspace &a, const AbstractAirspace &b)
+{
+  if (a.GetShape() != b.GetShape() || a.GetType() != b.GetType() ||
+      !StringIsEqual(a.GetName(), b.GetName()) ||
+      a.GetRadioText() != b.GetRadioText() ||
+      !a.GetDays().equals(b.GetDays()) ||
+      !Equals(a.GetBase(), b.GetBase()) || !Equals(a.GetTop(), b.GetTop()))
+    return false;
+
+  if (a.GetShape() == AbstractAirspace::Shape::CIRCLE) {
+    const AirspaceCircle &ca = (const AirspaceCircle &)a;
+    const AirspaceCircle &cb = (const AirspaceCircle &)b;
+    return ca.GetRadius() == cb.GetRadius() &&
+      ca.GetReferenceLocation() == cb.GetReferenceLocation();
+  }
+
+  const SearchPointVector &pa = a.GetPoints(), &pb = b.GetPoints();
+  if (pa.size() != pb.size())
+    return false;
+
+  for (unsigned i = 0; i < pa.size(); ++i)
+    if (pa[i].GetLocation() != pb[i].GetLocation())
+      return false;
+
+  return true;
+}
+
+/**
+ * Write the parsed airspaces to a cache file, load them again and
+ * compare the result.
+ */
+static void
+TestCache(Path path)
+{
+  Airspaces parsed;
+  {
+    FileLineReader reader(path, Charset::AUTO);
+    AirspaceParser parser(parsed);
+    NullOperationEnvironment operation;
+    parser.Parse(reader, operation);
+  }
+
+  const auto &original = parsed.GetPending();
+
+  FILE *file = tmpfile();
+  ok1(SaveAirspaceCache(file, parsed, 0));
+  fflush(file);
+
+  const long size = ftell(file);
+  std::vector<char> data(size);
+  rewind(file);
+  fread(data.data(), size, 1, file);
+
+  rewind(file);
+  Airspaces loaded;
+  ok1(LoadAirspaceCache(file, loaded));
+  fclose(file);
+
+  const auto &result = loaded.GetPending();
+  ok1(result.size() == original.size());
+  for (unsigned i = 0; i < original.size() && i < result.size(); ++i)
+    ok1(Equals(*original[i], *result[i]));
+
+  /* a truncated file must be rejected without adding anything */
+  file = tmpfile();
+  fwrite(data.data(), size - 1, 1, file);
+  fflush(file);
+  rewind(file);
+
+  Airspaces truncated;
+  ok1(!LoadAirspaceCache(file, truncated) && truncated.IsEmpty());
+  fclose(file);
+}
+
 int main(int argc, char **argv)
 try {
-  plan_tests(102);
+  plan_tests(102 + 2 * 28);
 
   TestOpenAir();
   TestTNP();
+  TestCache(Path(_T("test/data/airspace/openair.txt")));
+  TestCache(Path(_T("test/data/airspace/tnp.sua")));
 
   return exit_status();
 } catch (const std::runtime_error &e) {
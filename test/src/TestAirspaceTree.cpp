@@ -0,0 +1,149 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "SyntheticAirspaces.hpp"
+#include "DeterministicRandom.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceIntersectionVisitor.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Util/Macros.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <vector>
+
+static constexpr double RADIUS = 100000;
+
+typedef std::vector<const AbstractAirspace *> AirspaceList;
+
+template<typename R>
+static AirspaceList
+ToList(const R &range)
+{
+  AirspaceList list;
+  for (const auto &i : range)
+    list.push_back(&i.GetAirspace());
+
+  std::sort(list.begin(), list.end());
+  return list;
+}
+
+class CollectVisitor final : public AirspaceIntersectionVisitor {
+public:
+  AirspaceList list;
+
+  void Visit(const AbstractAirspace &as) override {
+    list.push_back(&as);
+  }
+};
+
+/**
+ * Compare the results of the tree queries with a linear search over
+ * all airspaces.
+ */
+static void
+TestQueries(unsigned n)
+{
+  const GeoPoint center(Angle::Degrees(10), Angle::Degrees(50));
+
+  Airspaces airspaces;
+  GenerateSyntheticAirspaces(airspaces, center, n, RADIUS);
+  airspaces.Optimise();
+
+  ok1(airspaces.GetSize() == n);
+
+  const auto all = ToList(airspaces.QueryAll());
+  ok1(all.size() == n &&
+      std::adjacent_find(all.begin(), all.end()) == all.end());
+
+  const FlatProjection &projection = airspaces.GetProjection();
+
+  bool range_ok = true, inside_ok = true, intersecting_ok = true;
+  unsigned n_found = 0;
+
+  for (unsigned i = 0; i < 200; ++i) {
+    const GeoPoint location = RandomLocation(center, RADIUS * 1.2);
+    const double range = 20000 * Random();
+
+    const FlatBoundingBox box = projection.ProjectSquare(location, range);
+    AirspaceList expected;
+    for (const auto &a : airspaces.QueryAll())
+      if (box.Overlaps(a))
+        expected.push_back(&a.GetAirspace());
+    std::sort(expected.begin(), expected.end());
+
+    if (ToList(airspaces.QueryWithinRange(location, range)) != expected)
+      range_ok = false;
+
+    expected.clear();
+    for (const auto &a : airspaces.QueryAll())
+      if (a.IsInside(location))
+        expected.push_back(&a.GetAirspace());
+    std::sort(expected.begin(), expected.end());
+
+    if (ToList(airspaces.QueryInside(location)) != expected)
+      inside_ok = false;
+
+    n_found += expected.size();
+
+    const GeoPoint end =
+      GeoVector(20000 * Random(), Angle::FullCircle() * Random())
+      .EndPoint(location);
+    expected.clear();
+    for (const auto &a : airspaces.QueryAll())
+      if (!a.Intersects(location, end, projection).empty())
+        expected.push_back(&a.GetAirspace());
+    std::sort(expected.begin(), expected.end());
+
+    CollectVisitor visitor;
+    airspaces.VisitIntersecting(location, end, visitor);
+    std::sort(visitor.list.begin(), visitor.list.end());
+    if (visitor.list != expected)
+      intersecting_ok = false;
+  }
+
+  ok1(range_ok);
+  ok1(inside_ok);
+  ok1(intersecting_ok);
+
+  /* make sure the queries were not trivial */
+  ok1(n < 100 || n_found > 0);
+}
+
+int main(int argc, char **argv)
+{
+  static constexpr unsigned sizes[] = { 1, 15, 16, 17, 300, 5000 };
+
+  plan_tests(6 * ARRAY_SIZE(sizes) + 1);
+
+  Airspaces empty;
+  empty.Optimise();
+  ok1(empty.QueryAll().empty() &&
+      empty.QueryWithinRange(GeoPoint(Angle::Degrees(10),
+                                      Angle::Degrees(50)), 1000).empty());
+
+  for (const unsigned n : sizes)
+    TestQueries(n);
+
+  return exit_status();
+}
@@ -0,0 +1,237 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Pan a #HeightMatrix by whole cells, and compare the shifted buffer
+ * with the previous one and with one filled from scratch.
+ *
+ * RasterMap::ScanLine() places the samples of a line relative to its
+ * start, and splits the line at tile boundaries, so a location may be
+ * sampled from a neighbouring map pixel when it is scanned as part of
+ * a different line.  Only the samples which are kept, the new rows and
+ * the fallback to a full fill can therefore be compared exactly; the
+ * new columns are compared with the terrain's own variation between
+ * adjacent columns.
+ */
+
+#include "SyntheticTerrain.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/HeightMatrix.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Util/Macros.hpp"
+
+extern "C" {
+#include "tap.h"
+}
+
+#include <vector>
+
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr unsigned SCREEN_WIDTH = 320, SCREEN_HEIGHT = 240;
+static constexpr unsigned QUANTISATION = 2;
+
+/* the matrix size and the size of one cell in pixels */
+static constexpr int WIDTH = SCREEN_WIDTH / QUANTISATION;
+static constexpr int HEIGHT = SCREEN_HEIGHT / QUANTISATION;
+static constexpr int CELL = QUANTISATION;
+
+static bool
+SameHeight(TerrainHeight a, TerrainHeight b)
+{
+  return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static int
+Difference(TerrainHeight a, TerrainHeight b)
+{
+  return abs(a.GetValueOr0() - b.GetValueOr0());
+}
+
+static bool
+SameMatrix(const HeightMatrix &a, const HeightMatrix &b)
+{
+  return a.GetWidth() == b.GetWidth() && a.GetHeight() == b.GetHeight() &&
+    memcmp(a.GetData(), b.GetData(),
+           a.GetWidth() * a.GetHeight() * sizeof(*a.GetData())) == 0;
+}
+
+/**
+ * Was the cell (x, y) of the panned matrix visible before?
+ */
+static bool
+WasVisible(int x, int y, int dx, int dy)
+{
+  return x + dx >= 0 && x + dx < WIDTH && y + dy >= 0 && y + dy < HEIGHT;
+}
+
+/**
+ * Are the samples which were visible before still there, exactly?
+ */
+static bool
+KeepsSamples(const std::vector<TerrainHeight> &old,
+             const HeightMatrix &shifted, int dx, int dy)
+{
+  for (int y = 0; y < HEIGHT; ++y)
+    for (int x = 0; x < WIDTH; ++x)
+      if (WasVisible(x, y, dx, dy) &&
+          !SameHeight(shifted.GetRow(y)[x], old[(y + dy) * WIDTH + x + dx]))
+        return false;
+
+  return true;
+}
+
+/**
+ * Are the newly exposed rows exactly the same as in a full fill?
+ */
+static bool
+SameNewRows(const HeightMatrix &shifted, const HeightMatrix &full, int dy)
+{
+  for (int y = 0; y < HEIGHT; ++y)
+    if ((y + dy < 0 || y + dy >= HEIGHT) &&
+        memcmp(shifted.GetRow(y), full.GetRow(y),
+               WIDTH * sizeof(*shifted.GetRow(y))) != 0)
+      return false;
+
+  return true;
+}
+
+/**
+ * Do the newly exposed cells of the shifted matrix differ from a full
+ * fill less than adjacent columns of the full fill differ from each
+ * other, on average?
+ */
+static bool
+SimilarNewCells(const HeightMatrix &shifted, const HeightMatrix &full,
+                int dx, int dy)
+{
+  unsigned long error = 0, variation = 0;
+  unsigned n_error = 0, n_variation = 0;
+
+  for (int y = 0; y < HEIGHT; ++y) {
+    for (int x = 0; x < WIDTH; ++x) {
+      if (!WasVisible(x, y, dx, dy)) {
+        error += Difference(shifted.GetRow(y)[x], full.GetRow(y)[x]);
+        ++n_error;
+      }
+
+      if (x > 0) {
+        variation += Difference(full.GetRow(y)[x], full.GetRow(y)[x - 1]);
+        ++n_variation;
+      }
+    }
+  }
+
+  return n_error > 0 &&
+    (double)error / n_error < (double)variation / n_variation;
+}
+
+/**
+ * Pan by the specified number of pixels.  Moving the screen origin
+ * keeps the reference location, so a pan by whole cells moves the
+ * grid exactly by whole cells.
+ */
+static void
+Pan(WindowProjection &projection, int dx, int dy)
+{
+  PixelPoint origin = projection.GetScreenOrigin();
+  origin.x -= dx;
+  origin.y -= dy;
+  projection.SetScreenOrigin(origin);
+  projection.UpdateScreenBounds();
+}
+
+int main(int argc, char **argv)
+{
+  /* pan offsets in cells; each one is relative to the previous
+     one */
+  static constexpr int offsets[][2] = {
+    { 3, 0 }, { -5, 0 }, { 0, 4 }, { 0, -7 },
+    { 1, 1 }, { 6, -2 }, { -4, 5 }, { -1, -1 },
+    { WIDTH - 1, 0 }, { 0, 1 - HEIGHT },
+  };
+
+  /* these are larger than the matrix, or not a whole number of
+     cells; they must fall back to a full fill */
+  static constexpr int other_offsets[][2] = {
+    { 200 * CELL, 0 }, { -200 * CELL, 0 }, { 0, 150 * CELL },
+    { -170 * CELL, -130 * CELL },
+    { CELL / 2, 0 }, { 0, -CELL / 2 },
+  };
+
+  plan_tests(1 + ARRAY_SIZE(offsets) * 3 + ARRAY_SIZE(other_offsets));
+
+  const GeoPoint center(Angle::Degrees(7.7), Angle::Degrees(51.4));
+
+  RasterMap map;
+  GenerateSyntheticTerrain(map, center);
+
+  WindowProjection projection;
+  projection.SetScreenSize({SCREEN_WIDTH, SCREEN_HEIGHT});
+  projection.SetScaleFromRadius(20000);
+  projection.SetGeoLocation(center);
+  projection.SetScreenOrigin(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+  projection.UpdateScreenBounds();
+
+  HeightMatrix shifted;
+  shifted.Fill(map, projection, QUANTISATION, false);
+
+  {
+    HeightMatrix full;
+    full.Fill(map, projection, QUANTISATION, false);
+    ok(SameMatrix(shifted, full) &&
+       shifted.GetWidth() == WIDTH && shifted.GetHeight() == HEIGHT,
+       "initial fill");
+  }
+
+  for (const auto &offset : offsets) {
+    const int dx = offset[0], dy = offset[1];
+
+    const std::vector<TerrainHeight> old(shifted.GetData(),
+                                         shifted.GetDataEnd());
+
+    Pan(projection, dx * CELL, dy * CELL);
+    shifted.Fill(map, projection, QUANTISATION, false);
+
+    HeightMatrix full;
+    full.Fill(map, projection, QUANTISATION, false);
+
+    ok(KeepsSamples(old, shifted, dx, dy), "pan %d,%d keeps samples", dx, dy);
+    ok(SameNewRows(shifted, full, dy), "pan %d,%d new rows", dx, dy);
+    ok(SimilarNewCells(shifted, full, dx, dy),
+       "pan %d,%d new cells", dx, dy);
+  }
+
+  for (const auto &offset : other_offsets) {
+    Pan(projection, offset[0], offset[1]);
+    shifted.Fill(map, projection, QUANTISATION, false);
+
+    HeightMatrix full;
+    full.Fill(map, projection, QUANTISATION, false);
+
+    ok(SameMatrix(shifted, full), "pan by %d,%d pixels", offset[0], offset[1]);
+  }
+
+  return exit_status();
+}
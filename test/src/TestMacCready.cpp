@@ -128,6 +128,47 @@ TestWind(const SpeedVector &wind)
   Test(100000, 4000, wind);
 }
 
+/**
+ * Compare the batch version of MacCready::SolveStraight() with the
+ * single one.
+ */
+static void
+TestStraightBatch(const SpeedVector &wind)
+{
+  constexpr unsigned N = 13 * 4;
+
+  GeoVector vectors[N];
+  double min_arrival_altitudes[N];
+  for (unsigned i = 0; i < N; ++i) {
+    static constexpr double distances[] = { 0, 1000, 20000, 150000 };
+    vectors[i] = GeoVector(distances[i % 4], Angle::Degrees(i / 4 * 30.));
+    min_arrival_altitudes[i] = 500 + 100 * (i % 7);
+  }
+
+  const double altitude = 1200;
+
+  double altitude_differences[N];
+  bool valid[N];
+  const MacCready mac_cready(glide_settings, glide_polar);
+  mac_cready.SolveStraight(vectors, min_arrival_altitudes, N, altitude, wind,
+                           altitude_differences, valid);
+
+  bool same = true;
+  for (unsigned i = 0; i < N; ++i) {
+    const GlideState state(vectors[i], min_arrival_altitudes[i],
+                           altitude, wind);
+    const GlideResult result = mac_cready.SolveStraight(state);
+
+    if (valid[i] != result.IsOk() ||
+        (valid[i] &&
+         fabs(altitude_differences[i] -
+              result.pure_glide_altitude_difference) > 0.001))
+      same = false;
+  }
+
+  ok(same, "straight batch");
+}
+
 static void
 TestAll()
 {
@@ -137,11 +178,16 @@ TestAll()
   TestWind(SpeedVector(Angle::Zero(), 10));
   TestWind(SpeedVector(Angle::Zero(), 15));
   TestWind(SpeedVector(Angle::Zero(), 30));
+
+  TestStraightBatch(SpeedVector(Angle::Zero(), 0));
+  TestStraightBatch(SpeedVector(Angle::Degrees(70), 5));
+  TestStraightBatch(SpeedVector(Angle::Degrees(200), 15));
+  TestStraightBatch(SpeedVector(Angle::Degrees(300), 60));
 }
 
 int main(int argc, char **argv)
 {
-  plan_tests(2095);
+  plan_tests(2095 + 5 * 4);
 
   glide_settings.SetDefaults();
 
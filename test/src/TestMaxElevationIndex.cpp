@@ -0,0 +1,161 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compare the maximum elevations stored in a #MaxElevationIndex with
+ * a brute force search.
+ */
+
+#include "DeterministicRandom.hpp"
+#include "Terrain/MaxElevationIndex.hpp"
+#include "Terrain/RasterBuffer.hpp"
+#include "Util/Macros.hpp"
+
+extern "C" {
+#include "tap.h"
+}
+
+#include <algorithm>
+
+static void
+Fill(RasterBuffer &buffer)
+{
+  TerrainHeight *p = buffer.GetData();
+  for (unsigned i = 0, n = buffer.GetWidth() * buffer.GetHeight();
+       i < n; ++i) {
+    switch (RandomInt(512)) {
+    case 0:
+      p[i] = TerrainHeight::Invalid();
+      break;
+
+    case 1:
+      /* water */
+      p[i] = TerrainHeight(-31000);
+      break;
+
+    default:
+      p[i] = TerrainHeight(int(RandomInt(3000)) - 100);
+      break;
+    }
+  }
+}
+
+static int
+BruteForceMaximum(const RasterBuffer &buffer,
+                  unsigned x0, unsigned y0, unsigned x1, unsigned y1)
+{
+  x1 = std::min(x1, buffer.GetWidth());
+  y1 = std::min(y1, buffer.GetHeight());
+
+  int result = INT16_MIN;
+  for (unsigned y = y0; y < y1; ++y) {
+    for (unsigned x = x0; x < x1; ++x) {
+      const TerrainHeight h = buffer.Get(x, y);
+      result = std::max(result, h.IsInvalid()
+                        ? int(MaxElevationIndex::UNKNOWN)
+                        : int(h.GetValueOr0()));
+    }
+  }
+
+  return result;
+}
+
+static bool
+CheckLevel(const MaxElevationIndex &index, const RasterBuffer &buffer,
+           unsigned level)
+{
+  const unsigned bits = MaxElevationIndex::GetBlockBits(level);
+  const unsigned size = 1u << bits;
+
+  for (unsigned y0 = 0; y0 < buffer.GetHeight(); y0 += size) {
+    for (unsigned x0 = 0; x0 < buffer.GetWidth(); x0 += size) {
+      const int expected = BruteForceMaximum(buffer, x0, y0,
+                                             x0 + size, y0 + size);
+
+      /* every pixel of the block must map to the same value */
+      const unsigned x1 = std::min(x0 + size, buffer.GetWidth()) - 1;
+      const unsigned y1 = std::min(y0 + size, buffer.GetHeight()) - 1;
+      if (index.GetMaximum(level, x0, y0) != expected ||
+          index.GetMaximum(level, x1, y1) != expected)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+static void
+TestIndex(unsigned width, unsigned height)
+{
+  RasterBuffer buffer(width, height);
+  Fill(buffer);
+
+  MaxElevationIndex index;
+  index.Build(buffer);
+
+  for (unsigned level = 0; level < MaxElevationIndex::LEVELS; ++level)
+    ok(CheckLevel(index, buffer, level),
+       "level %u of %ux%u", level, width, height);
+
+  ok1(index.GetMaximum() ==
+      BruteForceMaximum(buffer, 0, 0, width, height));
+}
+
+static void
+TestFlat()
+{
+  RasterBuffer buffer(100, 70);
+  std::fill(buffer.GetData(), buffer.GetData() + 100 * 70,
+            TerrainHeight(500));
+  buffer.GetData()[33 * 100 + 77] = TerrainHeight(501);
+
+  MaxElevationIndex index;
+  index.Build(buffer);
+
+  ok1(index.GetMaximum() == 501);
+  ok1(index.GetMaximum(0, 77, 33) == 501);
+  ok1(index.GetMaximum(0, 76, 33) == 501);
+  ok1(index.GetMaximum(0, 70, 33) == 500);
+  ok1(index.GetMaximum(MaxElevationIndex::LEVELS - 1, 0, 0) == 501);
+}
+
+int main(int argc, char **argv)
+{
+  static constexpr unsigned sizes[][2] = {
+    { 1, 1 },
+    { 7, 3 },
+    { 8, 8 },
+    { 100, 70 },
+    { 256, 256 },
+    { 257, 130 },
+  };
+
+  plan_tests(ARRAY_SIZE(sizes) * (MaxElevationIndex::LEVELS + 1) + 5);
+
+  for (const auto &size : sizes)
+    TestIndex(size[0], size[1]);
+
+  TestFlat();
+
+  return exit_status();
+}
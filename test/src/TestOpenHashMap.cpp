@@ -0,0 +1,183 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Util/OpenHashMap.hpp"
+#include "TestUtil.hpp"
+
+/**
+ * A bad hash function which maps all keys to few slots, to test
+ * collision handling.
+ */
+struct BadHash {
+  size_t operator()(unsigned key) const {
+    return key % 3;
+  }
+};
+
+static void
+TestBasic()
+{
+  OpenHashMap<unsigned, int> map;
+  ok1(map.IsEmpty());
+  ok1(map.GetSize() == 0);
+  ok1(map.Find(42) == map.NOT_FOUND);
+
+  auto result = map.Insert(42, 1);
+  ok1(result.second);
+  ok1(result.first == 0);
+  ok1(!map.IsEmpty());
+  ok1(map.GetSize() == 1);
+
+  result = map.Insert(7, 2);
+  ok1(result.second);
+  ok1(result.first == 1);
+
+  ok1(map.Find(42) == 0);
+  ok1(map.Find(7) == 1);
+  ok1(map.Find(8) == map.NOT_FOUND);
+  ok1(map[0].key == 42 && map[0].value == 1);
+  ok1(map[1].key == 7 && map[1].value == 2);
+
+  /* a duplicate key is not inserted, and the old value is kept */
+  result = map.Insert(42, 3);
+  ok1(!result.second);
+  ok1(result.first == 0);
+  ok1(map.GetSize() == 2);
+  ok1(map[0].value == 1);
+
+  /* the value can be modified through the index */
+  map[result.first].value = 4;
+  ok1(map[map.Find(42)].value == 4);
+}
+
+template<typename Map>
+static bool
+CheckAll(const Map &map, unsigned n)
+{
+  if (map.GetSize() != n)
+    return false;
+
+  for (unsigned i = 0; i < n; ++i) {
+    const auto index = map.Find(i * 7);
+    if (index != i || map[index].value != int(i))
+      return false;
+  }
+
+  return map.Find(n * 7) == map.NOT_FOUND;
+}
+
+template<typename Map>
+static bool
+InsertAll(Map &map, unsigned n)
+{
+  for (unsigned i = 0; i < n; ++i) {
+    const auto result = map.Insert(i * 7, i);
+    if (!result.second || result.first != i)
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Insert far more items than the initial table size, so the table is
+ * rehashed several times; indices must remain valid.
+ */
+static void
+TestGrow()
+{
+  constexpr unsigned N = 10000;
+
+  OpenHashMap<unsigned, int> map;
+  ok1(InsertAll(map, N));
+  ok1(CheckAll(map, N));
+
+  /* duplicates after growing */
+  ok1(!map.Insert(0, -1).second);
+  ok1(!map.Insert((N - 1) * 7, -1).second);
+  ok1(map.GetSize() == N);
+
+  /* reserved memory */
+  OpenHashMap<unsigned, int> reserved(N);
+  ok1(InsertAll(reserved, N));
+  ok1(CheckAll(reserved, N));
+
+  /* many collisions */
+  OpenHashMap<unsigned, int, BadHash> bad;
+  ok1(InsertAll(bad, 500));
+  ok1(CheckAll(bad, 500));
+  ok1(!bad.Insert(7, -1).second);
+}
+
+static void
+TestClear()
+{
+  OpenHashMap<unsigned, int> map;
+  InsertAll(map, 1000);
+
+  map.Clear();
+  ok1(map.IsEmpty());
+  ok1(map.GetSize() == 0);
+  ok1(map.Find(0) == map.NOT_FOUND);
+  ok1(map.Find(7) == map.NOT_FOUND);
+
+  /* indices start at 0 again */
+  ok1(map.Insert(7, 1).first == 0);
+  ok1(map.Find(7) == 0);
+  ok1(map.Find(0) == map.NOT_FOUND);
+
+  map.Clear();
+  ok1(InsertAll(map, 1000));
+  ok1(CheckAll(map, 1000));
+}
+
+static void
+TestSet()
+{
+  OpenHashSet<unsigned> set;
+  ok1(set.GetSize() == 0);
+  ok1(!set.Contains(1));
+
+  ok1(set.Insert(1));
+  ok1(set.Insert(2));
+  ok1(!set.Insert(1));
+  ok1(set.GetSize() == 2);
+  ok1(set.Contains(1));
+  ok1(set.Contains(2));
+  ok1(!set.Contains(3));
+
+  set.Clear();
+  ok1(set.GetSize() == 0);
+  ok1(!set.Contains(1));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(19 + 10 + 9 + 11);
+
+  TestBasic();
+  TestGrow();
+  TestClear();
+  TestSet();
+
+  return exit_status();
+}
@@ -0,0 +1,152 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Geo/PackedPolygon.hpp"
+#include "Geo/SearchPointVector.hpp"
+#include "Geo/Flat/FlatProjection.hpp"
+#include "Geo/Flat/FlatRay.hpp"
+#include "Geo/GeoVector.hpp"
+#include "TestUtil.hpp"
+#include "DeterministicRandom.hpp"
+
+#include <vector>
+
+static constexpr unsigned N_QUERIES = 500;
+
+static const GeoPoint center(Angle::Degrees(7.7), Angle::Degrees(51.4));
+
+/**
+ * Generate a closed polygon.  A "star" polygon has its vertices
+ * sorted by angle, but a random radius, so it is usually not convex;
+ * otherwise, the vertices are random and the polygon intersects
+ * itself.
+ */
+static SearchPointVector
+MakePolygon(unsigned n, bool star, const FlatProjection &projection)
+{
+  SearchPointVector spv;
+  for (unsigned i = 0; i < n; ++i) {
+    const GeoPoint p = star
+      ? GeoVector(5000 + 15000 * Random(),
+                  Angle::FullCircle() * i / n).EndPoint(center)
+      : RandomLocation(center, 20000);
+    spv.emplace_back(p);
+  }
+
+  spv.emplace_back(spv.front().GetLocation());
+  spv.Project(projection);
+  return spv;
+}
+
+static std::vector<double>
+Intersections(const SearchPointVector &spv, const FlatRay &ray)
+{
+  std::vector<double> result;
+  for (auto it = spv.begin(); it + 1 != spv.end(); ++it) {
+    const FlatRay segment(it->GetFlatLocation(), (it + 1)->GetFlatLocation());
+    const double t = ray.DistinctIntersection(segment);
+    if (t >= 0)
+      result.push_back(t);
+  }
+
+  return result;
+}
+
+static std::vector<double>
+Intersections(const PackedPolygon &packed, const FlatRay &ray)
+{
+  std::vector<double> result;
+  packed.VisitIntersections(ray, [&result](double t){
+      result.push_back(t);
+    });
+  return result;
+}
+
+/**
+ * Compare the results of #PackedPolygon with those of
+ * #SearchPointVector for random queries.
+ */
+static void
+TestPolygon(unsigned n, bool star)
+{
+  const FlatProjection projection(center);
+  const SearchPointVector spv = MakePolygon(n, star, projection);
+
+  PackedPolygon packed;
+  packed.Update(spv);
+
+  bool inside_equal = true, nearest_equal = true, intersections_equal = true;
+  unsigned n_inside = 0, n_intersections = 0;
+
+  for (unsigned i = 0; i < N_QUERIES; ++i) {
+    const GeoPoint a = RandomLocation(center, 25000),
+      b = RandomLocation(center, 25000);
+
+    const bool inside = spv.IsInside(a);
+    inside_equal &= packed.IsInside(a) == inside;
+    n_inside += inside;
+
+    const FlatGeoPoint p = projection.ProjectInteger(a);
+    nearest_equal &= packed.NearestPoint(p) == spv.NearestPoint(p);
+
+    const FlatRay ray(p, projection.ProjectInteger(b));
+    const auto expected = Intersections(spv, ray);
+    intersections_equal &= Intersections(packed, ray) == expected;
+    n_intersections += expected.size();
+  }
+
+  ok1(inside_equal);
+  ok1(nearest_equal);
+  ok1(intersections_equal);
+
+  /* make sure the queries did not test trivial cases only */
+  ok1(n_inside > 0 && n_inside < N_QUERIES);
+  ok1(n_intersections > 0);
+}
+
+static void
+TestEmpty()
+{
+  PackedPolygon packed;
+  ok1(packed.IsEmpty());
+  ok1(!packed.IsInside(center));
+  ok1(packed.NearestPoint(FlatGeoPoint(3, 4)) == FlatGeoPoint(3, 4));
+  ok1(Intersections(packed, FlatRay(FlatGeoPoint(0, 0),
+                                    FlatGeoPoint(10, 10))).empty());
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(4 + 6 * 5);
+
+  TestEmpty();
+
+  TestPolygon(3, true);
+  TestPolygon(12, true);
+  TestPolygon(100, true);
+  TestPolygon(1000, true);
+  TestPolygon(10, false);
+  TestPolygon(200, false);
+
+  return exit_status();
+}
@@ -0,0 +1,355 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Verify that the reach calculated with a thread pool is identical to
+ * the one calculated serially, and that incremental updates are never
+ * more optimistic than a calculation from scratch.
+ */
+
+#include "SyntheticTerrain.hpp"
+#include "Route/TerrainRoute.hpp"
+#include "Engine/Route/ReachResult.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "GlideSolvers/GlideSettings.hpp"
+#include "GlideSolvers/GlidePolar.hpp"
+#include "Geo/SpeedVector.hpp"
+#include "Thread/ThreadPool.hpp"
+#include "Util/Macros.hpp"
+
+extern "C" {
+#include "tap.h"
+}
+
+#include <vector>
+
+#include <limits.h>
+#include <stdlib.h>
+
+class ThreadPoolExecutor final : public ReachFanExecutor {
+  ThreadPool pool;
+
+public:
+  ThreadPoolExecutor():pool("Reach", 4) {}
+
+  void ForEach(unsigned n,
+               const std::function<void(unsigned)> &f) override {
+    pool.ForEach(n, f);
+  }
+};
+
+/**
+ * Collects the vertices of all fans, in the order they are visited.
+ */
+class FanCollector final : public FlatTriangleFanVisitor {
+public:
+  std::vector<FlatGeoPoint> points;
+  unsigned n_fans = 0;
+
+  void VisitFan(FlatGeoPoint origin,
+                ConstBuffer<FlatGeoPoint> fan) override {
+    ++n_fans;
+    points.push_back(origin);
+    points.emplace_back(int(fan.size), 0);
+    points.insert(points.end(), fan.begin(), fan.end());
+  }
+};
+
+static bool
+operator==(const ReachResult &a, const ReachResult &b)
+{
+  return a.direct == b.direct && a.terrain == b.terrain &&
+    a.terrain_valid == b.terrain_valid;
+}
+
+static bool
+SameFans(const RasterMap &map,
+         const TerrainRoute &a, const TerrainRoute &b, bool working,
+         unsigned &n_fans)
+{
+  FanCollector fans_a, fans_b;
+  a.AcceptInRange(map.GetBounds(), fans_a, working);
+  b.AcceptInRange(map.GetBounds(), fans_b, working);
+
+  n_fans = fans_a.n_fans;
+  return fans_a.n_fans == fans_b.n_fans && fans_a.points == fans_b.points;
+}
+
+/**
+ * Invoke the callback for each point of a grid of destinations
+ * around the origin, at terrain height.  Stops as soon as the
+ * callback returns false.
+ *
+ * @return false if the callback has returned false
+ */
+template<typename F>
+static bool
+ForEachDestination(const RasterMap &map, const GeoPoint &origin, F &&f)
+{
+  constexpr unsigned N = 20;
+
+  for (unsigned i = 0; i < N; ++i) {
+    for (unsigned j = 0; j < N; ++j) {
+      const double fx = (double)i / (N - 1) * 2 - 1;
+      const double fy = (double)j / (N - 1) * 2 - 1;
+      const GeoPoint x(origin.longitude + Angle::Degrees(0.4 * fx),
+                       origin.latitude + Angle::Degrees(0.4 * fy));
+      if (!f(AGeoPoint(x, map.GetHeight(x).GetValueOr0())))
+        return false;
+    }
+  }
+
+  return true;
+}
+
+static bool
+SameArrivals(const RasterMap &map, const GeoPoint &origin,
+             const TerrainRoute &a, const TerrainRoute &b)
+{
+  return ForEachDestination(map, origin,
+                            [&a, &b](const AGeoPoint &destination){
+      ReachResult result_a, result_b;
+      a.FindPositiveArrival(destination, result_a);
+      b.FindPositiveArrival(destination, result_b);
+      return result_a == result_b;
+    });
+}
+
+/**
+ * Compare FindPositiveArrivals() with FindPositiveArrival().
+ */
+static bool
+SameBatchArrivals(const RasterMap &map, const GeoPoint &origin,
+                  const TerrainRoute &route)
+{
+  std::vector<AGeoPoint> destinations;
+  ForEachDestination(map, origin,
+                     [&destinations](const AGeoPoint &destination){
+      destinations.push_back(destination);
+      return true;
+    });
+
+  std::vector<ReachResult> results(destinations.size());
+  if (!route.FindPositiveArrivals(destinations.data(), results.data(),
+                                  destinations.size()))
+    return false;
+
+  for (unsigned i = 0; i < destinations.size(); ++i) {
+    ReachResult result;
+    if (!route.FindPositiveArrival(destinations[i], result) ||
+        !(result == results[i]))
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Check that the incremental reach #a is never more optimistic than
+ * the reach #b calculated from scratch: reusing child fans of a
+ * previous calculation may lose reach, but must never gain any.
+ */
+static bool
+NotBetterArrivals(const RasterMap &map, const GeoPoint &origin,
+                  const TerrainRoute &a, const TerrainRoute &b)
+{
+  return ForEachDestination(map, origin,
+                            [&a, &b](const AGeoPoint &destination){
+      ReachResult result_a, result_b;
+      a.FindPositiveArrival(destination, result_a);
+      b.FindPositiveArrival(destination, result_b);
+
+      if (result_a.direct != result_b.direct)
+        return false;
+
+      return !result_a.IsReachableTerrain() ||
+        (result_b.IsReachableTerrain() &&
+         result_a.terrain <= result_b.terrain);
+    });
+}
+
+static RoutePlannerConfig
+MakeConfig()
+{
+  RoutePlannerConfig config;
+  config.SetDefaults();
+  /* child fans are only calculated in "turning" mode */
+  config.reach_calc_mode = RoutePlannerConfig::ReachMode::TURNING;
+  return config;
+}
+
+/**
+ * Set up a #TerrainRoute with the default glide settings, a polar
+ * for the given MacCready setting and a wind from 240 degrees.
+ */
+static void
+MakeRoute(TerrainRoute &route, const RasterMap &map,
+          const RoutePlannerConfig &config,
+          double mc, double wind_speed)
+{
+  GlideSettings settings;
+  settings.SetDefaults();
+
+  const GlidePolar polar(mc);
+  const SpeedVector wind(Angle::Degrees(240), wind_speed);
+
+  route.UpdatePolar(settings, config, polar, polar, wind, 500);
+  route.SetTerrain(&map);
+}
+
+static void
+SolveReach(TerrainRoute &route, const AGeoPoint &origin,
+           const RoutePlannerConfig &config)
+{
+  route.SolveReachTerrain(origin, config, INT_MAX);
+  route.SolveReachWorking(origin, config, INT_MAX);
+}
+
+static unsigned max_fans = 0;
+
+static void
+TestReach(const RasterMap &map, ReachFanExecutor &executor,
+          const GeoPoint &origin, int height_agl,
+          double wind_speed, double mc)
+{
+  const RoutePlannerConfig config = MakeConfig();
+
+  TerrainRoute serial, parallel;
+  MakeRoute(serial, map, config, mc, wind_speed);
+  MakeRoute(parallel, map, config, mc, wind_speed);
+  parallel.SetReachExecutor(&executor);
+
+  const AGeoPoint aorigin(origin,
+                          map.GetHeight(origin).GetValueOr0() + height_agl);
+
+  SolveReach(serial, aorigin, config);
+  SolveReach(parallel, aorigin, config);
+
+  unsigned n_fans;
+  ok(SameFans(map, serial, parallel, false, n_fans), "terrain reach");
+  if (n_fans > max_fans)
+    max_fans = n_fans;
+
+  ok(SameFans(map, serial, parallel, true, n_fans), "working reach");
+  ok(SameArrivals(map, origin, serial, parallel), "arrivals");
+  ok(SameBatchArrivals(map, origin, serial), "batch arrivals");
+}
+
+/**
+ * Fly a few calculation cycles with incremental reach updates, and
+ * compare the result with a calculation from scratch.
+ */
+static void
+TestIncremental(const RasterMap &map, const GeoPoint &origin)
+{
+  const RoutePlannerConfig config = MakeConfig();
+
+  TerrainRoute incremental;
+  incremental.SetIncrementalReach(true);
+  MakeRoute(incremental, map, config, 1, 5);
+
+  /* 150m and 4m height loss per cycle, like a glider in cruise */
+  AGeoPoint location(origin,
+                     map.GetHeight(origin).GetValueOr0() + 1500);
+  for (unsigned i = 0; i < 10; ++i) {
+    SolveReach(incremental, location, config);
+
+    location = AGeoPoint(GeoPoint(location.longitude,
+                                  location.latitude +
+                                  Angle::Degrees(150 / 111195.)),
+                         location.altitude - 4);
+  }
+
+  TerrainRoute full;
+  MakeRoute(full, map, config, 1, 5);
+  SolveReach(full, location, config);
+
+  SolveReach(incremental, location, config);
+  ok(NotBetterArrivals(map, location, incremental, full),
+     "incremental arrivals");
+
+  /* a MacCready change must trigger a calculation from scratch */
+  MakeRoute(incremental, map, config, 2, 5);
+  MakeRoute(full, map, config, 2, 5);
+  SolveReach(incremental, location, config);
+  SolveReach(full, location, config);
+
+  unsigned n_fans;
+  ok(SameFans(map, incremental, full, false, n_fans) &&
+     SameFans(map, incremental, full, true, n_fans),
+     "rebuild after MacCready change");
+
+  /* after a climb, the old child fans are too pessimistic, and the
+     reach must be calculated from scratch */
+  for (unsigned i = 0; i < 4; ++i) {
+    location = AGeoPoint(GeoPoint(location.longitude +
+                                  Angle::Degrees(30 / 69000.),
+                                  location.latitude),
+                         location.altitude + 50);
+    SolveReach(incremental, location, config);
+  }
+
+  SolveReach(full, location, config);
+  ok(SameFans(map, incremental, full, false, n_fans) &&
+     SameFans(map, incremental, full, true, n_fans),
+     "rebuild after climb");
+}
+
+int main(int argc, char **argv)
+{
+  static constexpr int heights[] = { 500, 1000, 2500 };
+  static constexpr double winds[] = { 0, 15 };
+  static constexpr double offsets[][2] = {
+    { 0, 0 }, { 0.1, 0.05 }, { -0.15, 0.1 }, { 0.05, -0.2 },
+  };
+
+  const GeoPoint center(Angle::Degrees(7.7), Angle::Degrees(51.4));
+
+  RasterMap map;
+  GenerateSyntheticTerrain(map, center);
+
+  ThreadPoolExecutor executor;
+
+  plan_tests(ARRAY_SIZE(offsets) * ARRAY_SIZE(heights) *
+             ARRAY_SIZE(winds) * 4 + 1 +
+             ARRAY_SIZE(offsets) * 3);
+
+  for (const auto &offset : offsets) {
+    const GeoPoint origin(center.longitude + Angle::Degrees(offset[0]),
+                          center.latitude + Angle::Degrees(offset[1]));
+
+    for (const int height : heights)
+      for (const double wind : winds)
+        TestReach(map, executor, origin, height, wind, 1);
+  }
+
+  /* make sure the test has covered a tree deeper than the root fan */
+  ok(max_fans > 1, "child fans");
+
+  for (const auto &offset : offsets)
+    TestIncremental(map,
+                    GeoPoint(center.longitude + Angle::Degrees(offset[0]),
+                             center.latitude + Angle::Degrees(offset[1])));
+
+  return exit_status();
+}
@@ -0,0 +1,120 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Verify that RoutePolarCache returns the same tables as RoutePolar,
+ * and that it calculates them only when needed.
+ */
+
+#include "Engine/Route/RoutePolarCache.hpp"
+#include "GlideSolvers/GlideSettings.hpp"
+#include "GlideSolvers/GlidePolar.hpp"
+#include "Geo/SpeedVector.hpp"
+
+extern "C" {
+#include "tap.h"
+}
+
+static bool
+operator==(const RoutePolar &a, const RoutePolar &b)
+{
+  for (unsigned i = 0; i < ROUTEPOLAR_POINTS; ++i) {
+    const auto &pa = a.GetPoint(i), &pb = b.GetPoint(i);
+    if (pa.valid != pb.valid)
+      return false;
+
+    if (pa.valid &&
+        (pa.slowness != pb.slowness || pa.gradient != pb.gradient ||
+         pa.inv_gradient != pb.inv_gradient))
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Compare the cached tables with tables calculated directly.
+ */
+static bool
+SameTables(RoutePolarCache &cache, const GlideSettings &settings,
+           const GlidePolar &polar, const SpeedVector &wind,
+           const SpeedVector &quantised_wind)
+{
+  RoutePolar glide, cruise;
+  cache.Get(settings, polar, wind, glide, cruise);
+
+  RoutePolar expected_glide, expected_cruise;
+  expected_glide.Initialise(settings, polar, quantised_wind, true);
+  expected_cruise.Initialise(settings, polar, quantised_wind, false);
+
+  return glide == expected_glide && cruise == expected_cruise;
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(11);
+
+  GlideSettings settings;
+  settings.SetDefaults();
+
+  const GlidePolar polar1(1), polar2(2);
+
+  /* 3 m/s from the east, 2 m/s from the north */
+  const SpeedVector wind(3, 2);
+
+  RoutePolarCache cache;
+
+  ok1(SameTables(cache, settings, polar1, wind, wind));
+  ok1(cache.GetMisses() == 1);
+
+  /* small changes of the wind are absorbed by the quantisation */
+  ok1(SameTables(cache, settings, polar1, SpeedVector(3.1, 1.9), wind));
+  ok1(cache.GetMisses() == 1);
+
+  /* a new MacCready setting needs new tables */
+  ok1(SameTables(cache, settings, polar2, wind, wind));
+  ok1(cache.GetMisses() == 2);
+
+  /* ... but going back to the previous one doesn't */
+  ok1(SameTables(cache, settings, polar1, wind, wind));
+  ok1(cache.GetMisses() == 2);
+
+  /* the least recently used entry is evicted when the cache is full */
+  for (unsigned i = 1; i <= 7; ++i)
+    SameTables(cache, settings, polar1,
+               SpeedVector(3, 2 + i), SpeedVector(3, 2 + i));
+
+  RoutePolar glide, cruise;
+  cache.Get(settings, polar1, wind, glide, cruise);
+  cache.Get(settings, polar2, wind, glide, cruise);
+  ok1(cache.GetMisses() == 2 + 7 + 1);
+
+  /* degraded performance (bugs) changes the real polar, but not the
+     MacCready setting */
+  GlidePolar dirty(1);
+  dirty.SetBugs(0.8);
+  ok1(SameTables(cache, settings, dirty, wind, wind));
+  ok1(cache.GetMisses() == 2 + 7 + 1 + 1);
+
+  return exit_status();
+}
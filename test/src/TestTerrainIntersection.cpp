@@ -0,0 +1,395 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compare RasterTileCache::FirstIntersection() and
+ * RasterTileCache::Intersection(), which sample the terrain only
+ * every few steps and skip blocks using the #MaxElevationIndex, with
+ * a brute force walk which samples every step of the line.
+ */
+
+#include "SyntheticTerrain.hpp"
+#include "DeterministicRandom.hpp"
+#include "Terrain/RasterMap.hpp"
+
+extern "C" {
+#include "tap.h"
+}
+
+#include <algorithm>
+
+#include <stdlib.h>
+
+static constexpr unsigned MAP_SIZE = 2048;
+static constexpr unsigned N_QUERIES = 4000;
+
+/*
+ * Tolerances.  The searches sample the terrain only every few steps,
+ * so they may step over a ridge which the glide path barely touches,
+ * and then report a later hit or none at all.  This happened before
+ * the #MaxElevationIndex, too; with the same queries the unindexed
+ * searches were measured at 0.7% missed hits and 2.9% of the
+ * Intersection() hits beyond #IntersectionTolerance() (indexed: 0.8%
+ * and 3.1%), and FirstIntersection() kept 96.8% of the heights within
+ * #MAX_HEIGHT_ERROR (indexed: 97.0%).
+ */
+
+/**
+ * Maximum share of queries, in percent, where the search misses a hit
+ * which the brute force walk finds.
+ */
+static constexpr unsigned MAX_MISSED_PERCENT = 2;
+
+/**
+ * Minimum share of hits, in percent, which must be within the
+ * tolerance.
+ */
+static constexpr unsigned MIN_ACCURATE_PERCENT = 95;
+
+/**
+ * The tolerance of an Intersection() location: one sample interval
+ * (1/32 of the line), but at least 4 pixels.
+ */
+static constexpr unsigned
+IntersectionTolerance(unsigned distance)
+{
+  return std::max(4u, distance >> 5);
+}
+
+/**
+ * The tolerance of a FirstIntersection() height [m].  Its location
+ * is where the glide path has cleared the obstacle, which depends on
+ * the sample interval, and is therefore not compared.
+ */
+static constexpr unsigned MAX_HEIGHT_ERROR = 50;
+
+/**
+ * Walks the line algorithm used by the intersection searches one
+ * step at a time.
+ */
+class LineWalker {
+  const SignedRasterLocation origin;
+  const int dx, dy, sx, sy;
+  int err;
+
+public:
+  SignedRasterLocation location;
+  int total_steps = 0;
+  const int max_steps;
+
+  LineWalker(SignedRasterLocation _origin, SignedRasterLocation destination)
+    :origin(_origin),
+     dx(abs(destination.x - origin.x)), dy(abs(destination.y - origin.y)),
+     sx(origin.x < destination.x ? 1 : -1),
+     sy(origin.y < destination.y ? 1 : -1),
+     err(dx - dy), location(origin), max_steps(dx + dy) {}
+
+  void Step() {
+    const int e2 = 2 * err;
+    if (e2 > -dy) {
+      err -= dy;
+      location.x += sx;
+      total_steps++;
+    }
+    if (e2 < dx) {
+      err += dx;
+      location.y += sy;
+      total_steps++;
+    }
+  }
+};
+
+static bool
+IsInside(const RasterTileCache &cache, SignedRasterLocation l)
+{
+  return l.x >= 0 && l.y >= 0 &&
+    unsigned(l.x) < cache.GetWidth() && unsigned(l.y) < cache.GetHeight();
+}
+
+/**
+ * Like RasterTileCache::Intersection(), but samples every step.
+ */
+static SignedRasterLocation
+BruteForceIntersection(const RasterTileCache &cache,
+                       SignedRasterLocation origin,
+                       SignedRasterLocation destination,
+                       int h_origin, int slope_fact, int height_floor)
+{
+  LineWalker line(origin, destination);
+  SignedRasterLocation last_clear = origin;
+
+  while (IsInside(cache, line.location)) {
+    const TerrainHeight h = cache.GetHeight(line.location.x, line.location.y);
+    if (h.IsInvalid())
+      break;
+
+    const int h_int = h_origin -
+      ((line.total_steps * slope_fact) >> RASTER_SLOPE_FACT);
+    if (h_int < std::max(int(h.GetValueOr0()), height_floor))
+      return last_clear;
+
+    if (h_int <= 0)
+      break;
+
+    last_clear = line.location;
+
+    if (line.total_steps > line.max_steps)
+      break;
+
+    line.Step();
+  }
+
+  return {-1, -1};
+}
+
+/**
+ * Like RasterTileCache::FirstIntersection(), but samples every step.
+ */
+static bool
+BruteForceFirstIntersection(const RasterTileCache &cache,
+                            SignedRasterLocation origin,
+                            SignedRasterLocation destination,
+                            int h_origin, int h_dest,
+                            int slope_fact, int h_ceiling, int h_safety,
+                            SignedRasterLocation &location_r, int &h_r,
+                            bool can_climb)
+{
+  const TerrainHeight h_origin2 = cache.GetHeight(origin.x, origin.y);
+  if (!h_origin2.IsSpecial())
+    h_origin = std::max(h_origin, int(h_origin2.GetValue()));
+
+  h_dest = std::max(h_dest, h_origin);
+
+  if (h_origin > h_ceiling) {
+    location_r = origin;
+    h_r = h_origin;
+    return true;
+  }
+
+  /* the number of clear steps after an intersection */
+  constexpr int intersect_steps = 32;
+
+  LineWalker line(origin, destination);
+  SignedRasterLocation last_clear = origin;
+  int last_clear_h = h_origin;
+  int intersect_counter = 0;
+
+  while (IsInside(cache, line.location)) {
+    const TerrainHeight h = cache.GetHeight(line.location.x, line.location.y);
+    if (h.IsInvalid())
+      break;
+
+    const int h_terrain = h.GetValueOr0() + h_safety;
+
+    int h_int = h_origin +
+      ((line.total_steps * slope_fact) >> RASTER_SLOPE_FACT);
+    if (can_climb)
+      h_int = std::min(h_int, h_dest);
+
+    const bool intersecting = h_int < h_terrain;
+    if (intersecting) {
+      intersect_counter = 1;
+
+      const int h_jump = h_terrain - h_int;
+      h_origin += h_jump;
+      if (can_climb)
+        h_dest = std::max(h_dest, h_terrain);
+      else
+        h_dest += h_jump;
+
+      h_int = h_terrain;
+    }
+
+    if (h_int > h_ceiling) {
+      location_r = last_clear;
+      h_r = last_clear_h;
+      return true;
+    }
+
+    if (!intersecting) {
+      if (intersect_counter) {
+        if (++intersect_counter >= intersect_steps) {
+          location_r = line.location;
+          h_r = h_int;
+          return true;
+        }
+      } else {
+        last_clear = line.location;
+        last_clear_h = h_int;
+      }
+    }
+
+    if (!intersect_counter && line.total_steps == line.max_steps)
+      return false;
+
+    line.Step();
+  }
+
+  if (intersect_counter) {
+    location_r = last_clear;
+    h_r = last_clear_h;
+    return true;
+  }
+
+  return false;
+}
+
+static unsigned
+Distance(SignedRasterLocation a, SignedRasterLocation b)
+{
+  return abs(a.x - b.x) + abs(a.y - b.y);
+}
+
+static SignedRasterLocation
+RandomPixel()
+{
+  return SignedRasterLocation(RandomInt(MAP_SIZE), RandomInt(MAP_SIZE));
+}
+
+/**
+ * Returns a random destination up to #max_distance pixels away,
+ * within the map.
+ */
+static SignedRasterLocation
+RandomDestination(SignedRasterLocation origin, unsigned max_distance)
+{
+  const int d = max_distance;
+  SignedRasterLocation destination(origin.x + int(RandomInt(2 * d)) - d,
+                                   origin.y + int(RandomInt(2 * d)) - d);
+  destination.x = std::max(0, std::min(destination.x, int(MAP_SIZE) - 1));
+  destination.y = std::max(0, std::min(destination.y, int(MAP_SIZE) - 1));
+  return destination;
+}
+
+static void
+TestIntersection(const RasterTileCache &cache)
+{
+  unsigned n_hits = 0, n_accurate = 0, n_missed = 0, n_false = 0;
+
+  for (unsigned i = 0; i < N_QUERIES; ++i) {
+    const SignedRasterLocation origin = RandomPixel();
+    const SignedRasterLocation destination = RandomDestination(origin, 1000);
+    const unsigned distance = Distance(origin, destination);
+    if (distance == 0)
+      continue;
+
+    const int h_origin = cache.GetHeight(origin.x, origin.y).GetValueOr0()
+      + 100 + RandomInt(2000);
+    const int h_glide = 500 + RandomInt(3000);
+    const int slope_fact = (h_glide << RASTER_SLOPE_FACT) / int(distance);
+    const int height_floor = RandomInt(2) ? 0 : 800;
+
+    const auto indexed = cache.Intersection(origin, destination, h_origin,
+                                            slope_fact, height_floor);
+    const auto brute = BruteForceIntersection(cache, origin, destination,
+                                              h_origin, slope_fact,
+                                              height_floor);
+
+    if (brute.x < 0) {
+      if (indexed.x >= 0)
+        ++n_false;
+    } else if (indexed.x < 0) {
+      ++n_missed;
+    } else {
+      ++n_hits;
+      if (Distance(indexed, brute) <= IntersectionTolerance(distance))
+        ++n_accurate;
+    }
+  }
+
+  ok1(n_false == 0);
+  ok1(n_missed * 100 <= N_QUERIES * MAX_MISSED_PERCENT);
+  ok1(n_hits > N_QUERIES / 2);
+  ok1(n_accurate * 100 >= n_hits * MIN_ACCURATE_PERCENT);
+}
+
+static void
+TestFirstIntersection(const RasterTileCache &cache)
+{
+  unsigned n_hits = 0, n_accurate = 0, n_missed = 0, n_false = 0;
+
+  for (unsigned i = 0; i < N_QUERIES; ++i) {
+    const SignedRasterLocation origin = RandomPixel();
+    const SignedRasterLocation destination = RandomDestination(origin, 1000);
+    const unsigned distance = Distance(origin, destination);
+    if (distance == 0)
+      continue;
+
+    const int h_origin = cache.GetHeight(origin.x, origin.y).GetValueOr0()
+      + RandomInt(1500);
+    const int h_dest = cache.GetHeight(destination.x, destination.y)
+      .GetValueOr0() + RandomInt(1500);
+    const bool can_climb = RandomInt(2);
+    const int h_virt = 200 + RandomInt(1500);
+    const int slope_fact = (h_virt << RASTER_SLOPE_FACT) / int(distance);
+    const int h_ceiling = 2000 + RandomInt(2000);
+    const int h_safety = 100;
+
+    RasterLocation indexed_location;
+    int indexed_h;
+    const bool indexed =
+      cache.FirstIntersection(origin, destination, h_origin, h_dest,
+                              slope_fact, h_ceiling, h_safety,
+                              indexed_location, indexed_h, can_climb);
+
+    SignedRasterLocation brute_location;
+    int brute_h;
+    const bool brute =
+      BruteForceFirstIntersection(cache, origin, destination,
+                                  h_origin, h_dest,
+                                  slope_fact, h_ceiling, h_safety,
+                                  brute_location, brute_h, can_climb);
+
+    if (!brute) {
+      if (indexed)
+        ++n_false;
+    } else if (!indexed) {
+      ++n_missed;
+    } else {
+      ++n_hits;
+      if (unsigned(abs(indexed_h - brute_h)) <= MAX_HEIGHT_ERROR)
+        ++n_accurate;
+    }
+  }
+
+  ok1(n_false == 0);
+  ok1(n_missed * 100 <= N_QUERIES * MAX_MISSED_PERCENT);
+  ok1(n_hits > N_QUERIES / 2);
+  ok1(n_accurate * 100 >= n_hits * MIN_ACCURATE_PERCENT);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(8);
+
+  RasterMap map;
+  GenerateSyntheticTerrain(map, GeoPoint(Angle::Degrees(7.7),
+                                         Angle::Degrees(51.4)),
+                           MAP_SIZE);
+
+  const RasterTileCache &cache = map.GetTileCache();
+  TestIntersection(cache);
+  TestFirstIntersection(cache);
+
+  return exit_status();
+}
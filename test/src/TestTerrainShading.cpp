@@ -0,0 +1,202 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compare the optimised terrain shading kernels with the portable
+ * reference implementation.  Both must yield exactly the same
+ * results.
+ */
+
+#include "Terrain/Shading/Optimised.hpp"
+#include "DeterministicRandom.hpp"
+
+extern "C" {
+#include "tap.h"
+}
+
+#include <string.h>
+#include <math.h>
+
+/**
+ * Not a multiple of any vector size, to check the remainder
+ * handling.
+ */
+static constexpr unsigned WIDTH = 203;
+
+static TerrainHeight
+RandomHeight(int base, unsigned jitter)
+{
+  switch (RandomInt(64)) {
+  case 0:
+    return TerrainHeight::Invalid();
+
+  case 1:
+    /* water */
+    return TerrainHeight(-30000 - (int)RandomInt(2000));
+
+  case 2:
+    return TerrainHeight(32767);
+
+  case 3:
+    return TerrainHeight(-29999);
+
+  default:
+    return TerrainHeight(Clamp(base + (int)RandomInt(2 * jitter + 1)
+                               - (int)jitter,
+                               -2000, 9000));
+  }
+}
+
+static void
+FillRow(TerrainHeight *row, unsigned n, unsigned jitter)
+{
+  int base = RandomInt(4000);
+  for (unsigned i = 0; i < n; ++i) {
+    base = Clamp(base + (int)RandomInt(41) - 20, 0, 8000);
+    row[i] = RandomHeight(base, jitter);
+  }
+}
+
+/**
+ * Generate parameters within the limits which RasterRenderer
+ * guarantees.
+ */
+static TerrainShadingParameters
+RandomParameters()
+{
+  const unsigned q = 1 + RandomInt(25);
+
+  const double azimuth = RandomInt(360) * M_PI / 180;
+  const double elevation = (10 + RandomInt(81)) * M_PI / 180;
+
+  TerrainShadingParameters params;
+  params.sx = (int)(255 * cos(elevation) * -sin(azimuth));
+  params.sy = (int)(255 * cos(elevation) * -cos(azimuth));
+  params.sz = (int)(255 * sin(elevation));
+  params.contrast = RandomInt(256);
+  params.p20 = q + RandomInt(q + 1);
+  params.p31 = q + RandomInt(q + 1);
+  params.height_slope_factor = 1 + RandomInt(8192 / (q * q));
+  return params;
+}
+
+static bool
+CompareSlopeRow(const TerrainShadingParameters &params, unsigned jitter)
+{
+  TerrainHeight above[WIDTH], below[WIDTH], left[WIDTH], right[WIDTH];
+  FillRow(above, WIDTH, jitter);
+  FillRow(below, WIDTH, jitter);
+  FillRow(left, WIDTH, jitter);
+  FillRow(right, WIDTH, jitter);
+
+  int8_t expected[WIDTH], actual[WIDTH];
+  PortableTerrainShading::SlopeRow(expected, above, below, left, right,
+                                   WIDTH, params);
+  OptimisedTerrainShading::SlopeRow(actual, above, below, left, right,
+                                    WIDTH, params);
+
+  return memcmp(expected, actual, sizeof(expected)) == 0;
+}
+
+static bool
+CompareHeightRow(unsigned height_scale, unsigned contour_height_scale)
+{
+  TerrainHeight src[WIDTH];
+  FillRow(src, WIDTH, 500);
+
+  uint8_t expected_index[WIDTH], expected_contour[WIDTH];
+  PortableTerrainShading::HeightRow(expected_index, expected_contour,
+                                    src, WIDTH,
+                                    height_scale, contour_height_scale);
+
+  uint8_t actual_index[WIDTH], actual_contour[WIDTH];
+  OptimisedTerrainShading::HeightRow(actual_index, actual_contour,
+                                     src, WIDTH,
+                                     height_scale, contour_height_scale);
+
+  return memcmp(expected_index, actual_index, sizeof(actual_index)) == 0 &&
+    memcmp(expected_contour, actual_contour, sizeof(actual_contour)) == 0;
+}
+
+static void
+TestExtremes()
+{
+  /* the largest values the formula can see */
+  const unsigned q = 25;
+  TerrainShadingParameters params;
+  params.sx = 255;
+  params.sy = -255;
+  params.sz = 255;
+  params.contrast = 255;
+  params.p20 = params.p31 = 2 * q;
+  params.height_slope_factor = 8192 / (q * q);
+
+  TerrainHeight high[WIDTH], low[WIDTH];
+  std::fill_n(high, WIDTH, TerrainHeight(32767));
+  std::fill_n(low, WIDTH, TerrainHeight(-29999));
+
+  int8_t expected[WIDTH], actual[WIDTH];
+  PortableTerrainShading::SlopeRow(expected, high, low, low, high,
+                                   WIDTH, params);
+  OptimisedTerrainShading::SlopeRow(actual, high, low, low, high,
+                                    WIDTH, params);
+  ok1(memcmp(expected, actual, sizeof(expected)) == 0);
+
+  PortableTerrainShading::SlopeRow(expected, low, high, high, low,
+                                   WIDTH, params);
+  OptimisedTerrainShading::SlopeRow(actual, low, high, high, low,
+                                    WIDTH, params);
+  ok1(memcmp(expected, actual, sizeof(expected)) == 0);
+
+  /* flat terrain, smallest slope factor */
+  params.p20 = params.p31 = 1;
+  params.height_slope_factor = 1;
+  PortableTerrainShading::SlopeRow(expected, high, high, high, high,
+                                   WIDTH, params);
+  OptimisedTerrainShading::SlopeRow(actual, high, high, high, high,
+                                    WIDTH, params);
+  ok1(memcmp(expected, actual, sizeof(expected)) == 0);
+}
+
+static constexpr unsigned N_RANDOM_SLOPE = 200;
+
+int main(int argc, char **argv)
+{
+  plan_tests(3 + 3 * N_RANDOM_SLOPE + 2 * 17);
+
+  TestExtremes();
+
+  for (unsigned i = 0; i < N_RANDOM_SLOPE; ++i) {
+    const TerrainShadingParameters params = RandomParameters();
+    ok1(CompareSlopeRow(params, 5));
+    ok1(CompareSlopeRow(params, 200));
+    ok1(CompareSlopeRow(params, 5000));
+  }
+
+  for (unsigned height_scale = 0; height_scale <= 16; ++height_scale) {
+    ok1(CompareHeightRow(height_scale, height_scale * 2 > 16
+                         ? 16 : height_scale * 2));
+    ok1(CompareHeightRow(height_scale, 16));
+  }
+
+  return exit_status();
+}
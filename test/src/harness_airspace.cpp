@@ -27,10 +27,18 @@
 #include "Airspace/AirspaceIntersectionVisitor.hpp"
 #include "Airspace/SoonestAirspace.hpp"
 #include "Engine/Airspace/Predicate/AirspacePredicate.hpp"
+#include "Engine/Airspace/AirspaceAircraftPerformance.hpp"
+#include "Engine/Airspace/AirspaceInterceptSolution.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Task/Stats/TaskStats.hpp"
 #include "Geo/GeoVector.hpp"
 #include "Formatter/AirspaceFormatter.hpp"
 #include "OS/FileUtil.hpp"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include <stdlib.h>
 #include <fstream>
 #include <iostream>
@@ -335,3 +343,227 @@ print_warnings(const AirspaceWarningManager &airspace_warnings)
   PrintAirspaceWarnings("output/results/res-as-warnings-task.txt",
                         airspace_warnings, AirspaceWarning::WARNING_TASK);
 }
+
+ReferenceAirspaceWarnings::ReferenceAirspaceWarnings(const AirspaceWarningConfig &_config,
+                                                     const Airspaces &_airspaces)
+  :config(_config), airspaces(_airspaces)
+{
+  /* like AirspaceWarningManager::SetPredictionTimeFilter() */
+  cruise_filter.Design(std::max(10., config.warning_time * 0.5));
+  circling_filter.Design(std::max(10., double(config.warning_time)));
+}
+
+void
+ReferenceAirspaceWarnings::Reset(const AircraftState &state)
+{
+  warnings.clear();
+  cruise_filter.Reset(state);
+  circling_filter.Reset(state);
+}
+
+AirspaceWarning &
+ReferenceAirspaceWarnings::GetWarning(const AbstractAirspace &airspace)
+{
+  for (auto &w : warnings)
+    if (&w.GetAirspace() == &airspace)
+      return w;
+
+  warnings.emplace_back(airspace);
+  return warnings.back();
+}
+
+const AirspaceWarning *
+ReferenceAirspaceWarnings::GetWarningPtr(const AbstractAirspace &airspace) const
+{
+  for (const auto &w : warnings)
+    if (&w.GetAirspace() == &airspace)
+      return &w;
+
+  return nullptr;
+}
+
+void
+ReferenceAirspaceWarnings::Update(const AircraftState &state,
+                                  const GlidePolar &glide_polar,
+                                  const TaskStats &task_stats,
+                                  const bool circling, const unsigned dt)
+{
+  if (airspaces.IsEmpty())
+    return;
+
+  for (auto &w : warnings)
+    w.SaveState();
+
+  UpdateInside(state, glide_polar);
+
+  if (glide_polar.IsValid())
+    UpdatePredicted(state,
+                    state.GetPredictedState(config.warning_time).location,
+                    AirspaceAircraftPerformance(glide_polar),
+                    AirspaceWarning::WARNING_GLIDE, config.warning_time);
+
+  cruise_filter.Update(state);
+  circling_filter.Update(state);
+
+  const AircraftStateFilter &filter = circling
+    ? circling_filter
+    : cruise_filter;
+  UpdatePredicted(state,
+                  filter.GetPredictedState(config.warning_time).location,
+                  AirspaceAircraftPerformance(filter),
+                  AirspaceWarning::WARNING_FILTER, config.warning_time);
+
+  const ElementStat &current_leg = task_stats.current_leg;
+  const GlideResult &solution = current_leg.solution_remaining;
+  if (glide_polar.IsValid() && task_stats.task_valid &&
+      current_leg.location_remaining.IsValid() &&
+      solution.IsOk() && solution.IsAchievable()) {
+    GeoPoint location_tp = current_leg.location_remaining;
+    const GeoVector vector(state.location, location_tp);
+    const auto max_distance = config.warning_time * glide_polar.GetVMax();
+    if (vector.distance > max_distance)
+      location_tp = state.location.IntermediatePoint(location_tp,
+                                                     max_distance);
+
+    UpdatePredicted(state, location_tp,
+                    AirspaceAircraftPerformance(glide_polar, solution),
+                    AirspaceWarning::WARNING_TASK, solution.time_elapsed);
+  }
+
+  for (auto i = warnings.begin(); i != warnings.end();) {
+    if (i->WarningLive(config.acknowledgement_time, dt))
+      ++i;
+    else
+      i = warnings.erase(i);
+  }
+
+  warnings.sort();
+}
+
+void
+ReferenceAirspaceWarnings::UpdateInside(const AircraftState &state,
+                                        const GlidePolar &glide_polar)
+{
+  if (!glide_polar.IsValid())
+    return;
+
+  const FlatProjection &projection = airspaces.GetProjection();
+
+  for (const auto &i : airspaces.QueryInside(state.location)) {
+    const AbstractAirspace &airspace = i.GetAirspace();
+
+    const AltitudeState &altitude = state;
+    if (!airspace.IsActive() ||
+        !config.IsClassEnabled(airspace.GetType()) ||
+        !airspace.Inside(altitude))
+      continue;
+
+    const AirspaceWarning *warning = GetWarningPtr(airspace);
+    if (warning != nullptr &&
+        !warning->IsStateAccepted(AirspaceWarning::WARNING_INSIDE))
+      continue;
+
+    const GeoPoint c = airspace.ClosestPoint(state.location, projection);
+    const AirspaceAircraftPerformance perf_glide(glide_polar);
+    GetWarning(airspace).UpdateSolution(AirspaceWarning::WARNING_INSIDE,
+                                        airspace.Intercept(state, c,
+                                                           projection,
+                                                           perf_glide));
+  }
+}
+
+/**
+ * Collects the intercept solutions of all airspaces visited by
+ * Airspaces::VisitIntersecting(), or, in "inside" mode, the solutions
+ * at the aircraft's location.
+ */
+class ReferenceWarningVisitor final : public AirspaceIntersectionVisitor {
+  const AircraftState &state;
+  const AirspaceAircraftPerformance &perf;
+
+public:
+  bool mode_inside = false;
+
+  std::vector<std::pair<const AbstractAirspace *,
+                        AirspaceInterceptSolution>> solutions;
+
+  ReferenceWarningVisitor(const AircraftState &_state,
+                          const AirspaceAircraftPerformance &_perf)
+    :state(_state), perf(_perf) {}
+
+  void Visit(const AbstractAirspace &airspace) override {
+    solutions.emplace_back(&airspace,
+                           mode_inside
+                           ? airspace.Intercept(state, perf,
+                                                state.location,
+                                                state.location)
+                           : Intercept(airspace, state, perf));
+  }
+};
+
+void
+ReferenceAirspaceWarnings::UpdatePredicted(const AircraftState &state,
+                                           const GeoPoint &location_predicted,
+                                           const AirspaceAircraftPerformance &perf,
+                                           const AirspaceWarning::State warning_state,
+                                           const double max_time)
+{
+  const auto max_time_limit = std::min(double(config.warning_time), max_time);
+  const auto ceiling = state.altitude
+    + std::max((unsigned)1000, config.altitude_warning_margin);
+
+  ReferenceWarningVisitor visitor(state, perf);
+  airspaces.VisitIntersecting(state.location, location_predicted, visitor);
+
+  visitor.mode_inside = true;
+  for (const auto &i : airspaces.QueryInside(state.location))
+    visitor.Visit(i.GetAirspace());
+
+  /* all solutions of this pass have the same state, so applying them
+     after the search gives the same result as applying each one
+     during the search */
+  for (const auto &i : visitor.solutions) {
+    const AbstractAirspace &airspace = *i.first;
+    const AirspaceInterceptSolution &solution = i.second;
+
+    if (!airspace.IsActive() ||
+        !config.IsClassEnabled(airspace.GetType()) ||
+        airspace.GetBaseAltitude(state) > ceiling)
+      continue;
+
+    const AirspaceWarning *warning = GetWarningPtr(airspace);
+    if ((warning != nullptr && !warning->IsStateAccepted(warning_state)) ||
+        !solution.IsValid() || solution.elapsed_time > max_time_limit)
+      continue;
+
+    GetWarning(airspace).UpdateSolution(warning_state, solution);
+  }
+}
+
+static bool
+operator==(const AirspaceInterceptSolution &a,
+           const AirspaceInterceptSolution &b)
+{
+  if (!a.IsValid() || !b.IsValid())
+    return a.IsValid() == b.IsValid();
+
+  return a.location == b.location && a.distance == b.distance &&
+    a.altitude == b.altitude && a.elapsed_time == b.elapsed_time;
+}
+
+bool
+ReferenceAirspaceWarnings::Equals(const AirspaceWarningManager &manager) const
+{
+  if (manager.size() != warnings.size())
+    return false;
+
+  for (const auto &w : manager) {
+    const AirspaceWarning *r = GetWarningPtr(w.GetAirspace());
+    if (r == nullptr ||
+        r->GetWarningState() != w.GetWarningState() ||
+        !(r->GetSolution() == w.GetSolution()))
+      return false;
+  }
+
+  return true;
+}
@@ -27,9 +27,65 @@
 #include "Airspace/AirspaceCircle.hpp"
 #include "Airspace/AirspacePolygon.hpp"
 #include "Airspace/AirspaceWarningManager.hpp"
+#include "Util/AircraftStateFilter.hpp"
+
+#include <list>
 
 extern AirspaceWarningManager *airspace_warnings;
 
+class GlidePolar;
+class TaskStats;
+
+/**
+ * The warning predictions of #AirspaceWarningManager as they were
+ * before it checked all predictions in one sweep: one search for the
+ * path of each prediction, and one for the airspaces the aircraft is
+ * inside.  This is used to check that the manager's results did not
+ * change.
+ */
+class ReferenceAirspaceWarnings {
+  AirspaceWarningConfig config;
+  const Airspaces &airspaces;
+
+  AircraftStateFilter cruise_filter;
+  AircraftStateFilter circling_filter;
+
+  std::list<AirspaceWarning> warnings;
+
+public:
+  ReferenceAirspaceWarnings(const AirspaceWarningConfig &_config,
+                            const Airspaces &_airspaces);
+
+  void Reset(const AircraftState &state);
+
+  /**
+   * See AirspaceWarningManager::Update().
+   */
+  void Update(const AircraftState &state, const GlidePolar &glide_polar,
+              const TaskStats &task_stats,
+              bool circling, unsigned dt);
+
+  /**
+   * Do both have warnings for the same airspaces, with the same
+   * states and solutions?
+   */
+  gcc_pure
+  bool Equals(const AirspaceWarningManager &manager) const;
+
+private:
+  AirspaceWarning &GetWarning(const AbstractAirspace &airspace);
+
+  gcc_pure
+  const AirspaceWarning *GetWarningPtr(const AbstractAirspace &airspace) const;
+
+  void UpdateInside(const AircraftState &state, const GlidePolar &glide_polar);
+  void UpdatePredicted(const AircraftState &state,
+                       const GeoPoint &location_predicted,
+                       const AirspaceAircraftPerformance &perf,
+                       AirspaceWarning::State warning_state,
+                       double max_time);
+};
+
 void setup_airspaces(Airspaces& airspaces, const GeoPoint &center, const unsigned n=150);
 
 void scan_airspaces(const AircraftState state, 
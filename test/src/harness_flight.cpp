@@ -57,6 +57,10 @@ public:
   PrintTaskAutoPilot(const AutopilotParameters &_parms):
     TaskAutoPilot(_parms) {};
 
+  bool IsClimbing() const {
+    return acstate == Climb;
+  }
+
 protected:
   virtual void OnManualAdvance() {
     if (verbose>1) {
@@ -130,14 +134,19 @@ run_flight(TestFlightComponents components, TaskManager &task_manager,
                  parms.start_alt);
 
   AirspaceWarningManager *airspace_warnings;
+  ReferenceAirspaceWarnings *reference_warnings;
   if (airspaces) {
     AirspaceWarningConfig airspace_warning_config;
     airspace_warning_config.SetDefaults();
     airspace_warnings = new AirspaceWarningManager(airspace_warning_config,
                                                    *airspaces);
     airspace_warnings->Reset(aircraft.GetState());
+    reference_warnings = new ReferenceAirspaceWarnings(airspace_warning_config,
+                                                       *airspaces);
+    reference_warnings->Reset(aircraft.GetState());
   } else {
     airspace_warnings = NULL;
+    reference_warnings = NULL;
   }
 
   do {
@@ -179,17 +188,27 @@ run_flight(TestFlightComponents components, TaskManager &task_manager,
                      autopilot.GetTarget(ta));
     }
     if (airspace_warnings) {
-      if (verbose > 1) {
-        bool warnings_updated = airspace_warnings->Update(aircraft.GetState(),
-                                                          task_manager.GetGlidePolar(),
-                                                          task_manager.GetStats(),
-                                                          false, 1);
-        if (warnings_updated) {
-          printf("# airspace warnings updated, size %d\n",
-                 (int)airspace_warnings->size());
-          print_warnings(*airspace_warnings);
-          WaitPrompt();
-        }
+      const bool circling = autopilot.IsClimbing();
+      bool warnings_updated = airspace_warnings->Update(aircraft.GetState(),
+                                                        task_manager.GetGlidePolar(),
+                                                        task_manager.GetStats(),
+                                                        circling, 1);
+
+      /* check the single sweep against one search per prediction */
+      reference_warnings->Update(aircraft.GetState(),
+                                 task_manager.GetGlidePolar(),
+                                 task_manager.GetStats(),
+                                 circling, 1);
+      if (!reference_warnings->Equals(*airspace_warnings))
+        ++result.airspace_warning_mismatches;
+
+      result.airspace_warning_states += airspace_warnings->size();
+
+      if (verbose > 1 && warnings_updated) {
+        printf("# airspace warnings updated, size %d\n",
+               (int)airspace_warnings->size());
+        print_warnings(*airspace_warnings);
+        WaitPrompt();
       }
     }
 
@@ -235,8 +254,10 @@ run_flight(TestFlightComponents components, TaskManager &task_manager,
   if (verbose)
     PrintDistanceCounts();
 
-  if (airspace_warnings)
+  if (airspace_warnings) {
     delete airspace_warnings;
+    delete reference_warnings;
+  }
 
   result.result = true;
   return result;
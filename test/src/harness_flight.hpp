@@ -47,10 +47,23 @@ struct TestFlightResult
   double calc_cruise_efficiency;
   double calc_effective_mc;
 
+  /**
+   * The number of airspace warnings compared with
+   * #ReferenceAirspaceWarnings, summed over all updates
+   */
+  unsigned airspace_warning_states;
+
+  /**
+   * The number of updates where the airspace warnings differed from
+   * #ReferenceAirspaceWarnings
+   */
+  unsigned airspace_warning_mismatches;
+
   TestFlightResult()
     :result(false),
      time_elapsed(0.0), time_planned(1.0), time_remaining(0.0),
-     calc_cruise_efficiency(1.0), calc_effective_mc(1.0) {}
+     calc_cruise_efficiency(1.0), calc_effective_mc(1.0),
+     airspace_warning_states(0), airspace_warning_mismatches(0) {}
 
   operator bool() {
     return result;
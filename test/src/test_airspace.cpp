@@ -29,9 +29,15 @@ test_airspace(const unsigned n_airspaces)
   TestFlightComponents components;
   components.airspaces = new Airspaces;
   setup_airspaces(*components.airspaces, GeoPoint(Angle::Degrees(0.5), Angle::Degrees(0.5)), n_airspaces);
-  bool fine = test_flight(components, 4, 0);
+  const TestFlightResult result = test_flight(components, 4, 0);
   delete components.airspaces;
-  return fine;
+
+  if (verbose || result.airspace_warning_mismatches > 0)
+    printf("# %u airspace warning updates differ, %u warnings compared\n",
+           result.airspace_warning_mismatches, result.airspace_warning_states);
+
+  return result.result && result.airspace_warning_states > 0 &&
+    result.airspace_warning_mismatches == 0;
 }
 
 int main(int argc, char** argv) 
@@ -43,10 +49,11 @@ int main(int argc, char** argv)
     return 0;
   }
 
-  plan_tests(3);
+  plan_tests(4);
 
   ok(test_airspace(20),"airspace 20",0);
   ok(test_airspace(100),"airspace 100",0);
+  ok(test_airspace(1000),"airspace 1000",0);
   
   Airspaces airspaces;
   setup_airspaces(airspaces, GeoPoint(Angle::Zero(), Angle::Zero()), 20);
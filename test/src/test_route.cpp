@@ -156,7 +156,7 @@ test_route(const unsigned n_airspaces, const RasterMap& map)
     for (int i = 0; i < NUM_SOL; i++) {
       loc_end.latitude += Angle::Degrees(0.1);
       loc_end.altitude = map.GetHeight(loc_end).GetValueOr0() + 100;
-      route.Synchronise(airspaces, predicate, loc_start, loc_end);
+      route.Synchronise(airspaces, predicate, 0, loc_start, loc_end);
       if (route.Solve(loc_start, loc_end, config)) {
         sol = true;
         if (verbose) {